@@ -11,6 +11,7 @@ public class Flow : ModuleRules
 		PublicDependencyModuleNames.AddRange(new[]
 		{
 			"LevelSequence",
+			"NetCore",
 			"StructUtils",
 		});
 
@@ -23,7 +24,6 @@ public class Flow : ModuleRules
 			"GameplayTags",
 			"MovieScene",
 			"MovieSceneTracks",
-			"NetCore",
 			"Slate",
 			"SlateCore"
 		});
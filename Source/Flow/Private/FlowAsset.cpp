@@ -4,7 +4,9 @@
 
 #include "FlowLogChannels.h"
 #include "FlowSettings.h"
+#include "FlowStats.h"
 #include "FlowSubsystem.h"
+#include "FlowTrace.h"
 
 #include "AddOns/FlowNodeAddOn.h"
 #include "Interfaces/FlowDataPinGeneratorNodeInterface.h"
@@ -14,13 +16,15 @@
 #include "Nodes/Graph/FlowNode_Start.h"
 #include "Nodes/Graph/FlowNode_SubGraph.h"
 
+#include "Algo/Reverse.h"
+#include "Algo/SortBy.h"
+#include "Engine/StreamableManager.h"
 #include "Engine/World.h"
-#include "Serialization/MemoryReader.h"
-#include "Serialization/MemoryWriter.h"
 
 #if WITH_EDITOR
 #include "Editor.h"
 #include "Editor/EditorEngine.h"
+#include "UObject/ObjectSaveContext.h"
 
 FString UFlowAsset::ValidationError_NodeClassNotAllowed = TEXT("Node class {0} is not allowed in this asset.");
 FString UFlowAsset::ValidationError_NullNodeInstance = TEXT("Node with GUID {0} is NULL");
@@ -31,6 +35,7 @@ FString UFlowAsset::ValidationError_NullNodeInstance = TEXT("Node with GUID {0}
 UFlowAsset::UFlowAsset(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, bWorldBound(true)
+	, bLazyNodeInstancing(false)
 #if WITH_EDITOR
 	, FlowGraph(nullptr)
 #endif
@@ -39,6 +44,11 @@ UFlowAsset::UFlowAsset(const FObjectInitializer& ObjectInitializer)
 	, bStartNodePlacedAsGhostNode(false)
 	, TemplateAsset(nullptr)
 	, FinishPolicy(EFlowFinishPolicy::Keep)
+	, InstancedNodesNum(0)
+	, DataPinSupplierGeneration(1)
+	, bDrainingSignals(false)
+	, SignalsInCurrentFrame(0)
+	, SignalBudgetFrame(0)
 {
 	if (!AssetGuid.IsValid())
 	{
@@ -103,6 +113,14 @@ void UFlowAsset::PostLoad()
 	}
 }
 
+void UFlowAsset::PreSave(FObjectPreSaveContext SaveContext)
+{
+	Super::PreSave(SaveContext);
+
+	// cooked builds use the compiled graph as it was saved
+	CompileGraph();
+}
+
 EDataValidationResult UFlowAsset::ValidateAsset(FFlowMessageLog& MessageLog)
 {
 	// validate nodes
@@ -331,6 +349,8 @@ void UFlowAsset::UnregisterNode(const FGuid& NodeGuid)
 
 void UFlowAsset::HarvestNodeConnections(UFlowNode* TargetNode)
 {
+	InvalidateDataPinSupplierCache();
+
 	TArray<UFlowNode*> TargetNodes;
 
 	if (IsValid(TargetNode))
@@ -429,6 +449,8 @@ void UFlowAsset::HarvestNodeConnections(UFlowNode* TargetNode)
 			FlowNode->PostEditChange();
 		}
 	}
+
+	CompileGraph();
 }
 
 bool UFlowAsset::TryUpdateManagedFlowPinsForNode(UFlowNode& FlowNode)
@@ -897,6 +919,124 @@ bool UFlowAsset::TryCreateFlowDataPinFromMetadataValue(
 
 #endif
 
+void UFlowAsset::CompileGraph()
+{
+	CompiledGraph = FFlowCompiledGraph();
+	CompiledGraph.NodeGuids.Reserve(Nodes.Num());
+	CompiledGraph.FirstOutputEdges.Reserve(Nodes.Num() + 1);
+
+	// nodes are indexed in execution order, SaveInstance writes active nodes in this order and LoadInstance restores them backward
+	// the default entry node goes first, then other entry points, then nodes not reachable from any of them
+	TArray<UFlowNode*> EntryNodes;
+	EntryNodes.Reserve(Nodes.Num() * 2 + 1);
+	EntryNodes.Add(GetDefaultEntryNode());
+
+	for (const TPair<FGuid, UFlowNode*>& Node : ObjectPtrDecay(Nodes))
+	{
+		if (Node.Value)
+		{
+			Node.Value->NodeIndex = INDEX_NONE;
+
+			if (Node.Value->IsA<UFlowNode_Start>() || Node.Value->IsA<UFlowNode_CustomInput>())
+			{
+				EntryNodes.Add(Node.Value);
+			}
+		}
+	}
+
+	// nodes already indexed are skipped below
+	for (const TPair<FGuid, UFlowNode*>& Node : ObjectPtrDecay(Nodes))
+	{
+		EntryNodes.Add(Node.Value);
+	}
+
+	// depth-first, the first output pin followed first, the same order as signals are executed
+	// iterative, as long chains would exceed the call stack
+	TArray<UFlowNode*> NodesToIndex;
+	for (UFlowNode* EntryNode : EntryNodes)
+	{
+		if (EntryNode == nullptr || EntryNode->NodeIndex != INDEX_NONE)
+		{
+			continue;
+		}
+
+		NodesToIndex.Add(EntryNode);
+		while (NodesToIndex.Num() > 0)
+		{
+			UFlowNode* Node = NodesToIndex.Pop(EAllowShrinking::No);
+			if (Node->NodeIndex != INDEX_NONE)
+			{
+				continue;
+			}
+
+			Node->NodeIndex = CompiledGraph.NodeGuids.Add(Node->GetGuid());
+
+			for (int32 PinIndex = Node->OutputPins.Num() - 1; PinIndex >= 0; PinIndex--)
+			{
+				const FConnectedPin* Connection = Node->Connections.Find(Node->OutputPins[PinIndex].PinName);
+				UFlowNode* ConnectedNode = Connection ? Nodes.FindRef(Connection->NodeGuid) : nullptr;
+				if (ConnectedNode && ConnectedNode->NodeIndex == INDEX_NONE)
+				{
+					NodesToIndex.Add(ConnectedNode);
+				}
+			}
+		}
+	}
+
+	for (const FGuid& NodeGuid : CompiledGraph.NodeGuids)
+	{
+		const UFlowNode* Node = Nodes.FindChecked(NodeGuid);
+		CompiledGraph.FirstOutputEdges.Add(CompiledGraph.OutputEdges.Num());
+
+		for (const FFlowPin& OutputPin : Node->OutputPins)
+		{
+			FFlowCompiledEdge& Edge = CompiledGraph.OutputEdges.AddDefaulted_GetRef();
+
+			const FConnectedPin* Connection = Node->Connections.Find(OutputPin.PinName);
+			const UFlowNode* ConnectedNode = Connection ? Nodes.FindRef(Connection->NodeGuid) : nullptr;
+			if (ConnectedNode)
+			{
+				Edge.PinIndex = ConnectedNode->InputPins.IndexOfByKey(Connection->PinName);
+				Edge.NodeIndex = Edge.PinIndex == INDEX_NONE ? INDEX_NONE : ConnectedNode->NodeIndex;
+			}
+		}
+	}
+
+	CompiledGraph.FirstOutputEdges.Add(CompiledGraph.OutputEdges.Num());
+}
+
+bool UFlowAsset::IsGraphCompiled() const
+{
+	// null entries, i.e. nodes of removed classes, aren't compiled
+	int32 NodesNum = 0;
+	for (const TPair<FGuid, UFlowNode*>& Node : ObjectPtrDecay(Nodes))
+	{
+		NodesNum += Node.Value ? 1 : 0;
+	}
+
+	if (CompiledGraph.NodeGuids.Num() != NodesNum || CompiledGraph.FirstOutputEdges.Num() != NodesNum + 1)
+	{
+		return false;
+	}
+
+	for (int32 NodeIndex = 0; NodeIndex < CompiledGraph.NodeGuids.Num(); NodeIndex++)
+	{
+		const UFlowNode* Node = Nodes.FindRef(CompiledGraph.NodeGuids[NodeIndex]);
+		if (Node == nullptr || Node->NodeIndex != NodeIndex)
+		{
+			return false;
+		}
+
+		// output pins added or removed after compiling, i.e. by reconstructing the node, would shift edge ranges of every following node
+		if (CompiledGraph.FirstOutputEdges[NodeIndex + 1] - CompiledGraph.FirstOutputEdges[NodeIndex] != Node->OutputPins.Num())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 UFlowNode* UFlowAsset::GetDefaultEntryNode() const
 {
 	UFlowNode* FirstStartNode = nullptr;
@@ -1122,47 +1262,380 @@ void UFlowAsset::BroadcastRuntimeMessageAdded(const TSharedRef<FTokenizedMessage
 
 void UFlowAsset::InitializeInstance(const TWeakObjectPtr<UObject> InOwner, UFlowAsset& InTemplateAsset)
 {
+	FLOW_SCOPE_CYCLE_COUNTER(InitializeInstance);
 	check(!IsInstanceInitialized());
+	INC_DWORD_STAT(STAT_FlowInstances);
 
 	Owner = InOwner;
 	TemplateAsset = &InTemplateAsset;
+	InstancedNodesNum = 0;
+
+	// pooled node objects might keep supplier chains cached during the previous use
+	InvalidateDataPinSupplierCache();
 
 	for (TPair<FGuid, TObjectPtr<UFlowNode>>& Node : Nodes)
 	{
-		UFlowNode* NewNodeInstance = NewObject<UFlowNode>(this, Node.Value->GetClass(), NAME_None, RF_Transient, Node.Value, false, nullptr);
-		Node.Value = NewNodeInstance;
+		if (IsNodeInstanced(Node.Value))
+		{
+			// node object reused by the instance pool, AddOns are instantiated again from the template
+			if (const UFlowNode* NodeTemplate = InTemplateAsset.GetNode(Node.Key))
+			{
+				Node.Value->AddOns = NodeTemplate->AddOns;
+				Node.Value->NodeIndex = NodeTemplate->NodeIndex;
+			}
+
+			InitializeNodeInstance(Node.Value);
+			continue;
+		}
 
-		if (UFlowNode_CustomInput* CustomInput = Cast<UFlowNode_CustomInput>(NewNodeInstance))
+		// Custom Inputs are entry points of the graph, they're always instanced to be found by the event name
+		if (bLazyNodeInstancing && !Node.Value->IsA<UFlowNode_CustomInput>())
 		{
-			if (!CustomInput->EventName.IsNone())
+			continue;
+		}
+
+		Node.Value = CreateNodeInstance(Node.Value);
+	}
+
+	// signals travel by node indices, resolve them to node objects of this instance
+	const TArray<FGuid>& CompiledNodeGuids = InTemplateAsset.CompiledGraph.NodeGuids;
+	NodesByIndex.Reset(CompiledNodeGuids.Num());
+	for (const FGuid& NodeGuid : CompiledNodeGuids)
+	{
+		NodesByIndex.Add(Nodes.FindRef(NodeGuid));
+	}
+
+	TRACE_FLOW_INSTANCE_CREATED(*this);
+}
+
+UFlowNode* UFlowAsset::CreateNodeInstance(UFlowNode* NodeTemplate)
+{
+	UFlowNode* NewNodeInstance = NewObject<UFlowNode>(this, NodeTemplate->GetClass(), NAME_None, RF_Transient, NodeTemplate, false, nullptr);
+	InitializeNodeInstance(NewNodeInstance);
+
+	return NewNodeInstance;
+}
+
+void UFlowAsset::InitializeNodeInstance(UFlowNode* NodeInstance)
+{
+	InstancedNodesNum++;
+
+	if (UFlowNode_CustomInput* CustomInput = Cast<UFlowNode_CustomInput>(NodeInstance))
+	{
+		if (!CustomInput->EventName.IsNone())
+		{
+			CustomInputNodes.Emplace(CustomInput);
+		}
+	}
+
+	NodeInstance->InitializeInstance();
+}
+
+void UFlowAsset::PreinstantiateNodes()
+{
+	check(!IsInstanceInitialized());
+
+	for (TPair<FGuid, TObjectPtr<UFlowNode>>& Node : Nodes)
+	{
+		if (!IsNodeInstanced(Node.Value) && (!bLazyNodeInstancing || Node.Value->IsA<UFlowNode_CustomInput>()))
+		{
+			Node.Value = NewObject<UFlowNode>(this, Node.Value->GetClass(), NAME_None, RF_Transient, Node.Value, false, nullptr);
+		}
+	}
+}
+
+bool UFlowAsset::CanResetInstanceForPool() const
+{
+	for (const TPair<FGuid, UFlowNode*>& Node : ObjectPtrDecay(Nodes))
+	{
+		if (IsNodeInstanced(Node.Value) && !Node.Value->GetClass()->IsNative())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void UFlowAsset::ResetInstanceForPool(const UFlowAsset& InTemplateAsset)
+{
+	check(!IsInstanceInitialized());
+	check(InTemplateAsset.GetClass() == GetClass());
+
+	ClearSignalQueue();
+	ResetNodes();
+
+	// next owner of this instance has to get nodes in the same state as newly created ones
+	for (const TPair<FGuid, UFlowNode*>& Node : ObjectPtrDecay(Nodes))
+	{
+		if (IsNodeInstanced(Node.Value))
+		{
+			if (const UFlowNode* NodeTemplate = InTemplateAsset.GetNode(Node.Key))
 			{
-				CustomInputNodes.Emplace(CustomInput);
+				Node.Value->ResetForPool(*NodeTemplate);
 			}
 		}
+	}
 
-		NewNodeInstance->InitializeInstance();
+	// restore asset properties possibly modified at runtime, properties declared by UFlowAsset itself are runtime state reset below
+	for (TFieldIterator<FProperty> PropertyIt(GetClass()); PropertyIt; ++PropertyIt)
+	{
+		if (PropertyIt->HasAnyPropertyFlags(CPF_InstancedReference | CPF_ContainsInstancedReference | CPF_DuplicateTransient))
+		{
+			continue;
+		}
+
+		if (PropertyIt->GetOwnerClass() == StaticClass() && !PropertyIt->HasAnyPropertyFlags(CPF_Edit))
+		{
+			continue;
+		}
+
+		PropertyIt->CopyCompleteValue_InContainer(this, &InTemplateAsset);
+	}
+
+	Owner.Reset();
+	NodeOwningThisAssetInstance.Reset();
+	ActiveSubGraphs.Empty();
+
+	DEC_DWORD_STAT_BY(STAT_FlowActiveNodes, ActiveNodes.Num());
+	ActiveNodes.Empty();
+	PreloadedNodes.Empty();
+
+	FinishPolicy = EFlowFinishPolicy::Keep;
+	InstancedNodesNum = 0;
+
+	MarkSaveDirty();
+	CachedAssetData.Empty();
+	CachedSaveGeneration = 0;
+}
+
+UFlowNode* UFlowAsset::GetOrCreateNodeInstance(const FGuid& NodeGuid)
+{
+	TObjectPtr<UFlowNode>* FoundNode = Nodes.Find(NodeGuid);
+	if (FoundNode == nullptr || *FoundNode == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (IsInstanceInitialized() && !IsNodeInstanced(*FoundNode))
+	{
+		*FoundNode = CreateNodeInstance(*FoundNode);
+
+		const int32 NodeIndex = (*FoundNode)->GetNodeIndex();
+		if (NodesByIndex.IsValidIndex(NodeIndex))
+		{
+			NodesByIndex[NodeIndex] = *FoundNode;
+		}
+	}
+
+	return *FoundNode;
+}
+
+UFlowNode* UFlowAsset::GetOrCreateNodeInstance(const int32 NodeIndex)
+{
+	if (!NodesByIndex.IsValidIndex(NodeIndex) || NodesByIndex[NodeIndex] == nullptr)
+	{
+		return nullptr;
+	}
+
+	TObjectPtr<UFlowNode>& Node = NodesByIndex[NodeIndex];
+	if (IsInstanceInitialized() && !IsNodeInstanced(Node))
+	{
+		Node = CreateNodeInstance(Node);
+		Nodes.FindChecked(Node->GetGuid()) = Node;
+	}
+
+	return Node;
+}
+
+UFlowNode* UFlowAsset::PreloadNode(const FGuid& NodeGuid)
+{
+	UFlowNode* Node = GetOrCreateNodeInstance(NodeGuid);
+	if (Node && !PreloadedNodes.Contains(Node))
+	{
+		Node->TriggerPreload();
+		PreloadedNodes.Emplace(Node);
 	}
+
+	return Node;
+}
+
+void UFlowAsset::SchedulePredictivePreload()
+{
+	if (UFlowSettings::Get()->PredictivePreloadDepth > 0 && !PredictivePreloadHandle.IsValid())
+	{
+		PredictivePreloadHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float DeltaTime)
+		{
+			PredictivePreloadHandle.Reset();
+			UpdatePredictivePreload();
+			return false;
+		}));
+	}
+}
+
+void UFlowAsset::UpdatePredictivePreload()
+{
+	const UFlowSettings* Settings = UFlowSettings::Get();
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	if (Settings->PredictivePreloadDepth <= 0 || FlowSubsystem == nullptr || !IsInstanceInitialized())
+	{
+		return;
+	}
+
+	const FFlowCompiledGraph& Graph = GetCompiledGraph();
+	if (Graph.FirstOutputEdges.Num() != NodesByIndex.Num() + 1)
+	{
+		return;
+	}
+
+	// breadth-first walk from active nodes, so the nearest nodes consume budgets first
+	TArray<int32, TInlineAllocator<64>> NodesInRange;
+	TBitArray<> VisitedNodes(false, NodesByIndex.Num());
+	for (const UFlowNode* ActiveNode : ActiveNodes)
+	{
+		const int32 NodeIndex = ActiveNode ? ActiveNode->GetNodeIndex() : INDEX_NONE;
+		if (VisitedNodes.IsValidIndex(NodeIndex) && !VisitedNodes[NodeIndex])
+		{
+			VisitedNodes[NodeIndex] = true;
+			NodesInRange.Add(NodeIndex);
+		}
+	}
+	const int32 ActiveNodesNum = NodesInRange.Num();
+
+	int32 LayerStart = 0;
+	for (int32 Depth = 0; Depth < Settings->PredictivePreloadDepth && LayerStart < NodesInRange.Num(); Depth++)
+	{
+		const int32 LayerEnd = NodesInRange.Num();
+		for (int32 LayerIndex = LayerStart; LayerIndex < LayerEnd; LayerIndex++)
+		{
+			const int32 NodeIndex = NodesInRange[LayerIndex];
+			for (int32 EdgeIndex = Graph.FirstOutputEdges[NodeIndex]; EdgeIndex < Graph.FirstOutputEdges[NodeIndex + 1]; EdgeIndex++)
+			{
+				const FFlowCompiledEdge& Edge = Graph.OutputEdges[EdgeIndex];
+				if (Edge.IsConnected() && !VisitedNodes[Edge.NodeIndex])
+				{
+					VisitedNodes[Edge.NodeIndex] = true;
+					NodesInRange.Add(Edge.NodeIndex);
+				}
+			}
+		}
+		LayerStart = LayerEnd;
+	}
+
+	// active nodes keep content requested before their activation, upcoming nodes are limited by budgets
+	TBitArray<> WantedNodes(false, NodesByIndex.Num());
+	TMap<const UClass*, int32> UsedBudgets;
+	for (int32 RangeIndex = 0; RangeIndex < NodesInRange.Num(); RangeIndex++)
+	{
+		const int32 NodeIndex = NodesInRange[RangeIndex];
+		const UFlowNode* Node = NodesByIndex[NodeIndex];
+		if (Node == nullptr)
+		{
+			continue;
+		}
+
+		if (RangeIndex >= ActiveNodesNum)
+		{
+			const UClass* BudgetClass = nullptr;
+			const int32 Budget = Settings->GetPredictivePreloadBudget(Node->GetClass(), BudgetClass);
+			if (BudgetClass)
+			{
+				int32& UsedBudget = UsedBudgets.FindOrAdd(BudgetClass);
+				if (UsedBudget >= Budget)
+				{
+					continue;
+				}
+				UsedBudget++;
+			}
+		}
+
+		WantedNodes[NodeIndex] = true;
+	}
+
+	// release content of nodes which fell out of range
+	for (TMap<int32, TSharedPtr<FStreamableHandle>>::TIterator It = PredictivePreloads.CreateIterator(); It; ++It)
+	{
+		if (!WantedNodes.IsValidIndex(It.Key()) || !WantedNodes[It.Key()])
+		{
+			if (It.Value().IsValid())
+			{
+				It.Value()->CancelHandle();
+			}
+			It.RemoveCurrent();
+		}
+	}
+
+	for (int32 RangeIndex = ActiveNodesNum; RangeIndex < NodesInRange.Num(); RangeIndex++)
+	{
+		const int32 NodeIndex = NodesInRange[RangeIndex];
+		if (WantedNodes[NodeIndex] && !PredictivePreloads.Contains(NodeIndex))
+		{
+			// template node is enough to read soft references, node doesn't have to be instanced yet
+			TArray<FSoftObjectPath> Content;
+			NodesByIndex[NodeIndex]->GatherPreloadableContent(Content);
+
+			TSharedPtr<FStreamableHandle> Handle;
+			if (Content.Num() > 0)
+			{
+				Handle = FlowSubsystem->GetStreamableManager().RequestAsyncLoad(MoveTemp(Content), FStreamableDelegate(), Settings->PredictivePreloadPriority);
+			}
+			PredictivePreloads.Add(NodeIndex, Handle);
+		}
+	}
+}
+
+void UFlowAsset::ClearPredictivePreloads()
+{
+	if (PredictivePreloadHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(PredictivePreloadHandle);
+		PredictivePreloadHandle.Reset();
+	}
+
+	for (TPair<int32, TSharedPtr<FStreamableHandle>>& PredictivePreload : PredictivePreloads)
+	{
+		if (PredictivePreload.Value.IsValid())
+		{
+			PredictivePreload.Value->CancelHandle();
+		}
+	}
+	PredictivePreloads.Empty();
 }
 
 void UFlowAsset::DeinitializeInstance()
 {
 	if (IsInstanceInitialized())
 	{
+		DEC_DWORD_STAT(STAT_FlowInstances);
+		TRACE_FLOW_INSTANCE_DESTROYED(*this);
+		ClearSignalQueue();
+		ClearPredictivePreloads();
+		NodesByIndex.Empty();
+
 		for (const TPair<FGuid, UFlowNode*>& Node : ObjectPtrDecay(Nodes))
 		{
-			if (IsValid(Node.Value))
+			// with lazy instancing, some entries still point to template nodes
+			if (IsValid(Node.Value) && IsNodeInstanced(Node.Value))
 			{
 				Node.Value->DeinitializeInstance();
 			}
 		}
 
+		UE_LOG(LogFlow, Verbose, TEXT("Flow Asset %s instanced %d of %d nodes"), *GetName(), InstancedNodesNum, Nodes.Num());
+
 		const int32 ActiveInstancesLeft = TemplateAsset->RemoveInstance(this);
 		if (ActiveInstancesLeft == 0 && GetFlowSubsystem())
 		{
 			GetFlowSubsystem()->RemoveInstancedTemplate(TemplateAsset);
 		}
 
+		UFlowAsset* DeinitializedTemplate = TemplateAsset;
 		TemplateAsset = nullptr;
+
+		if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+		{
+			FlowSubsystem->ReturnInstanceToPool(this, DeinitializedTemplate);
+		}
 	}
 }
 
@@ -1190,13 +1663,18 @@ void UFlowAsset::StartFlow(IFlowDataPinValueSupplierInterface* DataPinValueSuppl
 {
 	PreStartFlow();
 
-	if (UFlowNode* ConnectedEntryNode = GetDefaultEntryNode())
+	const UFlowNode* DefaultEntryNode = GetDefaultEntryNode();
+	if (UFlowNode* ConnectedEntryNode = DefaultEntryNode ? GetOrCreateNodeInstance(DefaultEntryNode->GetGuid()) : nullptr)
 	{
 		RecordedNodes.Add(ConnectedEntryNode);
 
 		if (IFlowNodeWithExternalDataPinSupplierInterface* ExternalPinSuppliedNode = Cast<IFlowNodeWithExternalDataPinSupplierInterface>(ConnectedEntryNode))
 		{
-			ExternalPinSuppliedNode->SetDataPinValueSupplier(DataPinValueSupplier);
+			if (ExternalPinSuppliedNode->GetExternalDataPinSupplier() != DataPinValueSupplier)
+			{
+				ExternalPinSuppliedNode->SetDataPinValueSupplier(DataPinValueSupplier);
+				InvalidateDataPinSupplierCache();
+			}
 		}
 
 		ConnectedEntryNode->TriggerFirstOutput(true);
@@ -1207,12 +1685,18 @@ void UFlowAsset::FinishFlow(const EFlowFinishPolicy InFinishPolicy, const bool b
 {
 	FinishPolicy = InFinishPolicy;
 
+	// signals left in the queue shouldn't reach nodes of the finished graph
+	ClearSignalQueue();
+	ClearPredictivePreloads();
+
 	// end execution of this asset and all of its nodes
 	for (UFlowNode* Node : ActiveNodes)
 	{
 		Node->Deactivate();
 	}
+	DEC_DWORD_STAT_BY(STAT_FlowActiveNodes, ActiveNodes.Num());
 	ActiveNodes.Empty();
+	MarkSaveDirty();
 
 	// flush preloaded content
 	for (UFlowNode* PreloadedNode : PreloadedNodes)
@@ -1276,7 +1760,11 @@ void UFlowAsset::TriggerCustomInput(const FName& EventName, IFlowDataPinValueSup
 
 			if (IFlowNodeWithExternalDataPinSupplierInterface* ExternalPinSuppliedNode = Cast<IFlowNodeWithExternalDataPinSupplierInterface>(CustomInputNode))
 			{
-				ExternalPinSuppliedNode->SetDataPinValueSupplier(DataPinValueSupplier);
+				if (ExternalPinSuppliedNode->GetExternalDataPinSupplier() != DataPinValueSupplier)
+				{
+					ExternalPinSuppliedNode->SetDataPinValueSupplier(DataPinValueSupplier);
+					InvalidateDataPinSupplierCache();
+				}
 			}
 
 			CustomInputNode->ExecuteInput(EventName);
@@ -1303,15 +1791,142 @@ void UFlowAsset::TriggerCustomOutput(const FName& EventName)
 
 void UFlowAsset::TriggerInput(const FGuid& NodeGuid, const FName& PinName)
 {
-	if (UFlowNode* Node = Nodes.FindRef(NodeGuid))
+	UFlowNode* Node = GetOrCreateNodeInstance(NodeGuid);
+	if (Node == nullptr)
+	{
+		return;
+	}
+
+	const int32 PinIndex = Node->InputPins.IndexOfByKey(PinName);
+	if (PinIndex == INDEX_NONE)
+	{
+		UE_LOG(LogFlow, Error, TEXT("Input Pin name %s invalid --- node %s, asset %s"), *PinName.ToString(), *Node->GetName(), *GetName());
+		return;
+	}
+
+	// node added after compiling the graph has no index, so it can't be queued and it's executed immediately
+	if (Node->GetNodeIndex() == INDEX_NONE)
+	{
+		ExecuteInput(Node, PinIndex);
+		return;
+	}
+
+	TriggerInput(Node->GetNodeIndex(), PinIndex);
+}
+
+void UFlowAsset::TriggerInput(const int32 NodeIndex, const int32 PinIndex)
+{
+	if (UFlowSettings::Get()->bUseSignalQueue)
+	{
+		// signal triggered while draining will be picked up by the loop, after the currently executed node returns
+		if (bDrainingSignals)
+		{
+			PendingSignals.Emplace(NodeIndex, PinIndex);
+			return;
+		}
+
+		// external trigger waits for signals deferred by the frame budget, instead of jumping ahead of them
+		PendingSignals.EmplaceAt(0, NodeIndex, PinIndex);
+		DrainSignalQueue();
+		return;
+	}
+
+	ExecuteInput(NodeIndex, PinIndex);
+}
+
+void UFlowAsset::ExecuteInput(const int32 NodeIndex, const int32 PinIndex)
+{
+	if (UFlowNode* Node = GetOrCreateNodeInstance(NodeIndex))
 	{
-		if (!ActiveNodes.Contains(Node))
+		ExecuteInput(Node, PinIndex);
+	}
+}
+
+void UFlowAsset::ExecuteInput(UFlowNode* Node, const int32 PinIndex)
+{
+	FLOW_SCOPE_CYCLE_COUNTER(ExecuteInput);
+
+	if (!ActiveNodes.Contains(Node))
+	{
+		INC_DWORD_STAT(STAT_FlowActiveNodes);
+		ActiveNodes.Add(Node);
+		RecordedNodes.Add(Node);
+		MarkSaveDirty();
+		SchedulePredictivePreload();
+	}
+
+	Node->TriggerInputByIndex(PinIndex);
+}
+
+void UFlowAsset::DrainSignalQueue()
+{
+	const UFlowSettings* Settings = UFlowSettings::Get();
+	TGuardValue<bool> DrainingGuard(bDrainingSignals, true);
+
+	// counted per single drain, so workloads spread across frames by the budget aren't mistaken for a loop
+	int32 SignalsInThisDrain = 0;
+
+	while (PendingSignals.Num() > 0)
+	{
+		if (SignalBudgetFrame != GFrameCounter)
 		{
-			ActiveNodes.Add(Node);
-			RecordedNodes.Add(Node);
+			SignalBudgetFrame = GFrameCounter;
+			SignalsInCurrentFrame = 0;
 		}
 
-		Node->TriggerInput(PinName);
+		if (Settings->MaxSignalsPerFrame > 0 && SignalsInCurrentFrame >= Settings->MaxSignalsPerFrame)
+		{
+			ScheduleDeferredDrain();
+			return;
+		}
+
+		if (SignalsInThisDrain >= Settings->MaxSignalsBeforeLoopGuard)
+		{
+			UE_LOG(LogFlow, Error, TEXT("Flow Asset %s executed %d signals in a single drain of the signal queue, graph probably contains an infinite loop. Discarding %d pending signals."),
+				*GetName(), SignalsInThisDrain, PendingSignals.Num());
+
+			ClearSignalQueue();
+			return;
+		}
+
+		const FFlowPendingSignal Signal = PendingSignals.Pop(EAllowShrinking::No);
+		const int32 QueueSizeBeforeExecution = PendingSignals.Num();
+
+		SignalsInCurrentFrame++;
+		SignalsInThisDrain++;
+
+		ExecuteInput(Signal.NodeIndex, Signal.PinIndex);
+
+		// node pushed its output signals in order of triggering, reverse them so the first triggered output is executed first
+		const int32 NewSignalsNum = PendingSignals.Num() - QueueSizeBeforeExecution;
+		if (NewSignalsNum > 1)
+		{
+			Algo::Reverse(PendingSignals.GetData() + QueueSizeBeforeExecution, NewSignalsNum);
+		}
+	}
+}
+
+void UFlowAsset::ScheduleDeferredDrain()
+{
+	if (!DeferredDrainHandle.IsValid())
+	{
+		DeferredDrainHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float DeltaTime)
+		{
+			DeferredDrainHandle.Reset();
+			DrainSignalQueue();
+			return false;
+		}));
+	}
+}
+
+void UFlowAsset::ClearSignalQueue()
+{
+	PendingSignals.Empty();
+
+	if (DeferredDrainHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(DeferredDrainHandle);
+		DeferredDrainHandle.Reset();
 	}
 }
 
@@ -1319,7 +1934,10 @@ void UFlowAsset::FinishNode(UFlowNode* Node)
 {
 	if (ActiveNodes.Contains(Node))
 	{
+		DEC_DWORD_STAT(STAT_FlowActiveNodes);
 		ActiveNodes.Remove(Node);
+		MarkSaveDirty();
+		SchedulePredictivePreload();
 
 		// if graph reached Finish and this asset instance was created by SubGraph node
 		if (Node->CanFinishGraph())
@@ -1380,17 +1998,30 @@ UFlowAsset* UFlowAsset::GetParentInstance() const
 
 FFlowAssetSaveData UFlowAsset::SaveInstance(TArray<FFlowAssetSaveData>& SavedFlowInstances)
 {
+	FLOW_SCOPE_CYCLE_COUNTER(SaveInstance);
+
 	FFlowAssetSaveData AssetRecord;
 	AssetRecord.WorldName = IsBoundToWorld() ? GetWorld()->GetName() : FString();
 	AssetRecord.InstanceName = GetName();
 
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	const bool bIncrementalSaving = UFlowSettings::Get()->bIncrementalSaving;
+	const uint32 SaveTableSerial = FlowSubsystem ? FlowSubsystem->GetSaveTableSerialForSaving() : 0;
+	const bool bReuseAssetData = bIncrementalSaving && CachedSaveGeneration == SaveGeneration && CachedSaveTableSerial == SaveTableSerial && CanReuseSaveRecord();
+
 	// opportunity to collect data before serializing asset
-	OnSave();
+	if (!bReuseAssetData)
+	{
+		OnSave();
+	}
 
-	// iterate nodes
-	TArray<UFlowNode*> NodesInExecutionOrder;
-	GetNodesInExecutionOrder<UFlowNode>(GetDefaultEntryNode(), NodesInExecutionOrder);
-	for (UFlowNode* Node : NodesInExecutionOrder)
+	// iterate active nodes in execution order of the graph, so LoadInstance can restore them backward
+	// there's no need to traverse the whole graph, compiled node indices follow the execution order
+	// copy the list, as saving node might finish it
+	const int32 FirstSubFlowRecord = SavedFlowInstances.Num();
+	TArray<UFlowNode*, TInlineAllocator<32>> NodesToSave(ActiveNodes);
+	Algo::SortBy(NodesToSave, [](const UFlowNode* Node) { return Node ? Node->GetNodeIndex() : INDEX_NONE; });
+	for (UFlowNode* Node : NodesToSave)
 	{
 		if (Node && Node->ActivationState == EFlowNodeState::Active)
 		{
@@ -1401,7 +2032,11 @@ FFlowAssetSaveData UFlowAsset::SaveInstance(TArray<FFlowAssetSaveData>& SavedFlo
 				if (SubFlowInstance.IsValid())
 				{
 					const FFlowAssetSaveData SubAssetRecord = SubFlowInstance->SaveInstance(SavedFlowInstances);
-					SubGraphNode->SavedAssetInstanceName = SubAssetRecord.InstanceName;
+					if (SubGraphNode->SavedAssetInstanceName != SubAssetRecord.InstanceName)
+					{
+						SubGraphNode->SavedAssetInstanceName = SubAssetRecord.InstanceName;
+						SubGraphNode->MarkSaveDirty();
+					}
 				}
 			}
 
@@ -1412,36 +2047,99 @@ FFlowAssetSaveData UFlowAsset::SaveInstance(TArray<FFlowAssetSaveData>& SavedFlo
 		}
 	}
 
-	// serialize asset
-	FMemoryWriter MemoryWriter(AssetRecord.AssetData, true);
-	FFlowArchive Ar(MemoryWriter);
-	Serialize(Ar);
+	// serialize asset, unless its state didn't change since the last save
+	if (bReuseAssetData)
+	{
+		AssetRecord.AssetData = CachedAssetData;
+		if (FlowSubsystem)
+		{
+			FlowSubsystem->LastSaveStats.ReusedRecords++;
+		}
+	}
+	else
+	{
+		FFlowSaveSerializer::SaveObject(*this, AssetRecord.AssetData, FlowSubsystem ? FlowSubsystem->GetSaveTableForSaving() : nullptr);
+		if (FlowSubsystem)
+		{
+			FlowSubsystem->LastSaveStats.SerializedRecords++;
+		}
+
+		if (bIncrementalSaving)
+		{
+			CachedAssetData = AssetRecord.AssetData;
+			CachedSaveGeneration = SaveGeneration;
+			CachedSaveTableSerial = SaveTableSerial;
+		}
+	}
 
-	// write archive to SaveGame
+	// write archive to SaveGame, sub-flow records precede it, so the whole block can be found from this record
+	AssetRecord.SubFlowRecordsNum = SavedFlowInstances.Num() - FirstSubFlowRecord;
 	SavedFlowInstances.Emplace(AssetRecord);
 
 	return AssetRecord;
 }
 
+void UFlowAsset::CompletePendingSubFlowRestores()
+{
+	// copy the list, as restored sub-flows might change it
+	const TArray<UFlowNode*, TInlineAllocator<32>> NodesToCheck(ActiveNodes);
+	for (UFlowNode* Node : NodesToCheck)
+	{
+		if (UFlowNode_SubGraph* SubGraphNode = Cast<UFlowNode_SubGraph>(Node))
+		{
+			if (SubGraphNode->bRestoreOnAssetLoaded)
+			{
+				SubGraphNode->CompleteAssetLoad();
+			}
+
+			const TWeakObjectPtr<UFlowAsset> SubFlowInstance = GetFlowInstance(SubGraphNode);
+			if (SubFlowInstance.IsValid())
+			{
+				SubFlowInstance->CompletePendingSubFlowRestores();
+			}
+		}
+	}
+}
+
 void UFlowAsset::LoadInstance(const FFlowAssetSaveData& AssetRecord)
 {
-	FMemoryReader MemoryReader(AssetRecord.AssetData, true);
-	FFlowArchive Ar(MemoryReader);
-	Serialize(Ar);
+	FLOW_SCOPE_CYCLE_COUNTER(LoadInstance);
+
+	const UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	FFlowSaveSerializer::LoadObject(*this, AssetRecord.AssetData, FlowSubsystem ? FlowSubsystem->GetSaveTableForLoading() : nullptr);
 
 	PreStartFlow();
 
 	// iterate graph "from the end", backward to execution order
 	// prevents issue when the preceding node would instantly fire output to a not-yet-loaded node
+	const int32 FirstLoadedActiveNode = ActiveNodes.Num();
 	for (int32 i = AssetRecord.NodeRecords.Num() - 1; i >= 0; i--)
 	{
-		if (UFlowNode* Node = Nodes.FindRef(AssetRecord.NodeRecords[i].NodeGuid))
+		if (UFlowNode* Node = GetOrCreateNodeInstance(AssetRecord.NodeRecords[i].NodeGuid))
 		{
 			Node->LoadInstance(AssetRecord.NodeRecords[i]);
 		}
 	}
 
+	// loaded nodes were appended backward, reversing them once restores the saved execution order
+	if (ActiveNodes.Num() > FirstLoadedActiveNode)
+	{
+		Algo::Reverse(ActiveNodes.GetData() + FirstLoadedActiveNode, ActiveNodes.Num() - FirstLoadedActiveNode);
+	}
+
 	OnLoad();
+	MarkSaveDirty();
+}
+
+void UFlowAsset::MarkSaveDirty()
+{
+	SaveGeneration++;
+}
+
+bool UFlowAsset::CanReuseSaveRecord() const
+{
+	return !GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UFlowAsset, OnSave))
+		&& !FFlowSaveSerializer::DeclaresSaveGameProperties(GetClass(), UFlowAsset::StaticClass());
 }
 
 void UFlowAsset::OnActivationStateLoaded(UFlowNode* Node)
@@ -1453,7 +2151,10 @@ void UFlowAsset::OnActivationStateLoaded(UFlowNode* Node)
 
 	if (Node->ActivationState == EFlowNodeState::Active)
 	{
-		ActiveNodes.Emplace(Node);
+		// LoadInstance reverses loaded nodes once all records are loaded
+		INC_DWORD_STAT(STAT_FlowActiveNodes);
+		ActiveNodes.Add(Node);
+		SchedulePredictivePreload();
 	}
 }
 
@@ -9,21 +9,28 @@
 
 #include "Engine/Engine.h"
 #include "Engine/GameInstance.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/PackageMapClient.h"
 #include "Engine/ViewportStatsSubsystem.h"
 #include "Engine/World.h"
 #include "Net/UnrealNetwork.h"
 #include "Net/Core/PushModel/PushModel.h"
-#include "Serialization/MemoryReader.h"
-#include "Serialization/MemoryWriter.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowComponent)
 
 UFlowComponent::UFlowComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, PendingSoftRootFlowAction(EFlowSoftRootFlowAction::None)
+	, bSoftRootFlowReported(false)
+	, bSoftRootFlowWaited(false)
+	, bRootFlowStartQueued(false)
 	, RootFlow(nullptr)
 	, bAutoStartRootFlow(true)
+	, RootFlowStartPriority(EFlowStartPriority::Normal)
 	, RootFlowMode(EFlowNetMode::Authority)
 	, bAllowMultipleInstances(true)
+	, bRootFlowStartPending(false)
 {
 	PrimaryComponentTick.bCanEverTick = false;
 	PrimaryComponentTick.bStartWithTickEnabled = false;
@@ -31,6 +38,14 @@ UFlowComponent::UFlowComponent(const FObjectInitializer& ObjectInitializer)
 	SetIsReplicatedByDefault(true);
 }
 
+void UFlowComponent::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// set after copying properties from the archetype, as the stream struct is copied as a whole
+	NotifyStream.OwnerComponent = this;
+}
+
 void UFlowComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
@@ -42,16 +57,19 @@ void UFlowComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLi
 	DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, AddedIdentityTags, Params);
 	DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, RemovedIdentityTags, Params);
 
+	DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, NotifyStream, Params);
+
+	Params.Condition = COND_InitialOnly;
 	DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, RecentlySentNotifyTags, Params);
-	DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, NotifyTagsFromGraph, Params);
-	DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, NotifyTagsFromAnotherComponent, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, InitialNotifySequence, Params);
 #else
 	DOREPLIFETIME(ThisClass, AddedIdentityTags);
 	DOREPLIFETIME(ThisClass, RemovedIdentityTags);
 
-	DOREPLIFETIME(ThisClass, RecentlySentNotifyTags);
-	DOREPLIFETIME(ThisClass, NotifyTagsFromGraph);
-	DOREPLIFETIME(ThisClass, NotifyTagsFromAnotherComponent);
+	DOREPLIFETIME(ThisClass, NotifyStream);
+
+	DOREPLIFETIME_CONDITION(ThisClass, RecentlySentNotifyTags, COND_InitialOnly);
+	DOREPLIFETIME_CONDITION(ThisClass, InitialNotifySequence, COND_InitialOnly);
 #endif
 }
 
@@ -80,15 +98,51 @@ void UFlowComponent::RegisterWithFlowSubsystem()
 
 void UFlowComponent::BeginRootFlow(bool bComponentLoadedFromSaveGame)
 {
+	// Root Flow start was queued or waited for the asset while saving, so there's no instance to restore
+	const bool bRestartPendingStart = bComponentLoadedFromSaveGame && bRootFlowStartPending && SavedAssetInstanceName.IsEmpty();
+	bRootFlowStartPending = false;
+
+	if (RootFlow == nullptr && !SoftRootFlow.IsNull())
+	{
+		// Root Flow doesn't run in this net mode, so its asset isn't needed
+		if (!IsFlowNetMode(RootFlowMode))
+		{
+			return;
+		}
+
+		if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+		{
+			FlowSubsystem->AddSoftRootFlowComponent(this);
+		}
+
+		if (bRestartPendingStart)
+		{
+			RequestSoftRootFlow(EFlowSoftRootFlowAction::AutoStart);
+		}
+		else if (bComponentLoadedFromSaveGame)
+		{
+			RequestSoftRootFlow(EFlowSoftRootFlowAction::Load);
+		}
+		else if (bAutoStartRootFlow)
+		{
+			RequestSoftRootFlow(EFlowSoftRootFlowAction::AutoStart);
+		}
+		return;
+	}
+
 	if (RootFlow)
 	{
-		if (bComponentLoadedFromSaveGame)
+		if (bRestartPendingStart)
+		{
+			AutoStartRootFlow();
+		}
+		else if (bComponentLoadedFromSaveGame)
 		{
 			LoadRootFlow();
 		}
 		else if (bAutoStartRootFlow)
 		{
-			StartRootFlow();
+			AutoStartRootFlow();
 		}
 	}
 }
@@ -102,13 +156,109 @@ void UFlowComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 
 void UFlowComponent::UnregisterWithFlowSubsystem()
 {
+	CancelSoftRootFlow();
+	bRootFlowStartQueued = false;
+
 	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
 	{
+		FlowSubsystem->RemoveSoftRootFlowComponent(this);
 		FlowSubsystem->FinishAllRootFlows(this, EFlowFinishPolicy::Keep);
 		FlowSubsystem->UnregisterComponent(this);
 	}
 }
 
+void UFlowComponent::RequestSoftRootFlow(const EFlowSoftRootFlowAction Action)
+{
+	// loading from SaveGame takes precedence over starting a new instance
+	if (PendingSoftRootFlowAction == EFlowSoftRootFlowAction::Load)
+	{
+		return;
+	}
+
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	if (FlowSubsystem == nullptr)
+	{
+		return;
+	}
+
+	const bool bAlreadyRequested = PendingSoftRootFlowAction != EFlowSoftRootFlowAction::None;
+	PendingSoftRootFlowAction = Action;
+
+	if (!bAlreadyRequested)
+	{
+		FlowSubsystem->RequestRootFlowLoad(this, SoftRootFlow);
+	}
+}
+
+void UFlowComponent::CancelSoftRootFlow()
+{
+	if (PendingSoftRootFlowAction != EFlowSoftRootFlowAction::None)
+	{
+		PendingSoftRootFlowAction = EFlowSoftRootFlowAction::None;
+
+		if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+		{
+			FlowSubsystem->CancelRootFlowLoad(this, SoftRootFlow);
+		}
+	}
+}
+
+void UFlowComponent::OnSoftRootFlowLoaded(UFlowAsset* LoadedAsset)
+{
+	const EFlowSoftRootFlowAction Action = PendingSoftRootFlowAction;
+	PendingSoftRootFlowAction = EFlowSoftRootFlowAction::None;
+
+	if (LoadedAsset == nullptr || Action == EFlowSoftRootFlowAction::None)
+	{
+		return;
+	}
+
+	// Root Flow might have been assigned directly while the asset was loading
+	if (RootFlow == nullptr)
+	{
+		RootFlow = LoadedAsset;
+	}
+
+	switch (Action)
+	{
+		case EFlowSoftRootFlowAction::AutoStart:
+			AutoStartRootFlow();
+			break;
+		case EFlowSoftRootFlowAction::Start:
+			StartRootFlow();
+			break;
+		case EFlowSoftRootFlowAction::Load:
+			LoadRootFlow();
+			break;
+		default: ;
+	}
+}
+
+void UFlowComponent::CompleteSoftRootFlowLoad()
+{
+	if (PendingSoftRootFlowAction == EFlowSoftRootFlowAction::Load)
+	{
+		// leave the shared request, other components keep waiting for it
+		CancelSoftRootFlow();
+
+		PendingSoftRootFlowAction = EFlowSoftRootFlowAction::Load;
+		OnSoftRootFlowLoaded(SoftRootFlow.LoadSynchronous());
+	}
+}
+
+void UFlowComponent::AutoStartRootFlow()
+{
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	if (FlowSubsystem && UFlowSettings::Get()->bQueueRootFlowStarts)
+	{
+		FlowSubsystem->QueueRootFlowStart(this);
+	}
+	else
+	{
+		StartRootFlow();
+	}
+}
+
 void UFlowComponent::AddIdentityTag(const FGameplayTag Tag, const EFlowNetMode NetMode /* = EFlowNetMode::Authority*/)
 {
 	if (IsFlowNetMode(NetMode) && Tag.IsValid() && !IdentityTags.HasTagExact(Tag))
@@ -295,16 +445,14 @@ void UFlowComponent::NotifyGraph(const FGameplayTag NotifyTag, const EFlowNetMod
 	if (IsFlowNetMode(NetMode) && NotifyTag.IsValid() && HasBegunPlay())
 	{
 		// save recently notify, this allows for the retroactive check in nodes
-		// if retroactive check wouldn't be performed, this is only used by the network replication
 		RecentlySentNotifyTags = FGameplayTagContainer(NotifyTag);
-#if WITH_PUSH_MODEL
-		if (IsNetMode(NM_DedicatedServer) || IsNetMode(NM_ListenServer))
+
+		if (ShouldReplicateNotifies())
 		{
-			MARK_PROPERTY_DIRTY_FROM_NAME(UFlowComponent, RecentlySentNotifyTags, this);
+			ReplicateNotify(EFlowNotifyStreamType::SentNotifyTags, FGameplayTag::EmptyTag, RecentlySentNotifyTags);
 		}
-#endif
 
-		OnRep_SentNotifyTags();
+		BroadcastSentNotifyTags();
 	}
 }
 
@@ -324,21 +472,19 @@ void UFlowComponent::BulkNotifyGraph(const FGameplayTagContainer NotifyTags, con
 		if (ValidatedTags.Num() > 0)
 		{
 			// save recently notify, this allows for the retroactive check in nodes
-			// if retroactive check wouldn't be performed, this is only used by the network replication
 			RecentlySentNotifyTags = ValidatedTags;
-#if WITH_PUSH_MODEL
-			if (IsNetMode(NM_DedicatedServer) || IsNetMode(NM_ListenServer))
+
+			if (ShouldReplicateNotifies())
 			{
-				MARK_PROPERTY_DIRTY_FROM_NAME(UFlowComponent, RecentlySentNotifyTags, this);
+				ReplicateNotify(EFlowNotifyStreamType::SentNotifyTags, FGameplayTag::EmptyTag, RecentlySentNotifyTags);
 			}
-#endif
 
-			OnRep_SentNotifyTags();
+			BroadcastSentNotifyTags();
 		}
 	}
 }
 
-void UFlowComponent::OnRep_SentNotifyTags()
+void UFlowComponent::BroadcastSentNotifyTags()
 {
 	for (const FGameplayTag& NotifyTag : RecentlySentNotifyTags)
 	{
@@ -366,64 +512,250 @@ void UFlowComponent::NotifyFromGraph(const FGameplayTagContainer& NotifyTags, co
 				ReceiveNotify.Broadcast(nullptr, ValidatedTag);
 			}
 
-			if (IsNetMode(NM_DedicatedServer) || IsNetMode(NM_ListenServer))
+			if (ShouldReplicateNotifies())
 			{
-				NotifyTagsFromGraph = ValidatedTags;
-#if WITH_PUSH_MODEL
-				MARK_PROPERTY_DIRTY_FROM_NAME(UFlowComponent, NotifyTagsFromGraph, this);
-#endif
+				ReplicateNotify(EFlowNotifyStreamType::NotifyFromGraph, FGameplayTag::EmptyTag, ValidatedTags);
 			}
 		}
 	}
 }
 
-void UFlowComponent::OnRep_NotifyTagsFromGraph()
+void UFlowComponent::NotifyActor(const FGameplayTag ActorTag, const FGameplayTag NotifyTag, const EFlowNetMode NetMode /* = EFlowNetMode::Authority*/)
 {
-	for (const FGameplayTag& NotifyTag : NotifyTagsFromGraph)
+	if (IsFlowNetMode(NetMode) && NotifyTag.IsValid() && HasBegunPlay())
 	{
-		ReceiveNotify.Broadcast(nullptr, NotifyTag);
+		const FGameplayTagContainer NotifyTags(NotifyTag);
+		BroadcastNotifyToActor(ActorTag, NotifyTags);
+
+		if (ShouldReplicateNotifies())
+		{
+			ReplicateNotify(EFlowNotifyStreamType::NotifyFromAnotherComponent, ActorTag, NotifyTags);
+		}
 	}
 }
 
-void UFlowComponent::NotifyActor(const FGameplayTag ActorTag, const FGameplayTag NotifyTag, const EFlowNetMode NetMode /* = EFlowNetMode::Authority*/)
+void UFlowComponent::BroadcastNotifyToActor(const FGameplayTag& ActorTag, const FGameplayTagContainer& NotifyTags)
 {
-	if (IsFlowNetMode(NetMode) && NotifyTag.IsValid() && HasBegunPlay())
+	if (const UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
 	{
-		if (const UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+		// receivers might register or unregister components, so we can't broadcast while iterating the registry
+		TArray<UFlowComponent*, TInlineAllocator<16>> Components;
+		FlowSubsystem->FindComponents(ActorTag, true, Components);
+
+		for (UFlowComponent* Component : Components)
 		{
-			for (const TWeakObjectPtr<UFlowComponent>& Component : FlowSubsystem->GetComponents<UFlowComponent>(ActorTag))
+			if (IsValid(Component))
 			{
-				Component->ReceiveNotify.Broadcast(this, NotifyTag);
+				for (const FGameplayTag& NotifyTag : NotifyTags)
+				{
+					Component->ReceiveNotify.Broadcast(this, NotifyTag);
+				}
 			}
 		}
+	}
+}
 
-		if (IsNetMode(NM_DedicatedServer) || IsNetMode(NM_ListenServer))
-		{
-			NotifyTagsFromAnotherComponent.Empty();
-			NotifyTagsFromAnotherComponent.Add(FNotifyTagReplication(ActorTag, NotifyTag));
+bool UFlowComponent::ShouldReplicateNotifies() const
+{
+	return IsNetMode(NM_DedicatedServer) || IsNetMode(NM_ListenServer);
+}
+
+void UFlowComponent::ReplicateNotify(const EFlowNotifyStreamType Type, const FGameplayTag& ActorTag, const FGameplayTagContainer& NotifyTags)
+{
+	NotifyStream.PruneDeliveredNotifies();
+	NotifyStream.AddNotify(Type, ActorTag, NotifyTags);
+	InitialNotifySequence = NotifyStream.NextSequence - 1;
 #if WITH_PUSH_MODEL
-			MARK_PROPERTY_DIRTY_FROM_NAME(UFlowComponent, NotifyTagsFromAnotherComponent, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(UFlowComponent, NotifyStream, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(UFlowComponent, InitialNotifySequence, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(UFlowComponent, RecentlySentNotifyTags, this);
 #endif
+}
+
+void UFlowComponent::OnNotifyReplicated(const FFlowNotifyStreamItem& Notify)
+{
+	switch (Notify.Type)
+	{
+		case EFlowNotifyStreamType::SentNotifyTags:
+			RecentlySentNotifyTags = Notify.NotifyTags;
+			BroadcastSentNotifyTags();
+			break;
+		case EFlowNotifyStreamType::NotifyFromGraph:
+			for (const FGameplayTag& NotifyTag : Notify.NotifyTags)
+			{
+				ReceiveNotify.Broadcast(nullptr, NotifyTag);
+			}
+			break;
+		case EFlowNotifyStreamType::NotifyFromAnotherComponent:
+			BroadcastNotifyToActor(Notify.ActorTag, Notify.NotifyTags);
+			break;
+		default: ;
+	}
+}
+
+void FFlowNotifyStream::AddNotify(const EFlowNotifyStreamType Type, const FGameplayTag& ActorTag, const FGameplayTagContainer& NotifyTags)
+{
+	FFlowNotifyStreamItem& Item = Items.AddDefaulted_GetRef();
+	Item.Sequence = NextSequence++;
+	Item.Type = Type;
+	Item.ActorTag = ActorTag;
+	Item.NotifyTags = NotifyTags;
+
+	MarkItemDirty(Item);
+}
+
+void FFlowNotifyStream::PruneDeliveredNotifies()
+{
+	AActor* Owner = OwnerComponent ? OwnerComponent->GetOwner() : nullptr;
+	const UNetDriver* NetDriver = Owner ? Owner->GetNetDriver() : nullptr;
+	if (NetDriver == nullptr)
+	{
+		return;
+	}
+
+	// connections that stopped replicating the owner will receive the current stream as history, if the owner becomes relevant again
+	ConnectionAcks.RemoveAllSwap([Owner](const FConnectionAck& Ack)
+	{
+		UNetConnection* Connection = Ack.Connection.Get();
+		return Connection == nullptr || Connection->GetConnectionState() == USOCK_Closed || Connection->FindActorChannelRef(Owner) == nullptr;
+	});
+
+	// connection without acknowledgement keeps the entire stream
+	uint32 DeliveredSequence = NextSequence - 1;
+	for (UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (Connection && Connection->FindActorChannelRef(Owner))
+		{
+			const FConnectionAck* Ack = ConnectionAcks.FindByPredicate([Connection](const FConnectionAck& Entry)
+			{
+				return Entry.Connection == Connection;
+			});
+			DeliveredSequence = FMath::Min(DeliveredSequence, Ack ? Ack->AckedSequence : 0);
 		}
 	}
+
+	// items are ordered by sequence
+	int32 PrunedNum = 0;
+	while (PrunedNum < Items.Num() && Items[PrunedNum].Sequence <= DeliveredSequence)
+	{
+		PrunedNum++;
+	}
+
+	const int32 MaxNotifies = UFlowSettings::Get()->MaxReplicatedNotifies;
+	if (Items.Num() - PrunedNum >= MaxNotifies)
+	{
+		const int32 DroppedNum = Items.Num() - PrunedNum - MaxNotifies + 1;
+		UE_LOG(LogFlow, Warning, TEXT("%s: dropping %d replicated notifies not acknowledged by all clients"), *OwnerComponent->GetPathName(), DroppedNum);
+		PrunedNum += DroppedNum;
+	}
+
+	if (PrunedNum > 0)
+	{
+		Items.RemoveAt(0, PrunedNum, EAllowShrinking::No);
+		MarkArrayDirty();
+	}
 }
 
-void UFlowComponent::OnRep_NotifyTagsFromAnotherComponent()
+bool FFlowNotifyStream::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
 {
-	if (const UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+	if (DeltaParms.Writer)
 	{
-		for (const FNotifyTagReplication& Notify : NotifyTagsFromAnotherComponent)
+		UpdateConnectionAck(DeltaParms);
+	}
+
+	return FFastArraySerializer::FastArrayDeltaSerialize<FFlowNotifyStreamItem, FFlowNotifyStream>(Items, DeltaParms, *this);
+}
+
+void FFlowNotifyStream::UpdateConnectionAck(const FNetDeltaSerializeInfo& DeltaParms)
+{
+	UPackageMapClient* PackageMap = Cast<UPackageMapClient>(DeltaParms.Map);
+	UNetConnection* Connection = PackageMap ? PackageMap->GetConnection() : nullptr;
+	if (Connection == nullptr)
+	{
+		return;
+	}
+
+	FConnectionAck* Ack = ConnectionAcks.FindByPredicate([Connection](const FConnectionAck& Entry)
+	{
+		return Entry.Connection == Connection;
+	});
+	if (Ack == nullptr)
+	{
+		Ack = &ConnectionAcks.AddDefaulted_GetRef();
+		Ack->Connection = Connection;
+	}
+
+	// the delta base is the state sent to this connection, a lost packet reverts it to the state before sending
+	uint32 BaseSequence = 0;
+	if (const FNetFastTArrayBaseState* BaseState = static_cast<const FNetFastTArrayBaseState*>(DeltaParms.OldState))
+	{
+		for (int32 Index = Items.Num() - 1; Index >= 0; --Index)
 		{
-			for (const TWeakObjectPtr<UFlowComponent>& Component : FlowSubsystem->GetComponents<UFlowComponent>(Notify.ActorTag))
+			if (BaseState->IDToCGMap.Contains(Items[Index].ReplicationID))
 			{
-				Component->ReceiveNotify.Broadcast(this, Notify.NotifyTag);
+				BaseSequence = Items[Index].Sequence;
+				break;
 			}
 		}
 	}
+
+	// sequence still in the base after its packets were acknowledged or lost, has been delivered
+	if (Ack->SentPacketId != INDEX_NONE && Connection->OutAckPacketId >= Ack->SentPacketId)
+	{
+		if (BaseSequence >= Ack->SentSequence)
+		{
+			Ack->AckedSequence = FMath::Max(Ack->AckedSequence, Ack->SentSequence);
+		}
+		Ack->SentPacketId = INDEX_NONE;
+	}
+
+	// base is sent in earlier packets, as the stream is serialized once per net update
+	if (Ack->SentPacketId == INDEX_NONE && BaseSequence > Ack->AckedSequence)
+	{
+		Ack->SentSequence = BaseSequence;
+		Ack->SentPacketId = Connection->OutPacketId;
+	}
+}
+
+void FFlowNotifyStream::PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize)
+{
+	if (OwnerComponent == nullptr)
+	{
+		return;
+	}
+
+	// notifies sent before the component started replicating are history, they aren't dispatched
+	LastDispatchedSequence = FMath::Max(LastDispatchedSequence, OwnerComponent->InitialNotifySequence);
+
+	// notifies received in the same update are dispatched in the order of sending
+	TArray<int32, TInlineAllocator<16>> SortedIndices(AddedIndices.GetData(), AddedIndices.Num());
+	SortedIndices.Sort([this](const int32 A, const int32 B)
+	{
+		return Items[A].Sequence < Items[B].Sequence;
+	});
+
+	for (const int32 Index : SortedIndices)
+	{
+		const FFlowNotifyStreamItem& Item = Items[Index];
+		if (Item.Sequence > LastDispatchedSequence)
+		{
+			LastDispatchedSequence = Item.Sequence;
+			OwnerComponent->OnNotifyReplicated(Item);
+		}
+	}
 }
 
 void UFlowComponent::StartRootFlow()
 {
+	// explicit start supersedes the queued one, the subsystem skips entries no longer flagged as queued
+	bRootFlowStartQueued = false;
+
+	if (RootFlow == nullptr && !SoftRootFlow.IsNull() && IsFlowNetMode(RootFlowMode))
+	{
+		RequestSoftRootFlow(EFlowSoftRootFlowAction::Start);
+		return;
+	}
+
 	if (RootFlow && IsFlowNetMode(RootFlowMode))
 	{
 		if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
@@ -437,6 +769,9 @@ void UFlowComponent::StartRootFlow()
 
 void UFlowComponent::FinishRootFlow(UFlowAsset* TemplateAsset, const EFlowFinishPolicy FinishPolicy)
 {
+	// don't start the queued Root Flow after it has been finished
+	bRootFlowStartQueued = false;
+
 	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
 	{
 		FlowSubsystem->FinishRootFlow(this, TemplateAsset, FinishPolicy);
@@ -519,6 +854,9 @@ void UFlowComponent::SaveRootFlow(TArray<FFlowAssetSaveData>& SavedFlowInstances
 
 void UFlowComponent::LoadRootFlow()
 {
+	// instance restored from SaveGame replaces the queued start
+	bRootFlowStartQueued = false;
+
 	if (RootFlow && !SavedAssetInstanceName.IsEmpty() && GetFlowSubsystem())
 	{
 		VerifyIdentityTags();
@@ -534,34 +872,27 @@ FFlowComponentSaveData UFlowComponent::SaveInstance()
 	ComponentRecord.WorldName = GetWorld()->GetName();
 	ComponentRecord.ActorInstanceName = GetOwner()->GetName();
 
+	// queued start isn't instanced yet, it's queued again after loading
+	bRootFlowStartPending = bRootFlowStartQueued || PendingSoftRootFlowAction == EFlowSoftRootFlowAction::AutoStart || PendingSoftRootFlowAction == EFlowSoftRootFlowAction::Start;
+
 	// opportunity to collect data before serializing component
 	OnSave();
 
 	// serialize component
-	FMemoryWriter MemoryWriter(ComponentRecord.ComponentData, true);
-	FFlowArchive Ar(MemoryWriter);
-	Serialize(Ar);
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	FFlowSaveSerializer::SaveObject(*this, ComponentRecord.ComponentData, FlowSubsystem ? FlowSubsystem->GetSaveTableForSaving() : nullptr);
 
 	return ComponentRecord;
 }
 
 bool UFlowComponent::LoadInstance()
 {
-	const UFlowSaveGame* SaveGame = GetFlowSubsystem()->GetLoadedSaveGame();
-	if (SaveGame->FlowComponents.Num() > 0)
+	if (const FFlowComponentSaveData* ComponentRecord = GetFlowSubsystem()->FindLoadedComponentRecord(GetOwner()->GetName()))
 	{
-		for (const FFlowComponentSaveData& ComponentRecord : SaveGame->FlowComponents)
-		{
-			if (ComponentRecord.WorldName == GetWorld()->GetName() && ComponentRecord.ActorInstanceName == GetOwner()->GetName())
-			{
-				FMemoryReader MemoryReader(ComponentRecord.ComponentData, true);
-				FFlowArchive Ar(MemoryReader);
-				Serialize(Ar);
+		FFlowSaveSerializer::LoadObject(*this, ComponentRecord->ComponentData, GetFlowSubsystem()->GetSaveTableForLoading());
 
-				OnLoad();
-				return true;
-			}
-		}
+		OnLoad();
+		return true;
 	}
 
 	return false;
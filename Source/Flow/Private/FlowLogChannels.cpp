@@ -1,3 +1,5 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
 #include "FlowLogChannels.h"
 
 DEFINE_LOG_CATEGORY(LogFlow);
@@ -1,15 +1,59 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "FlowModule.h"
+#include "FlowAsset.h"
+#include "FlowTrace.h"
+#include "Nodes/FlowNode.h"
 
 #include "Modules/ModuleManager.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UObjectIterator.h"
 
 void FFlowModule::StartupModule()
 {
+#if FLOW_TRACE_ENABLED
+	FFlowTrace::Initialize();
+#endif
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectsReplaced.AddRaw(this, &FFlowModule::OnObjectsReplaced);
+	FCoreUObjectDelegates::ReloadCompleteDelegate.AddRaw(this, &FFlowModule::OnReloadComplete);
+#endif
 }
 
 void FFlowModule::ShutdownModule()
 {
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectsReplaced.RemoveAll(this);
+	FCoreUObjectDelegates::ReloadCompleteDelegate.RemoveAll(this);
+#endif
+
+#if FLOW_TRACE_ENABLED
+	FFlowTrace::Shutdown();
+#endif
+}
+
+#if WITH_EDITOR
+void FFlowModule::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap)
+{
+	ClearClassCaches();
+}
+
+void FFlowModule::OnReloadComplete(EReloadCompleteReason Reason)
+{
+	ClearClassCaches();
+}
+
+void FFlowModule::ClearClassCaches()
+{
+	UFlowNode::ClearBoundPropertyCache();
+
+	// replaced node objects might be referenced by cached supplier chains
+	for (TObjectIterator<UFlowAsset> It; It; ++It)
+	{
+		It->InvalidateDataPinSupplierCache();
+	}
 }
+#endif
 
 IMPLEMENT_MODULE(FFlowModule, Flow)
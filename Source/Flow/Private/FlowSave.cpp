@@ -0,0 +1,383 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowSave.h"
+#include "FlowLogChannels.h"
+
+#include "Misc/Compression.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/SoftObjectPtr.h"
+#include "UObject/WeakObjectPtr.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FlowSave)
+
+//////////////////////////////////////////////////////////////////////////
+// Save Table
+
+uint32 FFlowSaveTable::NextSerialNumber = 0;
+
+int32 FFlowSaveTable::AddName(const FName& Name)
+{
+	if (NameLookup.Num() != Names.Num())
+	{
+		BuildLookups();
+	}
+
+	if (const int32* Index = NameLookup.Find(Name))
+	{
+		return *Index;
+	}
+
+	const int32 NewIndex = Names.Add(Name);
+	NameLookup.Add(Name, NewIndex);
+	return NewIndex;
+}
+
+int32 FFlowSaveTable::AddObjectPath(const FSoftObjectPath& ObjectPath)
+{
+	if (ObjectPathLookup.Num() != ObjectPaths.Num())
+	{
+		BuildLookups();
+	}
+
+	if (const int32* Index = ObjectPathLookup.Find(ObjectPath))
+	{
+		return *Index;
+	}
+
+	const int32 NewIndex = ObjectPaths.Add(ObjectPath);
+	ObjectPathLookup.Add(ObjectPath, NewIndex);
+	return NewIndex;
+}
+
+void FFlowSaveTable::Reset()
+{
+	Names.Reset();
+	ObjectPaths.Reset();
+	NameLookup.Reset();
+	ObjectPathLookup.Reset();
+
+	// records cached with the previous entries can't be reused
+	SerialNumber = ++NextSerialNumber;
+}
+
+void FFlowSaveTable::BuildLookups()
+{
+	// lookups aren't serialized, rebuild them after loading the table
+	NameLookup.Reset();
+	for (int32 Index = 0; Index < Names.Num(); ++Index)
+	{
+		NameLookup.Add(Names[Index], Index);
+	}
+
+	ObjectPathLookup.Reset();
+	for (int32 Index = 0; Index < ObjectPaths.Num(); ++Index)
+	{
+		ObjectPathLookup.Add(ObjectPaths[Index], Index);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Compact Archive
+
+FFlowCompactArchive::FFlowCompactArchive(FArchive& InInnerArchive, FFlowSaveTable& InSaveTable)
+	: FArchiveProxy(InInnerArchive)
+	, SaveTable(InSaveTable)
+{
+	ArIsSaveGame = true;
+}
+
+void FFlowCompactArchive::SerializeIndex(int32& Index)
+{
+	// index is stored with offset, so INDEX_NONE is written as zero
+	uint32 PackedIndex = IsSaving() ? static_cast<uint32>(Index + 1) : 0;
+	SerializeIntPacked(PackedIndex);
+
+	if (IsLoading())
+	{
+		Index = static_cast<int32>(PackedIndex) - 1;
+	}
+}
+
+FArchive& FFlowCompactArchive::operator<<(FName& Value)
+{
+	int32 Index = IsSaving() ? SaveTable.AddName(Value) : INDEX_NONE;
+	SerializeIndex(Index);
+
+	if (IsLoading())
+	{
+		Value = SaveTable.Names.IsValidIndex(Index) ? SaveTable.Names[Index] : NAME_None;
+	}
+
+	return *this;
+}
+
+FArchive& FFlowCompactArchive::operator<<(UObject*& Value)
+{
+	FSoftObjectPath ObjectPath = IsSaving() ? FSoftObjectPath(Value) : FSoftObjectPath();
+	*this << ObjectPath;
+
+	if (IsLoading())
+	{
+		// matches FObjectAndNameAsStringProxyArchive with bLoadIfFindFails enabled
+		Value = ObjectPath.IsNull() ? nullptr : ObjectPath.TryLoad();
+	}
+
+	return *this;
+}
+
+FArchive& FFlowCompactArchive::operator<<(FObjectPtr& Value)
+{
+	UObject* Object = IsSaving() ? Value.Get() : nullptr;
+	*this << Object;
+
+	if (IsLoading())
+	{
+		Value = Object;
+	}
+
+	return *this;
+}
+
+FArchive& FFlowCompactArchive::operator<<(FWeakObjectPtr& Value)
+{
+	UObject* Object = IsSaving() ? Value.Get() : nullptr;
+	*this << Object;
+
+	if (IsLoading())
+	{
+		Value = Object;
+	}
+
+	return *this;
+}
+
+FArchive& FFlowCompactArchive::operator<<(FSoftObjectPtr& Value)
+{
+	FSoftObjectPath ObjectPath = IsSaving() ? Value.GetUniqueID() : FSoftObjectPath();
+	*this << ObjectPath;
+
+	if (IsLoading())
+	{
+		Value = ObjectPath;
+	}
+
+	return *this;
+}
+
+FArchive& FFlowCompactArchive::operator<<(FSoftObjectPath& Value)
+{
+	int32 Index = INDEX_NONE;
+	if (IsSaving() && !Value.IsNull())
+	{
+		Index = SaveTable.AddObjectPath(Value);
+	}
+
+	SerializeIndex(Index);
+
+	if (IsLoading())
+	{
+		Value = SaveTable.ObjectPaths.IsValidIndex(Index) ? SaveTable.ObjectPaths[Index] : FSoftObjectPath();
+	}
+
+	return *this;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Save Serializer
+
+void FFlowSaveSerializer::SaveObject(UObject& Object, TArray<uint8>& OutData, FFlowSaveTable* SaveTable)
+{
+	FMemoryWriter MemoryWriter(OutData, true);
+
+	if (SaveTable)
+	{
+		uint32 Magic = FFlowSaveVersion::Magic;
+		uint32 Version = FFlowSaveVersion::LatestVersion;
+		MemoryWriter << Magic;
+		MemoryWriter.SerializeIntPacked(Version);
+
+		FFlowCompactArchive Ar(MemoryWriter, *SaveTable);
+		Object.Serialize(Ar);
+	}
+	else
+	{
+		FFlowArchive Ar(MemoryWriter);
+		Object.Serialize(Ar);
+	}
+}
+
+void FFlowSaveSerializer::LoadObject(UObject& Object, const TArray<uint8>& Data, FFlowSaveTable* SaveTable)
+{
+	FMemoryReader MemoryReader(Data, true);
+
+	if (IsCompactRecord(Data))
+	{
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		MemoryReader << Magic;
+		MemoryReader.SerializeIntPacked(Version);
+
+		if (SaveTable == nullptr || Version > FFlowSaveVersion::LatestVersion)
+		{
+			UE_LOG(LogFlow, Error, TEXT("Can't load %s, SaveGame record version %u isn't supported or save table is missing"), *Object.GetName(), Version);
+			return;
+		}
+
+		FFlowCompactArchive Ar(MemoryReader, *SaveTable);
+		Object.Serialize(Ar);
+	}
+	else
+	{
+		FFlowArchive Ar(MemoryReader);
+		Object.Serialize(Ar);
+	}
+}
+
+bool FFlowSaveSerializer::IsCompactRecord(const TArray<uint8>& Data)
+{
+	uint32 Magic = 0;
+	if (Data.Num() >= sizeof(Magic))
+	{
+		FMemory::Memcpy(&Magic, Data.GetData(), sizeof(Magic));
+	}
+
+	return Magic == FFlowSaveVersion::Magic;
+}
+
+bool FFlowSaveSerializer::DeclaresSaveGameProperties(const UClass* Class, const UClass* AuditedClass)
+{
+	// properties of derived classes are iterated first
+	for (TFieldIterator<FProperty> PropertyIt(Class, EFieldIteratorFlags::IncludeSuper); PropertyIt; ++PropertyIt)
+	{
+		const UClass* OwnerClass = PropertyIt->GetOwnerClass();
+		if (OwnerClass == AuditedClass || !OwnerClass->IsChildOf(AuditedClass))
+		{
+			break;
+		}
+
+		if (PropertyIt->HasAnyPropertyFlags(CPF_SaveGame))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FFlowSaveSerializer::CompressSaveData(const TArray<uint8>& Data, TArray<uint8>& OutCompressedData)
+{
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Oodle, Data.Num());
+	OutCompressedData.SetNumUninitialized(sizeof(uint32) + sizeof(int32) + CompressedSize);
+
+	if (!FCompression::CompressMemory(NAME_Oodle, OutCompressedData.GetData() + sizeof(uint32) + sizeof(int32), CompressedSize, Data.GetData(), Data.Num()))
+	{
+		OutCompressedData.Reset();
+		return false;
+	}
+
+	const uint32 Magic = FFlowSaveVersion::CompressedMagic;
+	const int32 UncompressedSize = Data.Num();
+	FMemory::Memcpy(OutCompressedData.GetData(), &Magic, sizeof(uint32));
+	FMemory::Memcpy(OutCompressedData.GetData() + sizeof(uint32), &UncompressedSize, sizeof(int32));
+
+	OutCompressedData.SetNum(sizeof(uint32) + sizeof(int32) + CompressedSize, EAllowShrinking::No);
+	return true;
+}
+
+bool FFlowSaveSerializer::DecompressSaveData(const TArray<uint8>& Data, TArray<uint8>& OutData)
+{
+	if (!IsCompressedSaveData(Data))
+	{
+		// uncompressed save is used as it is
+		OutData = Data;
+		return true;
+	}
+
+	int32 UncompressedSize = 0;
+	FMemory::Memcpy(&UncompressedSize, Data.GetData() + sizeof(uint32), sizeof(int32));
+
+	if (UncompressedSize < 0)
+	{
+		return false;
+	}
+
+	const int32 HeaderSize = sizeof(uint32) + sizeof(int32);
+	OutData.SetNumUninitialized(UncompressedSize);
+	if (!FCompression::UncompressMemory(NAME_Oodle, OutData.GetData(), UncompressedSize, Data.GetData() + HeaderSize, Data.Num() - HeaderSize))
+	{
+		OutData.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+bool FFlowSaveSerializer::IsCompressedSaveData(const TArray<uint8>& Data)
+{
+	uint32 Magic = 0;
+	if (Data.Num() >= sizeof(uint32) + sizeof(int32))
+	{
+		FMemory::Memcpy(&Magic, Data.GetData(), sizeof(Magic));
+	}
+
+	return Magic == FFlowSaveVersion::CompressedMagic;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SaveGame
+
+void UFlowSaveGame::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	// compressed save written by UFlowSubsystem::SaveGameAsync, decompressed here so UGameplayStatics::LoadGameFromSlot can read it
+	if (Ar.IsLoading() && bHasCompressedData)
+	{
+		bHasCompressedData = false;
+
+		TArray<uint8> CompressedData;
+		Ar << CompressedData;
+
+		TArray<uint8> Data;
+		if (Ar.IsError() || !FFlowSaveSerializer::DecompressSaveData(CompressedData, Data))
+		{
+			UE_LOG(LogFlow, Error, TEXT("Failed to decompress SaveGame %s"), *GetName());
+			Ar.SetError();
+			return;
+		}
+
+		FMemoryReader MemoryReader(Data, true);
+		FObjectAndNameAsStringProxyArchive DataAr(MemoryReader, true);
+		Super::Serialize(DataAr);
+	}
+}
+
+bool UFlowSaveGame::HasCompactRecords() const
+{
+	for (const FFlowComponentSaveData& ComponentRecord : FlowComponents)
+	{
+		if (FFlowSaveSerializer::IsCompactRecord(ComponentRecord.ComponentData))
+		{
+			return true;
+		}
+	}
+
+	for (const FFlowAssetSaveData& AssetRecord : FlowInstances)
+	{
+		if (FFlowSaveSerializer::IsCompactRecord(AssetRecord.AssetData))
+		{
+			return true;
+		}
+
+		for (const FFlowNodeSaveData& NodeRecord : AssetRecord.NodeRecords)
+		{
+			if (FFlowSaveSerializer::IsCompactRecord(NodeRecord.NodeData))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
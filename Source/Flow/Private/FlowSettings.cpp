@@ -8,10 +8,27 @@
 UFlowSettings::UFlowSettings(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, bCreateFlowSubsystemOnClients(true)
+	, MaxReplicatedNotifies(256)
 	, bWarnAboutMissingIdentityTags(true)
+	, bUseCompactSaveArchive(false)
+	, bIncrementalSaving(false)
+	, bCompressSaveGames(false)
 	, bLogOnSignalDisabled(true)
 	, bLogOnSignalPassthrough(true)
+	, bUseSignalQueue(false)
+	, MaxSignalsPerFrame(0)
+	, MaxSignalsBeforeLoopGuard(100000)
+	, MaxPooledInstancesPerTemplate(0)
+	, bAsyncLoadSubGraphs(false)
+	, SubGraphLoadPriority(0)
+	, SubGraphLoadTimeout(0.0f)
+	, PredictivePreloadDepth(0)
+	, PredictivePreloadPriority(0)
+	, bQueueRootFlowStarts(false)
+	, MaxRootFlowStartsPerFrame(0)
+	, RootFlowStartBudgetMs(2.0f)
 	, bUseAdaptiveNodeTitles(false)
+	, PinActivationHistorySize(64)
 	, DefaultExpectedOwnerClass(UFlowComponent::StaticClass())
 {
 }
@@ -28,6 +45,24 @@ void UFlowSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChange
 }
 #endif
 
+int32 UFlowSettings::GetPredictivePreloadBudget(const UClass* NodeClass, const UClass*& OutBudgetClass) const
+{
+	int32 Budget = INDEX_NONE;
+	OutBudgetClass = nullptr;
+
+	for (const TPair<TSoftClassPtr<UFlowNode>, int32>& BudgetEntry : PredictivePreloadBudgets)
+	{
+		const UClass* BudgetClass = BudgetEntry.Key.Get();
+		if (BudgetClass && NodeClass->IsChildOf(BudgetClass) && (OutBudgetClass == nullptr || BudgetClass->IsChildOf(OutBudgetClass)))
+		{
+			OutBudgetClass = BudgetClass;
+			Budget = BudgetEntry.Value;
+		}
+	}
+
+	return Budget;
+}
+
 UClass* UFlowSettings::GetDefaultExpectedOwnerClass() const
 {
 	return CastChecked<UClass>(TryResolveOrLoadSoftClass(DefaultExpectedOwnerClass), ECastCheckedType::NullAllowed);
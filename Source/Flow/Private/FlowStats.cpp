@@ -0,0 +1,26 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowStats.h"
+
+DEFINE_STAT(STAT_FlowInstances);
+DEFINE_STAT(STAT_FlowActiveNodes);
+DEFINE_STAT(STAT_FlowActiveTimers);
+
+DEFINE_STAT(STAT_FlowPinActivations);
+DEFINE_STAT(STAT_FlowDataPinResolves);
+DEFINE_STAT(STAT_FlowSubFlowCreations);
+DEFINE_STAT(STAT_FlowQueuedRootFlowStarts);
+
+DEFINE_STAT(STAT_FlowTriggerInput);
+DEFINE_STAT(STAT_FlowExecuteInput);
+DEFINE_STAT(STAT_FlowCreateFlowInstance);
+DEFINE_STAT(STAT_FlowInitializeInstance);
+DEFINE_STAT(STAT_FlowSaveInstance);
+DEFINE_STAT(STAT_FlowLoadInstance);
+DEFINE_STAT(STAT_FlowSaveGame);
+DEFINE_STAT(STAT_FlowLoadGame);
+DEFINE_STAT(STAT_FlowTickTimers);
+DEFINE_STAT(STAT_FlowStartQueuedRootFlows);
+
+CSV_DEFINE_CATEGORY_MODULE(FLOW_API, Flow, true);
+CSV_DEFINE_CATEGORY_MODULE(FLOW_API, FlowInstances, true);
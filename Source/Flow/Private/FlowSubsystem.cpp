@@ -7,12 +7,18 @@
 #include "FlowLogChannels.h"
 #include "FlowSave.h"
 #include "FlowSettings.h"
+#include "FlowStats.h"
 #include "Nodes/Graph/FlowNode_SubGraph.h"
 
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/Async.h"
 #include "Engine/GameInstance.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
 #include "Logging/MessageLog.h"
 #include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
 #include "UObject/UObjectHash.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowSubsystem)
@@ -24,8 +30,25 @@ FNativeFlowAssetEvent UFlowSubsystem::OnInstancedTemplateRemoved;
 
 #define LOCTEXT_NAMESPACE "FlowSubsystem"
 
+static FAutoConsoleCommandWithWorld RootFlowLoadReportCommand(
+	TEXT("Flow.RootFlowLoadReport"),
+	TEXT("Logs soft Root Flow assets used by Flow Components, and how many of them are still not loaded"),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+	{
+		if (const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr)
+		{
+			if (const UFlowSubsystem* FlowSubsystem = GameInstance->GetSubsystem<UFlowSubsystem>())
+			{
+				FlowSubsystem->LogRootFlowLoadReport();
+			}
+		}
+	}));
+
 UFlowSubsystem::UFlowSubsystem()
-	: LoadedSaveGame(nullptr)
+	: bAbortingActiveFlows(false)
+	, TimerWheelWorldTime(0.0)
+	, LoadedSaveGame(nullptr)
+	, SaveGameWriteSerial(0)
 {
 }
 
@@ -50,15 +73,62 @@ bool UFlowSubsystem::ShouldCreateSubsystem(UObject* Outer) const
 
 void UFlowSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
+	if (UFlowSettings::Get()->MaxPooledInstancesPerTemplate > 0 && UFlowSettings::Get()->PooledInstancesToWarmUp.Num() > 0)
+	{
+		FWorldDelegates::OnWorldInitializedActors.AddUObject(this, &UFlowSubsystem::OnWorldInitializedActors);
+	}
+
+	TimerWheelTickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UFlowSubsystem::TickTimerWheel));
+
+#if CSV_PROFILER
+	CsvProfileEndFrameHandle = FCsvProfiler::Get()->OnCSVProfileEndFrame().AddUObject(this, &UFlowSubsystem::RecordCsvInstanceStats);
+#endif
 }
 
 void UFlowSubsystem::Deinitialize()
 {
+	// pending requests capture Flow Graphs, so they have to be written before aborting flows
+	FlushSaveGameWrites();
+
+	FWorldDelegates::OnWorldInitializedActors.RemoveAll(this);
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TimerWheelTickHandle);
+	TimerWheelTickHandle.Reset();
+
+#if CSV_PROFILER
+	FCsvProfiler::Get()->OnCSVProfileEndFrame().Remove(CsvProfileEndFrameHandle);
+	CsvProfileEndFrameHandle.Reset();
+#endif
+
+	for (TPair<FSoftObjectPath, FRootFlowLoad>& Load : RootFlowLoads)
+	{
+		if (Load.Value.Handle.IsValid())
+		{
+			Load.Value.Handle->CancelHandle();
+		}
+	}
+	RootFlowLoads.Empty();
+	RootFlowLoadStats.Empty();
+
+	FTSTicker::GetCoreTicker().RemoveTicker(RootFlowStartTickHandle);
+	RootFlowStartTickHandle.Reset();
+	for (TArray<TWeakObjectPtr<UFlowComponent>>& Queue : QueuedRootFlowStarts)
+	{
+		Queue.Empty();
+	}
+
 	AbortActiveFlows();
+	EmptyInstancePools();
+
+	ComponentObservers.Empty();
+	ComponentObserversByTag.Empty();
+	TimerWheel.Reset();
 }
 
 void UFlowSubsystem::AbortActiveFlows()
 {
+	TGuardValue<bool> AbortingGuard(bAbortingActiveFlows, true);
+
 	if (InstancedTemplates.Num() > 0)
 	{
 		for (int32 i = InstancedTemplates.Num() - 1; i >= 0; i--)
@@ -74,6 +144,7 @@ void UFlowSubsystem::AbortActiveFlows()
 	InstancedSubFlows.Empty();
 
 	RootInstances.Empty();
+	RootInstancesByOwner.Empty();
 }
 
 void UFlowSubsystem::StartRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances /* = true */)
@@ -98,9 +169,9 @@ void UFlowSubsystem::StartRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const
 
 UFlowAsset* UFlowSubsystem::CreateRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const bool bAllowMultipleInstances, const FString& NewInstanceName)
 {
-	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : ObjectPtrDecay(RootInstances))
+	for (TMultiMap<TWeakObjectPtr<const UObject>, UFlowAsset*>::TConstKeyIterator It(RootInstancesByOwner, Owner); It; ++It)
 	{
-		if (Owner == RootInstance.Value.Get() && FlowAsset == RootInstance.Key->GetTemplateAsset())
+		if (FlowAsset == It.Value()->GetTemplateAsset())
 		{
 			UE_LOG(LogFlow, Warning, TEXT("Attempted to start Root Flow for the same Owner again. Owner: %s. Flow Asset: %s."), *Owner->GetName(), *FlowAsset->GetName());
 			return nullptr;
@@ -116,7 +187,7 @@ UFlowAsset* UFlowSubsystem::CreateRootFlow(UObject* Owner, UFlowAsset* FlowAsset
 	UFlowAsset* NewFlow = CreateFlowInstance(Owner, FlowAsset, NewInstanceName);
 	if (NewFlow)
 	{
-		RootInstances.Add(NewFlow, Owner);
+		AddRootInstance(Owner, NewFlow);
 	}
 
 	return NewFlow;
@@ -124,43 +195,182 @@ UFlowAsset* UFlowSubsystem::CreateRootFlow(UObject* Owner, UFlowAsset* FlowAsset
 
 void UFlowSubsystem::FinishRootFlow(UObject* Owner, UFlowAsset* TemplateAsset, const EFlowFinishPolicy FinishPolicy)
 {
+	if (Owner == nullptr)
+	{
+		return;
+	}
+
 	UFlowAsset* InstanceToFinish = nullptr;
 
-	for (TPair<TObjectPtr<UFlowAsset>, TWeakObjectPtr<UObject>>& RootInstance : RootInstances)
+	for (TMultiMap<TWeakObjectPtr<const UObject>, UFlowAsset*>::TConstKeyIterator It(RootInstancesByOwner, Owner); It; ++It)
 	{
-		if (Owner && Owner == RootInstance.Value.Get() && RootInstance.Key && RootInstance.Key->GetTemplateAsset() == TemplateAsset)
+		if (It.Value() && It.Value()->GetTemplateAsset() == TemplateAsset)
 		{
-			InstanceToFinish = RootInstance.Key;
+			InstanceToFinish = It.Value();
 			break;
 		}
 	}
 
 	if (InstanceToFinish)
 	{
-		RootInstances.Remove(InstanceToFinish);
+		RemoveRootInstance(InstanceToFinish);
 		InstanceToFinish->FinishFlow(FinishPolicy);
 	}
 }
 
 void UFlowSubsystem::FinishAllRootFlows(UObject* Owner, const EFlowFinishPolicy FinishPolicy)
 {
-	TArray<UFlowAsset*> InstancesToFinish;
+	if (Owner == nullptr)
+	{
+		return;
+	}
+
+	TArray<UFlowAsset*, TInlineAllocator<4>> InstancesToFinish;
+	RootInstancesByOwner.MultiFind(Owner, InstancesToFinish);
+
+	for (UFlowAsset* InstanceToFinish : InstancesToFinish)
+	{
+		RemoveRootInstance(InstanceToFinish);
+		InstanceToFinish->FinishFlow(FinishPolicy);
+	}
+}
 
-	for (TPair<TObjectPtr<UFlowAsset>, TWeakObjectPtr<UObject>>& RootInstance : RootInstances)
+void UFlowSubsystem::FinishRootFlowsOfOwners(const TArray<UObject*>& Owners, const EFlowFinishPolicy FinishPolicy)
+{
+	TArray<UFlowAsset*> InstancesToFinish;
+	for (const UObject* Owner : Owners)
 	{
-		if (Owner && Owner == RootInstance.Value.Get() && RootInstance.Key)
+		if (Owner)
 		{
-			InstancesToFinish.Emplace(RootInstance.Key);
+			RootInstancesByOwner.MultiFind(Owner, InstancesToFinish);
 		}
 	}
 
+	// unregister all instances before finishing any of them, owner might be listed more than once
+	InstancesToFinish.RemoveAll([this](UFlowAsset* Instance)
+	{
+		return !RemoveRootInstance(Instance);
+	});
+
 	for (UFlowAsset* InstanceToFinish : InstancesToFinish)
 	{
-		RootInstances.Remove(InstanceToFinish);
 		InstanceToFinish->FinishFlow(FinishPolicy);
 	}
 }
 
+void UFlowSubsystem::AddRootInstance(UObject* Owner, UFlowAsset* Instance)
+{
+	RootInstances.Add(Instance, Owner);
+	RootInstancesByOwner.Add(Owner, Instance);
+}
+
+bool UFlowSubsystem::RemoveRootInstance(UFlowAsset* Instance)
+{
+	TWeakObjectPtr<UObject> Owner;
+	if (RootInstances.RemoveAndCopyValue(Instance, Owner))
+	{
+		// weak pointer keeps identity of the owner, even if the owner has been already destroyed
+		RootInstancesByOwner.RemoveSingle(Owner, Instance);
+		return true;
+	}
+
+	return false;
+}
+
+void UFlowSubsystem::QueueRootFlowStart(UFlowComponent* Component)
+{
+	if (Component->bRootFlowStartQueued)
+	{
+		return;
+	}
+
+	const int32 Priority = FMath::Min(static_cast<int32>(Component->RootFlowStartPriority), static_cast<int32>(EFlowStartPriority::Max) - 1);
+	Component->bRootFlowStartQueued = true;
+	QueuedRootFlowStarts[Priority].Add(Component);
+
+	if (!RootFlowStartTickHandle.IsValid())
+	{
+		RootFlowStartTickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UFlowSubsystem::TickQueuedRootFlowStarts));
+	}
+}
+
+void UFlowSubsystem::FlushQueuedRootFlowStarts()
+{
+	// started flows might queue more components, i.e. by spawning actors
+	while (GetQueuedRootFlowStartsNum() > 0)
+	{
+		StartQueuedRootFlows(true);
+	}
+}
+
+int32 UFlowSubsystem::GetQueuedRootFlowStartsNum() const
+{
+	int32 QueuedNum = 0;
+	for (const TArray<TWeakObjectPtr<UFlowComponent>>& Queue : QueuedRootFlowStarts)
+	{
+		QueuedNum += Queue.Num();
+	}
+	return QueuedNum;
+}
+
+bool UFlowSubsystem::TickQueuedRootFlowStarts(float DeltaTime)
+{
+	StartQueuedRootFlows(false);
+
+	if (GetQueuedRootFlowStartsNum() > 0)
+	{
+		return true;
+	}
+
+	RootFlowStartTickHandle.Reset();
+	return false;
+}
+
+void UFlowSubsystem::StartQueuedRootFlows(const bool bIgnoreBudget)
+{
+	FLOW_SCOPE_CYCLE_COUNTER(StartQueuedRootFlows);
+
+	const UFlowSettings* Settings = UFlowSettings::Get();
+	const double EndTime = Settings->RootFlowStartBudgetMs > 0.0f ? FPlatformTime::Seconds() + Settings->RootFlowStartBudgetMs / 1000.0 : MAX_dbl;
+	const int32 MaxStarts = Settings->MaxRootFlowStartsPerFrame > 0 ? Settings->MaxRootFlowStartsPerFrame : MAX_int32;
+	int32 StartsNum = 0;
+
+	for (int32 Priority = 0; Priority < static_cast<int32>(EFlowStartPriority::Max); Priority++)
+	{
+		const bool bCritical = Priority == static_cast<int32>(EFlowStartPriority::StoryCritical);
+		TArray<TWeakObjectPtr<UFlowComponent>>& Queue = QueuedRootFlowStarts[Priority];
+
+		// queue might grow while starting flows, new entries are processed in the same loop
+		int32 ProcessedNum = 0;
+		for (; ProcessedNum < Queue.Num(); ProcessedNum++)
+		{
+			if (!bIgnoreBudget && !bCritical && StartsNum > 0 && (StartsNum >= MaxStarts || FPlatformTime::Seconds() >= EndTime))
+			{
+				break;
+			}
+
+			// component might have ended play after being queued
+			UFlowComponent* Component = Queue[ProcessedNum].Get();
+			if (Component && Component->bRootFlowStartQueued)
+			{
+				Component->bRootFlowStartQueued = false;
+				Component->StartRootFlow();
+
+				StartsNum++;
+				FLOW_INC_FRAME_COUNTER(QueuedRootFlowStarts);
+			}
+		}
+
+		const bool bQueueEmptied = ProcessedNum == Queue.Num();
+		Queue.RemoveAt(0, ProcessedNum, EAllowShrinking::No);
+
+		if (!bQueueEmptied)
+		{
+			break;
+		}
+	}
+}
+
 UFlowAsset* UFlowSubsystem::CreateSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString& SavedInstanceName, const bool bPreloading /* = false */)
 {
 	UFlowAsset* NewInstance = nullptr;
@@ -172,6 +382,7 @@ UFlowAsset* UFlowSubsystem::CreateSubFlow(UFlowNode_SubGraph* SubGraphNode, cons
 
 		if (NewInstance)
 		{
+			FLOW_INC_FRAME_COUNTER(SubFlowCreations);
 			InstancedSubFlows.Add(SubGraphNode, NewInstance);
 
 			if (bPreloading)
@@ -217,6 +428,8 @@ void UFlowSubsystem::RemoveSubFlow(UFlowNode_SubGraph* SubGraphNode, const EFlow
 
 UFlowAsset* UFlowSubsystem::CreateFlowInstance(const TWeakObjectPtr<UObject> Owner, TSoftObjectPtr<UFlowAsset> FlowAsset, FString NewInstanceName)
 {
+	FLOW_SCOPE_CYCLE_COUNTER(CreateFlowInstance);
+
 	UFlowAsset* LoadedFlowAsset = FlowAsset.LoadSynchronous();
 	if (LoadedFlowAsset == nullptr)
 	{
@@ -233,13 +446,28 @@ UFlowAsset* UFlowSubsystem::CreateFlowInstance(const TWeakObjectPtr<UObject> Own
 	}
 #endif
 
+	// assets saved before introducing the compiled graph
+	if (!LoadedFlowAsset->IsGraphCompiled())
+	{
+		LoadedFlowAsset->CompileGraph();
+	}
+
 	// it won't be empty, if we're restoring Flow Asset instance from the SaveGame
 	if (NewInstanceName.IsEmpty())
 	{
-		NewInstanceName = MakeUniqueObjectName(this, UFlowAsset::StaticClass(), *FPaths::GetBaseFilename(LoadedFlowAsset->GetPathName())).ToString();
+		// names of loaded records are taken too, as records of Root Flows waiting for their asset are carried forward by saving
+		do
+		{
+			NewInstanceName = MakeUniqueObjectName(this, UFlowAsset::StaticClass(), *FPaths::GetBaseFilename(LoadedFlowAsset->GetPathName())).ToString();
+		}
+		while (LoadedAssetRecordIndices.Contains(NewInstanceName));
 	}
 
-	UFlowAsset* NewInstance = NewObject<UFlowAsset>(this, LoadedFlowAsset->GetClass(), *NewInstanceName, RF_Transient, LoadedFlowAsset, false, nullptr);
+	UFlowAsset* NewInstance = TakeInstanceFromPool(LoadedFlowAsset, NewInstanceName);
+	if (NewInstance == nullptr)
+	{
+		NewInstance = NewObject<UFlowAsset>(this, LoadedFlowAsset->GetClass(), *NewInstanceName, RF_Transient, LoadedFlowAsset, false, nullptr);
+	}
 	NewInstance->InitializeInstance(Owner, *LoadedFlowAsset);
 
 	LoadedFlowAsset->AddInstance(NewInstance);
@@ -270,229 +498,1032 @@ void UFlowSubsystem::RemoveInstancedTemplate(UFlowAsset* Template)
 	InstancedTemplates.Remove(Template);
 }
 
-TMap<UObject*, UFlowAsset*> UFlowSubsystem::GetRootInstances() const
+void UFlowSubsystem::WarmUpInstancePool(UFlowAsset* Template, const int32 InstancesNum)
 {
-	TMap<UObject*, UFlowAsset*> Result;
-	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : ObjectPtrDecay(RootInstances))
+	const int32 MaxPooledInstances = UFlowSettings::Get()->MaxPooledInstancesPerTemplate;
+	if (Template == nullptr || MaxPooledInstances <= 0)
 	{
-		Result.Emplace(RootInstance.Value.Get(), RootInstance.Key);
+		return;
 	}
-	return Result;
-}
 
-TSet<UFlowAsset*> UFlowSubsystem::GetRootInstancesByOwner(const UObject* Owner) const
-{
-	TSet<UFlowAsset*> Result;
-	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : ObjectPtrDecay(RootInstances))
+	FFlowInstancePool& Pool = InstancePools.FindOrAdd(Template);
+	const FString PooledBaseName = TEXT("Pooled_") + FPaths::GetBaseFilename(Template->GetPathName());
+
+	while (Pool.Instances.Num() < FMath::Min(InstancesNum, MaxPooledInstances))
 	{
-		if (Owner && RootInstance.Value == Owner)
-		{
-			Result.Emplace(RootInstance.Key);
-		}
+		const FName PooledName = MakeUniqueObjectName(this, Template->GetClass(), *PooledBaseName);
+		UFlowAsset* NewInstance = NewObject<UFlowAsset>(this, Template->GetClass(), PooledName, RF_Transient, Template, false, nullptr);
+		NewInstance->PreinstantiateNodes();
+
+		Pool.Instances.Add(NewInstance);
+		Pool.ReturnFrames.Add(0);
 	}
-	return Result;
 }
 
-UFlowAsset* UFlowSubsystem::GetRootFlow(const UObject* Owner) const
+void UFlowSubsystem::EmptyInstancePools()
 {
-	const TSet<UFlowAsset*> Result = GetRootInstancesByOwner(Owner);
-	if (Result.Num() > 0)
+	for (const TPair<TObjectPtr<UFlowAsset>, FFlowInstancePool>& Pool : InstancePools)
 	{
-		return Result.Array()[0];
+		UE_LOG(LogFlow, Verbose, TEXT("Instance pool of %s: %d hits, %d misses, %d pooled instances"),
+			*GetNameSafe(Pool.Key), Pool.Value.Hits, Pool.Value.Misses, Pool.Value.Instances.Num());
 	}
 
-	return nullptr;
-}
-
-UWorld* UFlowSubsystem::GetWorld() const
-{
-	return GetGameInstance()->GetWorld();
+	InstancePools.Empty();
 }
 
-void UFlowSubsystem::OnGameSaved(UFlowSaveGame* SaveGame)
+UFlowAsset* UFlowSubsystem::TakeInstanceFromPool(UFlowAsset* Template, const FString& NewInstanceName)
 {
-	// clear existing data, in case we received reused SaveGame instance
-	// we only remove data for the current world + global Flow Graph instances (i.e. not bound to any world if created by UGameInstanceSubsystem)
-	// we keep data bound to other worlds
-	if (GetWorld())
+	if (UFlowSettings::Get()->MaxPooledInstancesPerTemplate <= 0)
 	{
-		const FString& WorldName = GetWorld()->GetName();
+		return nullptr;
+	}
 
-		for (int32 i = SaveGame->FlowInstances.Num() - 1; i >= 0; i--)
-		{
-			if (SaveGame->FlowInstances[i].WorldName.IsEmpty() || SaveGame->FlowInstances[i].WorldName == WorldName)
-			{
-				SaveGame->FlowInstances.RemoveAt(i);
-			}
-		}
+	FFlowInstancePool& Pool = InstancePools.FindOrAdd(Template);
 
-		for (int32 i = SaveGame->FlowComponents.Num() - 1; i >= 0; i--)
+	// instances are returned in order, so the first one is the oldest
+	// instance returned in this frame might be still referenced by the code finishing it
+	if (Pool.Instances.Num() > 0 && Pool.ReturnFrames[0] != GFrameCounter)
+	{
+		UFlowAsset* PooledInstance = Pool.Instances[0];
+		if (IsValid(PooledInstance) && PooledInstance->Rename(*NewInstanceName, nullptr, REN_Test))
 		{
-			if (SaveGame->FlowComponents[i].WorldName.IsEmpty() || SaveGame->FlowComponents[i].WorldName == WorldName)
-			{
-				SaveGame->FlowComponents.RemoveAt(i);
-			}
+			Pool.Instances.RemoveAt(0, 1, EAllowShrinking::No);
+			Pool.ReturnFrames.RemoveAt(0, 1, EAllowShrinking::No);
+			Pool.Hits++;
+
+			PooledInstance->Rename(*NewInstanceName, nullptr, REN_DontCreateRedirectors | REN_NonTransactional | REN_DoNotDirty);
+			return PooledInstance;
 		}
 	}
 
-	// save Flow Graphs
-	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : ObjectPtrDecay(RootInstances))
+	Pool.Misses++;
+	return nullptr;
+}
+
+void UFlowSubsystem::ReturnInstanceToPool(UFlowAsset* Instance, UFlowAsset* Template)
+{
+	const int32 MaxPooledInstances = UFlowSettings::Get()->MaxPooledInstancesPerTemplate;
+	if (bAbortingActiveFlows || MaxPooledInstances <= 0 || Instance == nullptr || Template == nullptr)
 	{
-		if (RootInstance.Key && RootInstance.Value.IsValid())
-		{
-			if (UFlowComponent* FlowComponent = Cast<UFlowComponent>(RootInstance.Value))
-			{
-				FlowComponent->SaveRootFlow(SaveGame->FlowInstances);
-			}
-			else
-			{
-				RootInstance.Key->SaveInstance(SaveGame->FlowInstances);
-			}
-		}
+		return;
 	}
 
-	// save Flow Components
+	if (!Instance->CanResetInstanceForPool())
 	{
-		// retrieve all registered components
-		TArray<TWeakObjectPtr<UFlowComponent>> ComponentsArray;
-		FlowComponentRegistry.GenerateValueArray(ComponentsArray);
-
-		// ensure uniqueness of entries
-		const TSet<TWeakObjectPtr<UFlowComponent>> RegisteredComponents = TSet<TWeakObjectPtr<UFlowComponent>>(ComponentsArray);
+		UE_LOG(LogFlow, Verbose, TEXT("Flow Asset instance %s isn't returned to the pool, it used Blueprint nodes"), *Instance->GetName());
+		return;
+	}
 
-		// write archives to SaveGame
-		for (const TWeakObjectPtr<UFlowComponent> RegisteredComponent : RegisteredComponents)
-		{
-			SaveGame->FlowComponents.Emplace(RegisteredComponent->SaveInstance());
-		}
+	FFlowInstancePool& Pool = InstancePools.FindOrAdd(Template);
+	if (Pool.Instances.Num() >= MaxPooledInstances || Pool.Instances.Contains(Instance))
+	{
+		return;
 	}
-}
 
-void UFlowSubsystem::OnGameLoaded(UFlowSaveGame* SaveGame)
-{
-	LoadedSaveGame = SaveGame;
+	Instance->ResetInstanceForPool(*Template);
 
-	// here's opportunity to apply loaded data to custom systems
-	// it's recommended to do this by overriding method in the subclass
+	// release the instance name, so it can be used by the next instance (i.e. loaded from SaveGame)
+	const FName PooledName = MakeUniqueObjectName(this, Template->GetClass(), *(TEXT("Pooled_") + FPaths::GetBaseFilename(Template->GetPathName())));
+	Instance->Rename(*PooledName.ToString(), nullptr, REN_DontCreateRedirectors | REN_NonTransactional | REN_DoNotDirty);
+
+	Pool.Instances.Add(Instance);
+	Pool.ReturnFrames.Add(GFrameCounter);
 }
 
-void UFlowSubsystem::LoadRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const FString& SavedAssetInstanceName)
+void UFlowSubsystem::OnWorldInitializedActors(const UWorld::FActorsInitializedParams& Params)
 {
-	if (FlowAsset == nullptr || SavedAssetInstanceName.IsEmpty())
+	if (Params.World == nullptr || Params.World->GetGameInstance() != GetGameInstance())
 	{
 		return;
 	}
 
-	for (const FFlowAssetSaveData& AssetRecord : LoadedSaveGame->FlowInstances)
+	for (const TPair<TSoftObjectPtr<UFlowAsset>, int32>& WarmUpEntry : UFlowSettings::Get()->PooledInstancesToWarmUp)
 	{
-		if (AssetRecord.InstanceName == SavedAssetInstanceName
-			&& (FlowAsset->IsBoundToWorld() == false || AssetRecord.WorldName == GetWorld()->GetName()))
+		if (UFlowAsset* Template = WarmUpEntry.Key.LoadSynchronous())
 		{
-			UFlowAsset* LoadedInstance = CreateRootFlow(Owner, FlowAsset, false);
-			if (LoadedInstance)
-			{
-				LoadedInstance->LoadInstance(AssetRecord);
-			}
-			return;
+			WarmUpInstancePool(Template, WarmUpEntry.Value);
 		}
 	}
 }
 
-void UFlowSubsystem::LoadSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString& SavedAssetInstanceName)
+bool UFlowSubsystem::TickTimerWheel(float DeltaTime)
 {
-	if (SubGraphNode->Asset.IsNull())
+	FLOW_SCOPE_CYCLE_COUNTER(TickTimers);
+
+	const UWorld* World = GetWorld();
+	if (World == nullptr)
 	{
-		return;
+		return true;
 	}
 
-	UFlowAsset* SubGraphAsset = SubGraphNode->Asset.LoadSynchronous();
-
-	for (const FFlowAssetSaveData& AssetRecord : LoadedSaveGame->FlowInstances)
+	// follow the world time, so timers respect pause and time dilation like world timers do
+	const double WorldTime = World->GetTimeSeconds();
+	if (TimerWheelWorld.Get() != World)
 	{
-		if (AssetRecord.InstanceName == SavedAssetInstanceName
-			&& ((SubGraphAsset && SubGraphAsset->IsBoundToWorld() == false) || AssetRecord.WorldName == GetWorld()->GetName()))
-		{
-			UFlowAsset* LoadedInstance = CreateSubFlow(SubGraphNode, SavedAssetInstanceName);
-			if (LoadedInstance)
-			{
-				LoadedInstance->LoadInstance(AssetRecord);
-			}
-			return;
-		}
+		TimerWheelWorld = World;
+		TimerWheelWorldTime = WorldTime;
 	}
+
+	TimerWheel.Advance(WorldTime - TimerWheelWorldTime);
+	TimerWheelWorldTime = WorldTime;
+
+	SET_DWORD_STAT(STAT_FlowActiveTimers, TimerWheel.Num());
+	return true;
 }
 
-void UFlowSubsystem::RegisterComponent(UFlowComponent* Component)
+void UFlowSubsystem::AddSoftRootFlowComponent(UFlowComponent* Component)
 {
-	for (const FGameplayTag& Tag : Component->IdentityTags)
+	if (Component->bSoftRootFlowReported)
 	{
-		if (Tag.IsValid())
-		{
-			FlowComponentRegistry.Emplace(Tag, Component);
-		}
+		return;
 	}
 
-	OnComponentRegistered.Broadcast(Component);
+	const FSoftObjectPath AssetPath = Component->SoftRootFlow.ToSoftObjectPath();
+	FFlowRootFlowLoadReport& Stats = RootFlowLoadStats.FindOrAdd(AssetPath);
+	Stats.Asset = AssetPath;
+	Stats.Components++;
+
+	Component->bSoftRootFlowReported = true;
 }
 
-void UFlowSubsystem::OnIdentityTagAdded(UFlowComponent* Component, const FGameplayTag& AddedTag)
+void UFlowSubsystem::RemoveSoftRootFlowComponent(UFlowComponent* Component)
 {
-	FlowComponentRegistry.Emplace(AddedTag, Component);
-
-	// broadcast OnComponentRegistered only if this component wasn't present in the registry previously
-	if (Component->IdentityTags.Num() > 1)
+	if (!Component->bSoftRootFlowReported)
 	{
-		OnComponentTagAdded.Broadcast(Component, FGameplayTagContainer(AddedTag));
+		return;
 	}
-	else
+
+	if (FFlowRootFlowLoadReport* Stats = RootFlowLoadStats.Find(Component->SoftRootFlow.ToSoftObjectPath()))
 	{
-		OnComponentRegistered.Broadcast(Component);
+		Stats->Components = FMath::Max(Stats->Components - 1, 0);
+		if (Component->bSoftRootFlowWaited)
+		{
+			Stats->WaitingComponents = FMath::Max(Stats->WaitingComponents - 1, 0);
+		}
 	}
+
+	Component->bSoftRootFlowReported = false;
+	Component->bSoftRootFlowWaited = false;
 }
 
-void UFlowSubsystem::OnIdentityTagsAdded(UFlowComponent* Component, const FGameplayTagContainer& AddedTags)
+void UFlowSubsystem::RequestRootFlowLoad(UFlowComponent* Component, const TSoftObjectPtr<UFlowAsset>& FlowAsset)
 {
-	for (const FGameplayTag& Tag : AddedTags)
+	if (UFlowAsset* LoadedAsset = FlowAsset.Get())
 	{
-		FlowComponentRegistry.Emplace(Tag, Component);
+		Component->OnSoftRootFlowLoaded(LoadedAsset);
+		return;
 	}
 
-	// broadcast OnComponentRegistered only if this component wasn't present in the registry previously
-	if (Component->IdentityTags.Num() > AddedTags.Num())
+	const FSoftObjectPath AssetPath = FlowAsset.ToSoftObjectPath();
+	FRootFlowLoad& Load = RootFlowLoads.FindOrAdd(AssetPath);
+	Load.WaitingComponents.AddUnique(Component);
+
+	FFlowRootFlowLoadReport& Stats = RootFlowLoadStats.FindOrAdd(AssetPath);
+	Stats.Asset = AssetPath;
+	if (Component->bSoftRootFlowReported && !Component->bSoftRootFlowWaited)
 	{
-		OnComponentTagAdded.Broadcast(Component, AddedTags);
+		Stats.WaitingComponents++;
+		Component->bSoftRootFlowWaited = true;
 	}
-	else
+
+	if (!Load.Handle.IsValid())
 	{
-		OnComponentRegistered.Broadcast(Component);
+		Stats.LoadRequests++;
+
+		Load.Handle = StreamableManager.RequestAsyncLoad(AssetPath, FStreamableDelegate::CreateUObject(this, &UFlowSubsystem::OnRootFlowLoaded, AssetPath));
+		if (!Load.Handle.IsValid())
+		{
+			// invalid path, notify waiting components the same way as on failed load
+			OnRootFlowLoaded(AssetPath);
+		}
 	}
 }
 
-void UFlowSubsystem::UnregisterComponent(UFlowComponent* Component)
+void UFlowSubsystem::CancelRootFlowLoad(UFlowComponent* Component, const TSoftObjectPtr<UFlowAsset>& FlowAsset)
 {
-	for (const FGameplayTag& Tag : Component->IdentityTags)
+	const FSoftObjectPath AssetPath = FlowAsset.ToSoftObjectPath();
+	if (FRootFlowLoad* Load = RootFlowLoads.Find(AssetPath))
 	{
-		if (Tag.IsValid())
+		Load->WaitingComponents.Remove(Component);
+
+		// keep loading as long as any component still waits for the asset
+		if (Load->WaitingComponents.IsEmpty())
 		{
-			FlowComponentRegistry.Remove(Tag, Component);
+			if (Load->Handle.IsValid())
+			{
+				Load->Handle->CancelHandle();
+			}
+			RootFlowLoads.Remove(AssetPath);
 		}
 	}
-
-	OnComponentUnregistered.Broadcast(Component);
 }
 
-void UFlowSubsystem::OnIdentityTagRemoved(UFlowComponent* Component, const FGameplayTag& RemovedTag)
+void UFlowSubsystem::OnRootFlowLoaded(FSoftObjectPath AssetPath)
 {
-	FlowComponentRegistry.Remove(RemovedTag, Component);
-
+	FRootFlowLoad Load;
+	if (!RootFlowLoads.RemoveAndCopyValue(AssetPath, Load))
+	{
+		return;
+	}
+
+	UFlowAsset* LoadedAsset = Cast<UFlowAsset>(AssetPath.ResolveObject());
+	if (LoadedAsset == nullptr)
+	{
+		UE_LOG(LogFlow, Error, TEXT("Failed to load Root Flow asset %s"), *AssetPath.ToString());
+	}
+
+	for (const TWeakObjectPtr<UFlowComponent>& Component : Load.WaitingComponents)
+	{
+		if (Component.IsValid())
+		{
+			Component->OnSoftRootFlowLoaded(LoadedAsset);
+		}
+	}
+
+	// asset is referenced by Root Flow of components now, it unloads with the last of them
+	if (Load.Handle.IsValid())
+	{
+		Load.Handle->ReleaseHandle();
+	}
+}
+
+TArray<FFlowRootFlowLoadReport> UFlowSubsystem::GetRootFlowLoadReport() const
+{
+	const IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+
+	TArray<FFlowRootFlowLoadReport> Report;
+	Report.Reserve(RootFlowLoadStats.Num());
+
+	for (const TPair<FSoftObjectPath, FFlowRootFlowLoadReport>& Stats : RootFlowLoadStats)
+	{
+		FFlowRootFlowLoadReport& Entry = Report.Add_GetRef(Stats.Value);
+		Entry.bLoaded = Stats.Key.ResolveObject() != nullptr;
+
+		if (AssetRegistry)
+		{
+			const FName AssetPackage = Stats.Key.GetLongPackageFName();
+			if (const TOptional<FAssetPackageData> PackageData = AssetRegistry->GetAssetPackageDataCopy(AssetPackage))
+			{
+				Entry.PackageSize = PackageData->DiskSize;
+			}
+
+			// walk hard package references, as these are loaded with the asset
+			TSet<FName> VisitedPackages = {AssetPackage};
+			TArray<FName> PackagesToVisit = {AssetPackage};
+			while (PackagesToVisit.Num() > 0)
+			{
+				TArray<FName> Dependencies;
+				AssetRegistry->GetDependencies(PackagesToVisit.Pop(), Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+
+				for (const FName& Dependency : Dependencies)
+				{
+					bool bAlreadyVisited = false;
+					VisitedPackages.Add(Dependency, &bAlreadyVisited);
+					if (!bAlreadyVisited)
+					{
+						PackagesToVisit.Add(Dependency);
+
+						// script packages have no package data
+						if (const TOptional<FAssetPackageData> DependencyData = AssetRegistry->GetAssetPackageDataCopy(Dependency))
+						{
+							Entry.DependenciesSize += FMath::Max<int64>(DependencyData->DiskSize, 0);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	Report.Sort([](const FFlowRootFlowLoadReport& A, const FFlowRootFlowLoadReport& B)
+	{
+		return A.Components > B.Components;
+	});
+
+	return Report;
+}
+
+void UFlowSubsystem::LogRootFlowLoadReport() const
+{
+	int32 DeferredAssets = 0;
+	int64 DeferredSize = 0;
+
+	for (const FFlowRootFlowLoadReport& Entry : GetRootFlowLoadReport())
+	{
+		UE_LOG(LogFlow, Log, TEXT("%s: %d components, %d waited for %d loads, %s, package size %lld KB, dependencies %lld KB"),
+			*Entry.Asset.ToString(), Entry.Components, Entry.WaitingComponents, Entry.LoadRequests,
+			Entry.bLoaded ? TEXT("loaded") : TEXT("not loaded"), Entry.PackageSize >= 0 ? Entry.PackageSize / 1024 : -1, Entry.DependenciesSize / 1024);
+
+		if (!Entry.bLoaded)
+		{
+			DeferredAssets++;
+			DeferredSize += FMath::Max<int64>(Entry.PackageSize, 0) + Entry.DependenciesSize;
+		}
+	}
+
+	UE_LOG(LogFlow, Log, TEXT("Soft Root Flow assets: %d used, %d not loaded (%lld KB of their packages and hard references on disk)"), RootFlowLoadStats.Num(), DeferredAssets, DeferredSize / 1024);
+}
+
+#if CSV_PROFILER
+void UFlowSubsystem::RecordCsvInstanceStats()
+{
+	int32 InstancesNum = 0;
+	int32 ActiveNodesNum = 0;
+
+	for (const UFlowAsset* Template : InstancedTemplates)
+	{
+		if (Template)
+		{
+			FCsvProfiler::RecordCustomStat(*Template->GetName(), CSV_CATEGORY_INDEX(FlowInstances), Template->GetInstancesNum(), ECsvCustomStatOp::Set);
+			InstancesNum += Template->GetInstancesNum();
+
+			for (const UFlowAsset* Instance : Template->ActiveInstances)
+			{
+				if (Instance)
+				{
+					ActiveNodesNum += Instance->ActiveNodes.Num();
+				}
+			}
+		}
+	}
+
+	CSV_CUSTOM_STAT(Flow, Instances, InstancesNum, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Flow, ActiveNodes, ActiveNodesNum, ECsvCustomStatOp::Set);
+}
+#endif
+
+TMap<UObject*, UFlowAsset*> UFlowSubsystem::GetRootInstances() const
+{
+	TMap<UObject*, UFlowAsset*> Result;
+	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : ObjectPtrDecay(RootInstances))
+	{
+		Result.Emplace(RootInstance.Value.Get(), RootInstance.Key);
+	}
+	return Result;
+}
+
+TSet<UFlowAsset*> UFlowSubsystem::GetRootInstancesByOwner(const UObject* Owner) const
+{
+	TSet<UFlowAsset*> Result;
+	if (Owner)
+	{
+		for (TMultiMap<TWeakObjectPtr<const UObject>, UFlowAsset*>::TConstKeyIterator It(RootInstancesByOwner, Owner); It; ++It)
+		{
+			Result.Emplace(It.Value());
+		}
+	}
+	return Result;
+}
+
+UFlowAsset* UFlowSubsystem::GetRootFlow(const UObject* Owner) const
+{
+	const TSet<UFlowAsset*> Result = GetRootInstancesByOwner(Owner);
+	if (Result.Num() > 0)
+	{
+		return Result.Array()[0];
+	}
+
+	return nullptr;
+}
+
+UWorld* UFlowSubsystem::GetWorld() const
+{
+	return GetGameInstance()->GetWorld();
+}
+
+void UFlowSubsystem::OnGameSaved(UFlowSaveGame* SaveGame)
+{
+	FLOW_SCOPE_CYCLE_COUNTER(SaveGame);
+
+	TGuardValue<TObjectPtr<UFlowSaveGame>> SavingGameGuard(SavingGame, SaveGame);
+	LastSaveStats = FFlowSaveStats();
+
+	// Soft Root Flows waiting for their asset aren't instanced, their loaded records are carried forward without loading the asset
+	// copy them before clearing records, since the loaded SaveGame might be the one we're writing to
+	TArray<TWeakObjectPtr<UFlowComponent>> PendingRootFlowComponents;
+	TArray<FFlowAssetSaveData> PendingRootFlowRecords;
+	GatherPendingRootFlowRecords(PendingRootFlowComponents, PendingRootFlowRecords);
+
+	// copied records can only be decoded with the table they were written with
+	const bool bPendingCompactRecords = PendingRootFlowRecords.ContainsByPredicate([](const FFlowAssetSaveData& AssetRecord)
+	{
+		return FFlowSaveSerializer::IsCompactRecord(AssetRecord.AssetData) || AssetRecord.NodeRecords.ContainsByPredicate([](const FFlowNodeSaveData& NodeRecord)
+		{
+			return FFlowSaveSerializer::IsCompactRecord(NodeRecord.NodeData);
+		});
+	});
+	const FFlowSaveTable* PendingRecordsTable = bPendingCompactRecords ? GetSaveTableForLoading() : nullptr;
+
+	// sub-flows waiting for their asset would lose their records, as these exist only in the loaded SaveGame
+	// restore them before clearing records, since the loaded SaveGame might be the one we're writing to
+	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : ObjectPtrDecay(RootInstances))
+	{
+		if (RootInstance.Key)
+		{
+			RootInstance.Key->CompletePendingSubFlowRestores();
+		}
+	}
+
+	// clear existing data, in case we received reused SaveGame instance
+	// we only remove data for the current world + global Flow Graph instances (i.e. not bound to any world if created by UGameInstanceSubsystem)
+	// we keep data bound to other worlds
+	if (GetWorld())
+	{
+		const FString& WorldName = GetWorld()->GetName();
+
+		SaveGame->FlowInstances.RemoveAll([&WorldName](const FFlowAssetSaveData& AssetRecord)
+		{
+			return AssetRecord.WorldName.IsEmpty() || AssetRecord.WorldName == WorldName;
+		});
+
+		SaveGame->FlowComponents.RemoveAll([&WorldName](const FFlowComponentSaveData& ComponentRecord)
+		{
+			return ComponentRecord.WorldName.IsEmpty() || ComponentRecord.WorldName == WorldName;
+		});
+	}
+
+	bool bCanCarryPendingRecords = true;
+	if (UFlowSettings::Get()->bUseCompactSaveArchive)
+	{
+		bCanCarryPendingRecords = PrepareSaveTable(*SaveGame, PendingRecordsTable);
+	}
+	else if (!SaveGame->HasCompactRecords())
+	{
+		if (PendingRecordsTable)
+		{
+			SaveGame->SaveTable = *PendingRecordsTable;
+		}
+		else
+		{
+			SaveGame->SaveTable.Reset();
+		}
+	}
+	else if (PendingRecordsTable)
+	{
+		bCanCarryPendingRecords = SaveGame->SaveTable.GetSerialNumber() == PendingRecordsTable->GetSerialNumber();
+	}
+
+	// records of other worlds index a different table, possible only if SaveGame isn't the loaded one
+	// the loaded records are intact then, so restoring the pending Root Flows is the only way to keep their state
+	if (!bCanCarryPendingRecords)
+	{
+		for (const TWeakObjectPtr<UFlowComponent>& Component : PendingRootFlowComponents)
+		{
+			if (Component.IsValid())
+			{
+				Component->CompleteSoftRootFlowLoad();
+			}
+		}
+	}
+
+	// save Flow Graphs
+	for (const TPair<UFlowAsset*, TWeakObjectPtr<UObject>>& RootInstance : ObjectPtrDecay(RootInstances))
+	{
+		if (RootInstance.Key && RootInstance.Value.IsValid())
+		{
+			if (UFlowComponent* FlowComponent = Cast<UFlowComponent>(RootInstance.Value))
+			{
+				FlowComponent->SaveRootFlow(SaveGame->FlowInstances);
+			}
+			else
+			{
+				RootInstance.Key->SaveInstance(SaveGame->FlowInstances);
+			}
+		}
+	}
+
+	// components keep their SavedAssetInstanceName, as SaveRootFlow isn't called for them
+	if (bCanCarryPendingRecords)
+	{
+		SaveGame->FlowInstances.Append(MoveTemp(PendingRootFlowRecords));
+	}
+
+	// save Flow Components
+	{
+		// retrieve all registered components
+		TArray<TWeakObjectPtr<UFlowComponent>> ComponentsArray;
+		FlowComponentRegistry.GenerateValueArray(ComponentsArray);
+
+		// ensure uniqueness of entries
+		const TSet<TWeakObjectPtr<UFlowComponent>> RegisteredComponents = TSet<TWeakObjectPtr<UFlowComponent>>(ComponentsArray);
+
+		// write archives to SaveGame
+		for (const TWeakObjectPtr<UFlowComponent> RegisteredComponent : RegisteredComponents)
+		{
+			SaveGame->FlowComponents.Emplace(RegisteredComponent->SaveInstance());
+		}
+	}
+
+	// SaveGame gets a snapshot of the table, records written now index entries it already had or appended ones
+	if (UFlowSettings::Get()->bUseCompactSaveArchive)
+	{
+		SaveGame->SaveTable = SaveTable;
+		if (bCompactingSaveTable)
+		{
+			SaveTableEntriesAfterCompaction = SaveTable.Num();
+			bCompactingSaveTable = false;
+		}
+	}
+
+	// records of the loaded SaveGame have been rewritten
+	if (SaveGame == LoadedSaveGame)
+	{
+		BuildLoadedRecordIndices();
+	}
+
+	UE_LOG(LogFlow, Verbose, TEXT("Flow save: reused %d records, serialized %d records"), LastSaveStats.ReusedRecords, LastSaveStats.SerializedRecords);
+}
+
+bool UFlowSubsystem::PrepareSaveTable(const UFlowSaveGame& SaveGame, const FFlowSaveTable* RequiredTable)
+{
+	if (SaveGame.HasCompactRecords())
+	{
+		// records of other worlds index the table of this SaveGame
+		// a snapshot of our table is its prefix, as the table is only extended until compacted
+		if (SaveGame.SaveTable.GetSerialNumber() != SaveTable.GetSerialNumber())
+		{
+			SaveTable = SaveGame.SaveTable;
+		}
+
+		return RequiredTable == nullptr || RequiredTable->GetSerialNumber() == SaveTable.GetSerialNumber();
+	}
+
+	if (RequiredTable)
+	{
+		// copied records index this table, so it can't be compacted now
+		if (RequiredTable->GetSerialNumber() != SaveTable.GetSerialNumber())
+		{
+			SaveTable = *RequiredTable;
+		}
+
+		return true;
+	}
+
+	// small table isn't worth serializing all records again
+	constexpr int32 MinEntriesToCompact = 1024;
+	if (SaveTable.Num() > FMath::Max(MinEntriesToCompact, SaveTableEntriesAfterCompaction * 2))
+	{
+		// table keeps entries of records that aren't saved anymore, rebuild it from records written now
+		// this changes the serial number, so all records are serialized again
+		SaveTable.Reset();
+		bCompactingSaveTable = true;
+	}
+
+	return true;
+}
+
+void UFlowSubsystem::GatherPendingRootFlowRecords(TArray<TWeakObjectPtr<UFlowComponent>>& OutComponents, TArray<FFlowAssetSaveData>& OutRecords) const
+{
+	if (LoadedSaveGame == nullptr)
+	{
+		return;
+	}
+
+	for (const TPair<FSoftObjectPath, FRootFlowLoad>& RootFlowLoad : RootFlowLoads)
+	{
+		for (const TWeakObjectPtr<UFlowComponent>& Component : RootFlowLoad.Value.WaitingComponents)
+		{
+			if (!Component.IsValid() || Component->PendingSoftRootFlowAction != EFlowSoftRootFlowAction::Load || Component->SavedAssetInstanceName.IsEmpty())
+			{
+				continue;
+			}
+
+			// asset isn't loaded, so it's unknown whether it's bound to the world
+			int32 RecordIndex = FindLoadedAssetRecordIndex(Component->SavedAssetInstanceName, true);
+			if (RecordIndex == INDEX_NONE)
+			{
+				RecordIndex = FindLoadedAssetRecordIndex(Component->SavedAssetInstanceName, false);
+			}
+
+			if (RecordIndex != INDEX_NONE)
+			{
+				// records of sub-flows precede the root record
+				const int32 FirstIndex = FMath::Max(0, RecordIndex - LoadedSaveGame->FlowInstances[RecordIndex].SubFlowRecordsNum);
+				OutRecords.Append(&LoadedSaveGame->FlowInstances[FirstIndex], RecordIndex - FirstIndex + 1);
+				OutComponents.Add(Component);
+			}
+		}
+	}
+}
+
+void UFlowSubsystem::OnGameLoaded(UFlowSaveGame* SaveGame)
+{
+	FLOW_SCOPE_CYCLE_COUNTER(LoadGame);
+
+	LoadedSaveGame = SaveGame;
+	BuildLoadedRecordIndices();
+
+	// here's opportunity to apply loaded data to custom systems
+	// it's recommended to do this by overriding method in the subclass
+}
+
+void UFlowSubsystem::LoadRootFlow(UObject* Owner, UFlowAsset* FlowAsset, const FString& SavedAssetInstanceName)
+{
+	if (FlowAsset == nullptr || SavedAssetInstanceName.IsEmpty())
+	{
+		return;
+	}
+
+	if (const FFlowAssetSaveData* AssetRecord = FindLoadedAssetRecord(SavedAssetInstanceName, FlowAsset->IsBoundToWorld()))
+	{
+		UFlowAsset* LoadedInstance = CreateRootFlow(Owner, FlowAsset, false);
+		if (LoadedInstance)
+		{
+			LoadedInstance->LoadInstance(*AssetRecord);
+		}
+	}
+}
+
+void UFlowSubsystem::LoadSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString& SavedAssetInstanceName)
+{
+	if (SubGraphNode->Asset.IsNull())
+	{
+		return;
+	}
+
+	UFlowAsset* SubGraphAsset = SubGraphNode->Asset.LoadSynchronous();
+
+	const bool bMatchWorld = SubGraphAsset == nullptr || SubGraphAsset->IsBoundToWorld();
+	if (const FFlowAssetSaveData* AssetRecord = FindLoadedAssetRecord(SavedAssetInstanceName, bMatchWorld))
+	{
+		UFlowAsset* LoadedInstance = CreateSubFlow(SubGraphNode, SavedAssetInstanceName);
+		if (LoadedInstance)
+		{
+			LoadedInstance->LoadInstance(*AssetRecord);
+		}
+	}
+}
+
+const FFlowAssetSaveData* UFlowSubsystem::FindLoadedAssetRecord(const FString& InstanceName, const bool bMatchWorld) const
+{
+	const int32 RecordIndex = FindLoadedAssetRecordIndex(InstanceName, bMatchWorld);
+	return RecordIndex == INDEX_NONE ? nullptr : &LoadedSaveGame->FlowInstances[RecordIndex];
+}
+
+int32 UFlowSubsystem::FindLoadedAssetRecordIndex(const FString& InstanceName, const bool bMatchWorld) const
+{
+	if (LoadedSaveGame == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	// pick the first matching record, same as searching the array would do
+	const UWorld* World = GetWorld();
+	int32 FoundIndex = INDEX_NONE;
+	for (TMultiMap<FString, int32>::TConstKeyIterator It(LoadedAssetRecordIndices, InstanceName); It; ++It)
+	{
+		if (LoadedSaveGame->FlowInstances.IsValidIndex(It.Value()))
+		{
+			const FFlowAssetSaveData& AssetRecord = LoadedSaveGame->FlowInstances[It.Value()];
+			if (AssetRecord.InstanceName == InstanceName && (!bMatchWorld || (World && AssetRecord.WorldName == World->GetName()))
+				&& (FoundIndex == INDEX_NONE || It.Value() < FoundIndex))
+			{
+				FoundIndex = It.Value();
+			}
+		}
+	}
+
+	return FoundIndex;
+}
+
+const FFlowComponentSaveData* UFlowSubsystem::FindLoadedComponentRecord(const FString& ActorInstanceName) const
+{
+	const UWorld* World = GetWorld();
+	if (LoadedSaveGame == nullptr || World == nullptr)
+	{
+		return nullptr;
+	}
+
+	const FFlowComponentSaveData* FoundRecord = nullptr;
+	for (TMultiMap<FString, int32>::TConstKeyIterator It(LoadedComponentRecordIndices, ActorInstanceName); It; ++It)
+	{
+		if (LoadedSaveGame->FlowComponents.IsValidIndex(It.Value()))
+		{
+			const FFlowComponentSaveData& ComponentRecord = LoadedSaveGame->FlowComponents[It.Value()];
+			if (ComponentRecord.ActorInstanceName == ActorInstanceName && ComponentRecord.WorldName == World->GetName()
+				&& (FoundRecord == nullptr || &ComponentRecord < FoundRecord))
+			{
+				FoundRecord = &ComponentRecord;
+			}
+		}
+	}
+
+	return FoundRecord;
+}
+
+void UFlowSubsystem::SaveGameAsync(UFlowSaveGame* SaveGame, const int32 UserIndex, const FFlowSaveGameCompleted& OnCompleted, const FFlowSaveGameCaptured& OnCaptured)
+{
+	if (SaveGame == nullptr)
+	{
+		OnCompleted.ExecuteIfBound(nullptr, EFlowSaveGameResult::Failed);
+		return;
+	}
+
+	FFlowSaveGameRequest* Request = PendingSaveRequests.FindByPredicate([SaveGame, UserIndex](const FFlowSaveGameRequest& PendingRequest)
+	{
+		return PendingRequest.UserIndex == UserIndex && PendingRequest.SaveGame->SaveSlotName == SaveGame->SaveSlotName;
+	});
+	if (Request == nullptr)
+	{
+		Request = &PendingSaveRequests.AddDefaulted_GetRef();
+		Request->UserIndex = UserIndex;
+	}
+
+	// request not captured yet is superseded by other SaveGame object, its callers get their SaveGame back untouched
+	UFlowSaveGame* SupersededSaveGame = nullptr;
+	TArray<FFlowSaveGameCompleted> SupersededCallbacks;
+	if (Request->SaveGame && Request->SaveGame != SaveGame)
+	{
+		SupersededSaveGame = Request->SaveGame;
+		SupersededCallbacks = MoveTemp(Request->CompletedCallbacks);
+		Request->CompletedCallbacks.Reset();
+		Request->CapturedCallbacks.Reset();
+	}
+
+	Request->SaveGame = SaveGame;
+	if (OnCaptured.IsBound())
+	{
+		Request->CapturedCallbacks.Add(OnCaptured);
+	}
+	if (OnCompleted.IsBound())
+	{
+		Request->CompletedCallbacks.Add(OnCompleted);
+	}
+
+	// snapshot is taken once per frame, after all requests of this frame have been made
+	if (!SaveGameTickHandle.IsValid())
+	{
+		SaveGameTickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UFlowSubsystem::TickSaveGameRequests));
+	}
+
+	// called last, as callbacks might request saving again
+	for (const FFlowSaveGameCompleted& Callback : SupersededCallbacks)
+	{
+		Callback.ExecuteIfBound(SupersededSaveGame, EFlowSaveGameResult::Superseded);
+	}
+}
+
+UFlowSaveGame* UFlowSubsystem::GetPendingSaveGame(const FString& SlotName, const int32 UserIndex) const
+{
+	const FFlowSaveGameRequest* Request = PendingSaveRequests.FindByPredicate([&SlotName, UserIndex](const FFlowSaveGameRequest& PendingRequest)
+	{
+		return PendingRequest.UserIndex == UserIndex && PendingRequest.SaveGame->SaveSlotName == SlotName;
+	});
+
+	return Request ? Request->SaveGame : nullptr;
+}
+
+void UFlowSubsystem::FlushSaveGameWrites()
+{
+	// completing the write doesn't start the next one, so each pending request is captured and written here
+	while (SaveGameWriteTask.IsValid() || PendingSaveRequests.Num() > 0)
+	{
+		if (SaveGameWriteTask.IsValid())
+		{
+			OnSaveGameWritten(SaveGameWriteTask.Get());
+		}
+		else
+		{
+			StartSaveGameWrite();
+		}
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(SaveGameTickHandle);
+	SaveGameTickHandle.Reset();
+}
+
+bool UFlowSubsystem::TickSaveGameRequests(float DeltaTime)
+{
+	if (InFlightSaveGame == nullptr && PendingSaveRequests.Num() > 0)
+	{
+		StartSaveGameWrite();
+	}
+
+	if (PendingSaveRequests.Num() > 0)
+	{
+		return true;
+	}
+
+	SaveGameTickHandle.Reset();
+	return false;
+}
+
+void UFlowSubsystem::StartSaveGameWrite()
+{
+	FFlowSaveGameRequest Request = PendingSaveRequests[0];
+	PendingSaveRequests.RemoveAt(0);
+
+	InFlightSaveGame = Request.SaveGame;
+	InFlightSaveCallbacks = MoveTemp(Request.CompletedCallbacks);
+
+	// snapshot phase, only this part needs to access Flow objects
+	OnGameSaved(InFlightSaveGame);
+
+	for (const FFlowSaveGameCaptured& Callback : Request.CapturedCallbacks)
+	{
+		Callback.ExecuteIfBound(InFlightSaveGame);
+	}
+
+	// serializing SaveGame object has to happen on the game thread, but records are already serialized by the snapshot
+	TSharedRef<TArray<uint8>> SaveData = MakeShared<TArray<uint8>>();
+	TSharedRef<TArray<uint8>> DataToCompress = MakeShared<TArray<uint8>>();
+	const bool bCompress = UFlowSettings::Get()->bCompressSaveGames;
+	bool bSerialized;
+	if (bCompress)
+	{
+		// written as empty SaveGame of the same class followed by compressed data of the captured one, see UFlowSaveGame::Serialize
+		// this way compressed save is still loaded by UGameplayStatics::LoadGameFromSlot
+		UFlowSaveGame* CompressedSaveGame = NewObject<UFlowSaveGame>(GetTransientPackage(), InFlightSaveGame->GetClass());
+		CompressedSaveGame->bHasCompressedData = true;
+		bSerialized = UGameplayStatics::SaveGameToMemory(CompressedSaveGame, *SaveData);
+
+		FMemoryWriter MemoryWriter(*DataToCompress, true);
+		FObjectAndNameAsStringProxyArchive Ar(MemoryWriter, false);
+		InFlightSaveGame->Serialize(Ar);
+	}
+	else
+	{
+		bSerialized = UGameplayStatics::SaveGameToMemory(InFlightSaveGame, *SaveData);
+	}
+
+	if (!bSerialized)
+	{
+		UE_LOG(LogFlow, Error, TEXT("Failed to serialize SaveGame %s"), *InFlightSaveGame->SaveSlotName);
+		OnSaveGameWritten(false);
+		return;
+	}
+
+	const FString SlotName = InFlightSaveGame->SaveSlotName;
+	const int32 UserIndex = Request.UserIndex;
+	const uint32 WriteSerial = ++SaveGameWriteSerial;
+	TWeakObjectPtr<UFlowSubsystem> WeakThis(this);
+
+	SaveGameWriteTask = Async(EAsyncExecution::ThreadPool, [SaveData, DataToCompress, SlotName, UserIndex, bCompress, WriteSerial, WeakThis]()
+	{
+		bool bSuccess = true;
+		if (bCompress)
+		{
+			TArray<uint8> CompressedData;
+			bSuccess = FFlowSaveSerializer::CompressSaveData(*DataToCompress, CompressedData);
+
+			FMemoryWriter MemoryWriter(*SaveData, true);
+			MemoryWriter.Seek(SaveData->Num());
+			MemoryWriter << CompressedData;
+		}
+
+		bSuccess = bSuccess && UGameplayStatics::SaveDataToSlot(*SaveData, SlotName, UserIndex);
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, WriteSerial, bSuccess]()
+		{
+			if (UFlowSubsystem* FlowSubsystem = WeakThis.Get())
+			{
+				// this write might have been already completed by FlushSaveGameWrites
+				if (FlowSubsystem->SaveGameWriteTask.IsValid() && FlowSubsystem->SaveGameWriteSerial == WriteSerial)
+				{
+					FlowSubsystem->OnSaveGameWritten(bSuccess);
+				}
+			}
+		});
+
+		return bSuccess;
+	});
+}
+
+void UFlowSubsystem::OnSaveGameWritten(const bool bSuccess)
+{
+	SaveGameWriteTask.Reset();
+
+	UFlowSaveGame* WrittenSaveGame = InFlightSaveGame;
+	const TArray<FFlowSaveGameCompleted> Callbacks = MoveTemp(InFlightSaveCallbacks);
+
+	InFlightSaveGame = nullptr;
+	InFlightSaveCallbacks.Reset();
+
+	if (!bSuccess && WrittenSaveGame)
+	{
+		UE_LOG(LogFlow, Error, TEXT("Failed to write SaveGame to slot %s"), *WrittenSaveGame->SaveSlotName);
+	}
+
+	for (const FFlowSaveGameCompleted& Callback : Callbacks)
+	{
+		Callback.ExecuteIfBound(WrittenSaveGame, bSuccess ? EFlowSaveGameResult::Saved : EFlowSaveGameResult::Failed);
+	}
+}
+
+FFlowSaveTable* UFlowSubsystem::GetSaveTableForSaving()
+{
+	return (SavingGame && UFlowSettings::Get()->bUseCompactSaveArchive) ? &SaveTable : nullptr;
+}
+
+uint32 UFlowSubsystem::GetSaveTableSerialForSaving() const
+{
+	return (SavingGame && UFlowSettings::Get()->bUseCompactSaveArchive) ? SaveTable.GetSerialNumber() : 0;
+}
+
+FFlowSaveTable* UFlowSubsystem::GetSaveTableForLoading() const
+{
+	return LoadedSaveGame ? &LoadedSaveGame->SaveTable : nullptr;
+}
+
+void UFlowSubsystem::BuildLoadedRecordIndices()
+{
+	LoadedAssetRecordIndices.Reset();
+	LoadedComponentRecordIndices.Reset();
+
+	if (LoadedSaveGame)
+	{
+		LoadedAssetRecordIndices.Reserve(LoadedSaveGame->FlowInstances.Num());
+		for (int32 Index = 0; Index < LoadedSaveGame->FlowInstances.Num(); ++Index)
+		{
+			LoadedAssetRecordIndices.Add(LoadedSaveGame->FlowInstances[Index].InstanceName, Index);
+		}
+
+		LoadedComponentRecordIndices.Reserve(LoadedSaveGame->FlowComponents.Num());
+		for (int32 Index = 0; Index < LoadedSaveGame->FlowComponents.Num(); ++Index)
+		{
+			LoadedComponentRecordIndices.Add(LoadedSaveGame->FlowComponents[Index].ActorInstanceName, Index);
+		}
+	}
+}
+
+void UFlowSubsystem::RegisterComponent(UFlowComponent* Component)
+{
+	for (const FGameplayTag& Tag : Component->IdentityTags)
+	{
+		if (Tag.IsValid())
+		{
+			AddToRegistry(Component, Tag);
+		}
+	}
+
+	OnComponentRegistered.Broadcast(Component);
+	NotifyComponentRegistered(Component, Component->IdentityTags);
+}
+
+void UFlowSubsystem::OnIdentityTagAdded(UFlowComponent* Component, const FGameplayTag& AddedTag)
+{
+	AddToRegistry(Component, AddedTag);
+
+	// broadcast OnComponentRegistered only if this component wasn't present in the registry previously
+	if (Component->IdentityTags.Num() > 1)
+	{
+		OnComponentTagAdded.Broadcast(Component, FGameplayTagContainer(AddedTag));
+		NotifyComponentTagAdded(Component, FGameplayTagContainer(AddedTag));
+	}
+	else
+	{
+		OnComponentRegistered.Broadcast(Component);
+		NotifyComponentRegistered(Component, FGameplayTagContainer(AddedTag));
+	}
+}
+
+void UFlowSubsystem::OnIdentityTagsAdded(UFlowComponent* Component, const FGameplayTagContainer& AddedTags)
+{
+	for (const FGameplayTag& Tag : AddedTags)
+	{
+		AddToRegistry(Component, Tag);
+	}
+
+	// broadcast OnComponentRegistered only if this component wasn't present in the registry previously
+	if (Component->IdentityTags.Num() > AddedTags.Num())
+	{
+		OnComponentTagAdded.Broadcast(Component, AddedTags);
+		NotifyComponentTagAdded(Component, AddedTags);
+	}
+	else
+	{
+		OnComponentRegistered.Broadcast(Component);
+		NotifyComponentRegistered(Component, AddedTags);
+	}
+}
+
+void UFlowSubsystem::UnregisterComponent(UFlowComponent* Component)
+{
+	for (const FGameplayTag& Tag : Component->IdentityTags)
+	{
+		if (Tag.IsValid())
+		{
+			RemoveFromRegistry(Component, Tag);
+		}
+	}
+
+	OnComponentUnregistered.Broadcast(Component);
+	NotifyComponentUnregistered(Component, Component->IdentityTags);
+}
+
+void UFlowSubsystem::OnIdentityTagRemoved(UFlowComponent* Component, const FGameplayTag& RemovedTag)
+{
+	RemoveFromRegistry(Component, RemovedTag);
+
 	// broadcast OnComponentUnregistered only if this component isn't present in the registry anymore
 	if (Component->IdentityTags.Num() > 0)
 	{
 		OnComponentTagRemoved.Broadcast(Component, FGameplayTagContainer(RemovedTag));
+		NotifyComponentTagRemoved(Component, FGameplayTagContainer(RemovedTag));
 	}
 	else
 	{
 		OnComponentUnregistered.Broadcast(Component);
+		NotifyComponentUnregistered(Component, FGameplayTagContainer(RemovedTag));
 	}
 }
 
@@ -500,169 +1531,361 @@ void UFlowSubsystem::OnIdentityTagsRemoved(UFlowComponent* Component, const FGam
 {
 	for (const FGameplayTag& Tag : RemovedTags)
 	{
-		FlowComponentRegistry.Remove(Tag, Component);
+		RemoveFromRegistry(Component, Tag);
 	}
 
 	// broadcast OnComponentUnregistered only if this component isn't present in the registry anymore
 	if (Component->IdentityTags.Num() > 0)
 	{
 		OnComponentTagRemoved.Broadcast(Component, RemovedTags);
+		NotifyComponentTagRemoved(Component, RemovedTags);
 	}
 	else
 	{
 		OnComponentUnregistered.Broadcast(Component);
+		NotifyComponentUnregistered(Component, RemovedTags);
 	}
 }
 
-TSet<UFlowComponent*> UFlowSubsystem::GetFlowComponentsByTag(const FGameplayTag Tag, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch) const
+void UFlowSubsystem::AddToRegistry(UFlowComponent* Component, const FGameplayTag& Tag)
 {
-	TArray<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-	FindComponents(Tag, bExactMatch, FoundComponents);
+	FlowComponentRegistry.Emplace(Tag, Component);
 
-	TSet<UFlowComponent*> Result;
-	for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+	for (FGameplayTag HierarchyTag = Tag; HierarchyTag.IsValid(); HierarchyTag = HierarchyTag.RequestDirectParent())
+	{
+		FlowComponentHierarchyRegistry.FindOrAdd(HierarchyTag).FindOrAdd(Component)++;
+	}
+}
+
+void UFlowSubsystem::RemoveFromRegistry(UFlowComponent* Component, const FGameplayTag& Tag)
+{
+	FlowComponentRegistry.Remove(Tag, Component);
+
+	for (FGameplayTag HierarchyTag = Tag; HierarchyTag.IsValid(); HierarchyTag = HierarchyTag.RequestDirectParent())
+	{
+		if (TMap<TWeakObjectPtr<UFlowComponent>, int32>* Components = FlowComponentHierarchyRegistry.Find(HierarchyTag))
+		{
+			int32* TagCount = Components->Find(Component);
+			if (TagCount && --(*TagCount) <= 0)
+			{
+				Components->Remove(Component);
+				if (Components->Num() == 0)
+				{
+					FlowComponentHierarchyRegistry.Remove(HierarchyTag);
+				}
+			}
+		}
+	}
+}
+
+FDelegateHandle UFlowSubsystem::AddComponentObserver(const FGameplayTagContainer& IdentityTags, const bool bExactMatch, FFlowComponentObserverCallbacks&& Callbacks)
+{
+	const FDelegateHandle ObserverHandle(FDelegateHandle::GenerateNewHandle);
+
+	FComponentObserver& Observer = ComponentObservers.Add(ObserverHandle);
+	Observer.IdentityTags = IdentityTags;
+	Observer.bExactMatch = bExactMatch;
+	Observer.Callbacks = MoveTemp(Callbacks);
+
+	for (const FGameplayTag& Tag : IdentityTags)
+	{
+		ComponentObserversByTag.Add(Tag, ObserverHandle);
+	}
+
+	return ObserverHandle;
+}
+
+void UFlowSubsystem::RemoveComponentObserver(FDelegateHandle& ObserverHandle)
+{
+	if (const FComponentObserver* Observer = ComponentObservers.Find(ObserverHandle))
+	{
+		for (const FGameplayTag& Tag : Observer->IdentityTags)
+		{
+			ComponentObserversByTag.RemoveSingle(Tag, ObserverHandle);
+		}
+
+		ComponentObservers.Remove(ObserverHandle);
+	}
+
+	ObserverHandle.Reset();
+}
+
+void UFlowSubsystem::FindComponentObservers(const FGameplayTagContainer& ComponentTags, const FGameplayTagContainer& ChangedTags, TArray<FDelegateHandle, TInlineAllocator<16>>& OutObservers) const
+{
+	if (ComponentObservers.Num() == 0)
+	{
+		return;
+	}
+
+	auto CollectObservers = [this, &OutObservers](const FGameplayTagContainer& Tags)
+	{
+		for (const FGameplayTag& ComponentTag : Tags)
+		{
+			// observer using non-exact match is also interested in components with child tags of its tag
+			for (FGameplayTag Tag = ComponentTag; Tag.IsValid(); Tag = Tag.RequestDirectParent())
+			{
+				for (TMultiMap<FGameplayTag, FDelegateHandle>::TConstKeyIterator It(ComponentObserversByTag, Tag); It; ++It)
+				{
+					const FComponentObserver& Observer = ComponentObservers.FindChecked(It.Value());
+					if (Tag == ComponentTag || !Observer.bExactMatch)
+					{
+						OutObservers.AddUnique(It.Value());
+					}
+				}
+			}
+		}
+	};
+
+	CollectObservers(ComponentTags);
+	CollectObservers(ChangedTags);
+}
+
+void UFlowSubsystem::NotifyComponentRegistered(UFlowComponent* Component, const FGameplayTagContainer& AddedTags)
+{
+	TArray<FDelegateHandle, TInlineAllocator<16>> Observers;
+	FindComponentObservers(Component->IdentityTags, AddedTags, Observers);
+
+	for (const FDelegateHandle& ObserverHandle : Observers)
+	{
+		// observer might be removed by the previously called observer
+		if (const FComponentObserver* Observer = ComponentObservers.Find(ObserverHandle))
+		{
+			Observer->Callbacks.OnComponentRegistered.ExecuteIfBound(Component);
+		}
+	}
+}
+
+void UFlowSubsystem::NotifyComponentTagAdded(UFlowComponent* Component, const FGameplayTagContainer& AddedTags)
+{
+	TArray<FDelegateHandle, TInlineAllocator<16>> Observers;
+	FindComponentObservers(Component->IdentityTags, AddedTags, Observers);
+
+	for (const FDelegateHandle& ObserverHandle : Observers)
+	{
+		if (const FComponentObserver* Observer = ComponentObservers.Find(ObserverHandle))
+		{
+			Observer->Callbacks.OnComponentTagAdded.ExecuteIfBound(Component, AddedTags);
+		}
+	}
+}
+
+void UFlowSubsystem::NotifyComponentTagRemoved(UFlowComponent* Component, const FGameplayTagContainer& RemovedTags)
+{
+	TArray<FDelegateHandle, TInlineAllocator<16>> Observers;
+	FindComponentObservers(Component->IdentityTags, RemovedTags, Observers);
+
+	for (const FDelegateHandle& ObserverHandle : Observers)
+	{
+		if (const FComponentObserver* Observer = ComponentObservers.Find(ObserverHandle))
+		{
+			Observer->Callbacks.OnComponentTagRemoved.ExecuteIfBound(Component, RemovedTags);
+		}
+	}
+}
+
+void UFlowSubsystem::NotifyComponentUnregistered(UFlowComponent* Component, const FGameplayTagContainer& RemovedTags)
+{
+	TArray<FDelegateHandle, TInlineAllocator<16>> Observers;
+	FindComponentObservers(Component->IdentityTags, RemovedTags, Observers);
+
+	for (const FDelegateHandle& ObserverHandle : Observers)
 	{
-		if (Component.IsValid() && Component->GetClass()->IsChildOf(ComponentClass))
+		if (const FComponentObserver* Observer = ComponentObservers.Find(ObserverHandle))
 		{
-			Result.Emplace(Component.Get());
+			Observer->Callbacks.OnComponentUnregistered.ExecuteIfBound(Component);
 		}
 	}
+}
+
+TSet<UFlowComponent*> UFlowSubsystem::GetFlowComponentsByTag(const FGameplayTag Tag, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch) const
+{
+	TSet<UFlowComponent*> Result;
+	VisitComponents(Tag, bExactMatch, [&Result, &ComponentClass](UFlowComponent* Component)
+	{
+		if (Component->GetClass()->IsChildOf(ComponentClass))
+		{
+			Result.Emplace(Component);
+		}
+		return true;
+	});
 
 	return Result;
 }
 
 TSet<UFlowComponent*> UFlowSubsystem::GetFlowComponentsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch) const
 {
-	TSet<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-	FindComponents(Tags, MatchType, bExactMatch, FoundComponents);
-
 	TSet<UFlowComponent*> Result;
-	for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+	VisitComponents(Tags, MatchType, bExactMatch, [&Result, &ComponentClass](UFlowComponent* Component)
 	{
-		if (Component.IsValid() && Component->GetClass()->IsChildOf(ComponentClass))
+		if (Component->GetClass()->IsChildOf(ComponentClass))
 		{
-			Result.Emplace(Component.Get());
+			Result.Emplace(Component);
 		}
-	}
+		return true;
+	});
 
 	return Result;
 }
 
 TSet<AActor*> UFlowSubsystem::GetFlowActorsByTag(const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
 {
-	TArray<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-	FindComponents(Tag, bExactMatch, FoundComponents);
-
 	TSet<AActor*> Result;
-	for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+	VisitComponents(Tag, bExactMatch, [&Result, &ActorClass](UFlowComponent* Component)
 	{
-		if (Component.IsValid() && Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
+		if (Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
 		{
 			Result.Emplace(Component->GetOwner());
 		}
-	}
+		return true;
+	});
 
 	return Result;
 }
 
 TSet<AActor*> UFlowSubsystem::GetFlowActorsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
 {
-	TSet<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-	FindComponents(Tags, MatchType, bExactMatch, FoundComponents);
-
 	TSet<AActor*> Result;
-	for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+	VisitComponents(Tags, MatchType, bExactMatch, [&Result, &ActorClass](UFlowComponent* Component)
 	{
-		if (Component.IsValid() && Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
+		if (Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
 		{
 			Result.Emplace(Component->GetOwner());
 		}
-	}
+		return true;
+	});
 
 	return Result;
 }
 
 TMap<AActor*, UFlowComponent*> UFlowSubsystem::GetFlowActorsAndComponentsByTag(const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
 {
-	TArray<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-	FindComponents(Tag, bExactMatch, FoundComponents);
-
 	TMap<AActor*, UFlowComponent*> Result;
-	for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+	VisitComponents(Tag, bExactMatch, [&Result, &ActorClass](UFlowComponent* Component)
 	{
-		if (Component.IsValid() && Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
+		if (Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
 		{
-			Result.Emplace(Component->GetOwner(), Component.Get());
+			Result.Emplace(Component->GetOwner(), Component);
 		}
-	}
+		return true;
+	});
 
 	return Result;
 }
 
 TMap<AActor*, UFlowComponent*> UFlowSubsystem::GetFlowActorsAndComponentsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch) const
 {
-	TSet<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-	FindComponents(Tags, MatchType, bExactMatch, FoundComponents);
-
 	TMap<AActor*, UFlowComponent*> Result;
-	for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+	VisitComponents(Tags, MatchType, bExactMatch, [&Result, &ActorClass](UFlowComponent* Component)
 	{
-		if (Component.IsValid() && Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
+		if (Component->GetOwner()->GetClass()->IsChildOf(ActorClass))
 		{
-			Result.Emplace(Component->GetOwner(), Component.Get());
+			Result.Emplace(Component->GetOwner(), Component);
 		}
-	}
+		return true;
+	});
 
 	return Result;
 }
 
-void UFlowSubsystem::FindComponents(const FGameplayTag& Tag, const bool bExactMatch, TArray<TWeakObjectPtr<UFlowComponent>>& OutComponents) const
+bool UFlowSubsystem::VisitComponents(const FGameplayTag& Tag, const bool bExactMatch, TFunctionRef<bool(UFlowComponent*)> Visitor) const
 {
 	if (bExactMatch)
 	{
-		FlowComponentRegistry.MultiFind(Tag, OutComponents);
+		for (TMultiMap<FGameplayTag, TWeakObjectPtr<UFlowComponent>>::TConstKeyIterator It(FlowComponentRegistry, Tag); It; ++It)
+		{
+			if (UFlowComponent* Component = It.Value().Get())
+			{
+				if (!Visitor(Component))
+				{
+					return false;
+				}
+			}
+		}
 	}
-	else
+	else if (const TMap<TWeakObjectPtr<UFlowComponent>, int32>* Components = FlowComponentHierarchyRegistry.Find(Tag))
 	{
-		for (TMultiMap<FGameplayTag, TWeakObjectPtr<UFlowComponent>>::TConstIterator It(FlowComponentRegistry); It; ++It)
+		for (const TPair<TWeakObjectPtr<UFlowComponent>, int32>& Pair : *Components)
 		{
-			if (It.Key().MatchesTag(Tag))
+			if (UFlowComponent* Component = Pair.Key.Get())
 			{
-				OutComponents.Emplace(It.Value());
+				if (!Visitor(Component))
+				{
+					return false;
+				}
 			}
 		}
 	}
+
+	return true;
 }
 
-void UFlowSubsystem::FindComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TSet<TWeakObjectPtr<UFlowComponent>>& OutComponents) const
+bool UFlowSubsystem::VisitComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TFunctionRef<bool(UFlowComponent*)> Visitor) const
 {
+	const TArray<FGameplayTag>& TagArray = Tags.GetGameplayTagArray();
+
 	if (MatchType == EGameplayContainerMatchType::Any)
 	{
-		for (const FGameplayTag& Tag : Tags)
+		for (int32 TagIndex = 0; TagIndex < TagArray.Num(); ++TagIndex)
 		{
-			TArray<TWeakObjectPtr<UFlowComponent>> ComponentsPerTag;
-			FindComponents(Tag, bExactMatch, ComponentsPerTag);
-			OutComponents.Append(ComponentsPerTag);
+			const bool bContinue = VisitComponents(TagArray[TagIndex], bExactMatch, [&](UFlowComponent* Component)
+			{
+				// skip components already visited while iterating previous tags
+				for (int32 PreviousIndex = 0; PreviousIndex < TagIndex; ++PreviousIndex)
+				{
+					if (bExactMatch ? Component->IdentityTags.HasTagExact(TagArray[PreviousIndex]) : Component->IdentityTags.HasTag(TagArray[PreviousIndex]))
+					{
+						return true;
+					}
+				}
+				return Visitor(Component);
+			});
+
+			if (!bContinue)
+			{
+				return false;
+			}
 		}
 	}
-	else // EGameplayContainerMatchType::All
+	else if (TagArray.Num() > 0) // EGameplayContainerMatchType::All
 	{
-		TSet<TWeakObjectPtr<UFlowComponent>> ComponentsWithAnyTag;
-		for (const FGameplayTag& Tag : Tags)
+		// iterate over the smallest set of candidates
+		int32 SmallestIndex = 0;
+		int32 SmallestNum = GetRegisteredComponentsNum(TagArray[0], bExactMatch);
+		for (int32 TagIndex = 1; TagIndex < TagArray.Num() && SmallestNum > 0; ++TagIndex)
 		{
-			TArray<TWeakObjectPtr<UFlowComponent>> ComponentsPerTag;
-			FindComponents(Tag, bExactMatch, ComponentsPerTag);
-			ComponentsWithAnyTag.Append(ComponentsPerTag);
+			const int32 ComponentsNum = GetRegisteredComponentsNum(TagArray[TagIndex], bExactMatch);
+			if (ComponentsNum < SmallestNum)
+			{
+				SmallestIndex = TagIndex;
+				SmallestNum = ComponentsNum;
+			}
 		}
 
-		for (const TWeakObjectPtr<UFlowComponent>& Component : ComponentsWithAnyTag)
+		if (SmallestNum > 0)
 		{
-			if (Component.IsValid() && Component->IdentityTags.HasAllExact(Tags))
+			return VisitComponents(TagArray[SmallestIndex], bExactMatch, [&](UFlowComponent* Component)
 			{
-				OutComponents.Emplace(Component);
-			}
+				if (bExactMatch ? Component->IdentityTags.HasAllExact(Tags) : Component->IdentityTags.HasAll(Tags))
+				{
+					return Visitor(Component);
+				}
+				return true;
+			});
 		}
 	}
+
+	return true;
+}
+
+int32 UFlowSubsystem::GetRegisteredComponentsNum(const FGameplayTag& Tag, const bool bExactMatch) const
+{
+	if (bExactMatch)
+	{
+		return FlowComponentRegistry.Num(Tag);
+	}
+
+	const TMap<TWeakObjectPtr<UFlowComponent>, int32>* Components = FlowComponentHierarchyRegistry.Find(Tag);
+	return Components ? Components->Num() : 0;
 }
 
 #undef LOCTEXT_NAMESPACE
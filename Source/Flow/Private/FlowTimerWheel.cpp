@@ -0,0 +1,273 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTimerWheel.h"
+
+FFlowTimerWheel::FFlowTimerWheel(const double InTickInterval)
+	: TickInterval(InTickInterval)
+	, Time(0.0)
+	, CurrentTick(0)
+	, NextSerial(1)
+	, NextSequence(0)
+{
+	check(TickInterval > 0.0);
+}
+
+void FFlowTimerWheel::SetTimer(FFlowTimerHandle& InOutHandle, FFlowTimerDelegate&& Delegate, const float Rate, const bool bLoop, const float FirstDelay)
+{
+	ClearTimer(InOutHandle);
+
+	if (Rate > 0.0f)
+	{
+		const float Delay = FirstDelay >= 0.0f ? FirstDelay : Rate;
+		InOutHandle = AddTimer(MoveTemp(Delegate), Time + Delay, Rate, bLoop);
+	}
+}
+
+void FFlowTimerWheel::SetTimerForNextTick(FFlowTimerHandle& InOutHandle, FFlowTimerDelegate&& Delegate)
+{
+	ClearTimer(InOutHandle);
+	InOutHandle = AddTimer(MoveTemp(Delegate), Time, 0.0f, false);
+}
+
+void FFlowTimerWheel::ClearTimer(FFlowTimerHandle& InOutHandle)
+{
+	// handle stays in its slot until the slot is processed
+	if (FindTimer(InOutHandle))
+	{
+		Timers.RemoveAt(InOutHandle.Index);
+	}
+
+	InOutHandle.Invalidate();
+}
+
+float FFlowTimerWheel::GetTimerRemaining(const FFlowTimerHandle& Handle) const
+{
+	const FTimer* Timer = FindTimer(Handle);
+	return Timer ? static_cast<float>(FMath::Max(Timer->ExpireTime - Time, 0.0)) : -1.0f;
+}
+
+float FFlowTimerWheel::GetTimerElapsed(const FFlowTimerHandle& Handle) const
+{
+	const FTimer* Timer = FindTimer(Handle);
+	return Timer ? FMath::Max(Timer->Rate - static_cast<float>(Timer->ExpireTime - Time), 0.0f) : -1.0f;
+}
+
+void FFlowTimerWheel::Advance(const double DeltaTime)
+{
+	Time += FMath::Max(DeltaTime, 0.0);
+	const int64 TargetTick = GetTick(Time);
+
+	if (TargetTick - CurrentTick > SlotsPerLevel * SlotsPerLevel)
+	{
+		// stepping through thousands of ticks after a long hitch would cost more than rebuilding the wheel
+		TArray<FFlowTimerHandle> AllHandles;
+		AllHandles.Reserve(Timers.Num());
+		for (TArray<FFlowTimerHandle>(&LevelSlots)[SlotsPerLevel] : Slots)
+		{
+			for (TArray<FFlowTimerHandle>& Slot : LevelSlots)
+			{
+				AllHandles.Append(MoveTemp(Slot));
+				Slot.Reset();
+			}
+		}
+		AllHandles.Append(MoveTemp(Overflow));
+		Overflow.Reset();
+
+		CurrentTick = TargetTick;
+		Reschedule(AllHandles);
+	}
+
+	while (true)
+	{
+		TArray<FFlowTimerHandle> SlotHandles = MoveTemp(Slots[0][CurrentTick & SlotMask]);
+		Slots[0][CurrentTick & SlotMask].Reset();
+
+		for (const FFlowTimerHandle& Handle : SlotHandles)
+		{
+			if (const FTimer* Timer = FindTimer(Handle))
+			{
+				if (Timer->ExpireTime <= Time)
+				{
+					ExpiredTimers.Add(Handle);
+				}
+				else
+				{
+					// expires later within the current tick
+					Slots[0][CurrentTick & SlotMask].Add(Handle);
+				}
+			}
+		}
+
+		if (CurrentTick >= TargetTick)
+		{
+			break;
+		}
+
+		CurrentTick++;
+		CascadeLevels();
+	}
+
+	FireExpiredTimers();
+}
+
+void FFlowTimerWheel::Reset()
+{
+	Timers.Empty();
+	for (TArray<FFlowTimerHandle>(&LevelSlots)[SlotsPerLevel] : Slots)
+	{
+		for (TArray<FFlowTimerHandle>& Slot : LevelSlots)
+		{
+			Slot.Empty();
+		}
+	}
+	Overflow.Empty();
+	ExpiredTimers.Empty();
+
+	Time = 0.0;
+	CurrentTick = 0;
+}
+
+const FFlowTimerWheel::FTimer* FFlowTimerWheel::FindTimer(const FFlowTimerHandle& Handle) const
+{
+	if (Handle.IsValid() && Timers.IsValidIndex(Handle.Index) && Timers[Handle.Index].Serial == Handle.Serial)
+	{
+		return &Timers[Handle.Index];
+	}
+
+	return nullptr;
+}
+
+FFlowTimerWheel::FTimer* FFlowTimerWheel::FindTimer(const FFlowTimerHandle& Handle)
+{
+	return const_cast<FTimer*>(static_cast<const FFlowTimerWheel*>(this)->FindTimer(Handle));
+}
+
+FFlowTimerHandle FFlowTimerWheel::AddTimer(FFlowTimerDelegate&& Delegate, const double ExpireTime, const float Rate, const bool bLoop)
+{
+	FTimer NewTimer;
+	NewTimer.Delegate = MoveTemp(Delegate);
+	NewTimer.ExpireTime = ExpireTime;
+	NewTimer.Rate = Rate;
+	NewTimer.bLoop = bLoop;
+	NewTimer.Serial = NextSerial;
+	NewTimer.Sequence = NextSequence++;
+
+	// serial 0 marks invalid handles
+	NextSerial = NextSerial == MAX_uint32 ? 1 : NextSerial + 1;
+
+	FFlowTimerHandle Handle;
+	Handle.Index = Timers.Add(MoveTemp(NewTimer));
+	Handle.Serial = Timers[Handle.Index].Serial;
+
+	Schedule(Handle, ExpireTime);
+	return Handle;
+}
+
+void FFlowTimerWheel::Schedule(const FFlowTimerHandle& Handle, const double ExpireTime)
+{
+	const int64 ExpireTick = FMath::Max(GetTick(ExpireTime), CurrentTick);
+	const int64 TicksLeft = ExpireTick - CurrentTick;
+
+	for (int32 Level = 0; Level < LevelsNum; Level++)
+	{
+		if (TicksLeft < (int64(1) << (SlotBits * (Level + 1))))
+		{
+			Slots[Level][(ExpireTick >> (SlotBits * Level)) & SlotMask].Add(Handle);
+			return;
+		}
+	}
+
+	Overflow.Add(Handle);
+}
+
+void FFlowTimerWheel::Reschedule(TArray<FFlowTimerHandle>& Handles)
+{
+	for (const FFlowTimerHandle& Handle : Handles)
+	{
+		if (const FTimer* Timer = FindTimer(Handle))
+		{
+			Schedule(Handle, Timer->ExpireTime);
+		}
+	}
+}
+
+void FFlowTimerWheel::CascadeLevels()
+{
+	// move timers of the block that just started into lower levels
+	for (int32 Level = 1; Level < LevelsNum; Level++)
+	{
+		if ((CurrentTick & ((int64(1) << (SlotBits * Level)) - 1)) != 0)
+		{
+			return;
+		}
+
+		TArray<FFlowTimerHandle>& Slot = Slots[Level][(CurrentTick >> (SlotBits * Level)) & SlotMask];
+		TArray<FFlowTimerHandle> SlotHandles = MoveTemp(Slot);
+		Slot.Reset();
+		Reschedule(SlotHandles);
+	}
+
+	if ((CurrentTick & ((int64(1) << (SlotBits * LevelsNum)) - 1)) == 0)
+	{
+		TArray<FFlowTimerHandle> OverflowHandles = MoveTemp(Overflow);
+		Overflow.Reset();
+		Reschedule(OverflowHandles);
+	}
+}
+
+void FFlowTimerWheel::FireExpiredTimers()
+{
+	if (ExpiredTimers.IsEmpty())
+	{
+		return;
+	}
+
+	ExpiredTimers.Sort([this](const FFlowTimerHandle& A, const FFlowTimerHandle& B)
+	{
+		const FTimer& TimerA = Timers[A.Index];
+		const FTimer& TimerB = Timers[B.Index];
+		return TimerA.ExpireTime == TimerB.ExpireTime ? TimerA.Sequence < TimerB.Sequence : TimerA.ExpireTime < TimerB.ExpireTime;
+	});
+
+	// timers set by fired delegates are processed on the next Advance()
+	TArray<FFlowTimerHandle> TimersToFire = MoveTemp(ExpiredTimers);
+	ExpiredTimers.Reset();
+
+	for (const FFlowTimerHandle& Handle : TimersToFire)
+	{
+		FTimer* Timer = FindTimer(Handle);
+		if (Timer == nullptr)
+		{
+			// cleared by previously fired timer
+			continue;
+		}
+
+		if (Timer->bLoop)
+		{
+			// fire once for every interval passed, same as the world timer manager does
+			const int32 CallCount = 1 + FMath::FloorToInt32((Time - Timer->ExpireTime) / Timer->Rate);
+			Timer->ExpireTime += static_cast<double>(CallCount) * Timer->Rate;
+			Schedule(Handle, Timer->ExpireTime);
+
+			const FFlowTimerDelegate Delegate = Timer->Delegate;
+			for (int32 CallIndex = 0; CallIndex < CallCount && FindTimer(Handle); CallIndex++)
+			{
+				Delegate.ExecuteIfBound();
+			}
+		}
+		else
+		{
+			const FFlowTimerDelegate Delegate = MoveTemp(Timer->Delegate);
+			Timers.RemoveAt(Handle.Index);
+
+			Delegate.ExecuteIfBound();
+		}
+	}
+
+	// reuse allocation
+	if (ExpiredTimers.IsEmpty())
+	{
+		ExpiredTimers = MoveTemp(TimersToFire);
+		ExpiredTimers.Reset();
+	}
+}
@@ -0,0 +1,195 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTrace.h"
+
+#if FLOW_TRACE_ENABLED
+
+#include "FlowAsset.h"
+#include "Nodes/FlowNode.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+#include "ProfilingDebugging/TraceAuxiliary.h"
+#include "UObject/ObjectKey.h"
+
+UE_TRACE_CHANNEL_DEFINE(FlowChannel)
+
+UE_TRACE_EVENT_BEGIN(Flow, AssetSpec, NoSync | Important)
+	UE_TRACE_EVENT_FIELD(uint32, AssetId)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Path)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Flow, InstanceCreated)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, InstanceId)
+	UE_TRACE_EVENT_FIELD(uint32, AssetId)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Flow, InstanceDestroyed)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, InstanceId)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Flow, NodeActivated)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, InstanceId)
+	UE_TRACE_EVENT_FIELD(uint64, NodeGuidHigh)
+	UE_TRACE_EVENT_FIELD(uint64, NodeGuidLow)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Flow, NodeFinished)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, InstanceId)
+	UE_TRACE_EVENT_FIELD(uint64, NodeGuidHigh)
+	UE_TRACE_EVENT_FIELD(uint64, NodeGuidLow)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Flow, PinTriggered)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, InstanceId)
+	UE_TRACE_EVENT_FIELD(uint64, NodeGuidHigh)
+	UE_TRACE_EVENT_FIELD(uint64, NodeGuidLow)
+	UE_TRACE_EVENT_FIELD(uint16, PinIndex)
+	UE_TRACE_EVENT_FIELD(bool, bInputPin)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(Flow, DataPinResolved)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, InstanceId)
+	UE_TRACE_EVENT_FIELD(uint64, NodeGuidHigh)
+	UE_TRACE_EVENT_FIELD(uint64, NodeGuidLow)
+	UE_TRACE_EVENT_FIELD(uint16, PinIndex)
+UE_TRACE_EVENT_END()
+
+namespace FlowTrace
+{
+	uint32 GetInstanceId(const UFlowNode& Node)
+	{
+		const UFlowAsset* FlowAsset = Node.GetFlowAsset();
+		return FlowAsset ? FlowAsset->GetUniqueID() : 0;
+	}
+
+	uint64 GetGuidHigh(const FGuid& Guid)
+	{
+		return (static_cast<uint64>(Guid.A) << 32) | Guid.B;
+	}
+
+	uint64 GetGuidLow(const FGuid& Guid)
+	{
+		return (static_cast<uint64>(Guid.C) << 32) | Guid.D;
+	}
+
+	// identifiers assigned to templates which path has been already sent to the current trace
+	// guarded by the lock, as Flow Asset instances aren't guaranteed to be created on the game thread
+	FCriticalSection TracedAssetsLock;
+	TMap<FObjectKey, uint32> TracedAssets;
+
+	// identifiers aren't reused after clearing TracedAssets, as important events of the previous trace are replayed to new connections
+	uint32 LastAssetId = 0;
+
+	FDelegateHandle TraceStoppedHandle;
+
+	void OnTraceStopped(FTraceAuxiliary::EConnectionType TraceType, const FString& TraceDestination)
+	{
+		FScopeLock Lock(&TracedAssetsLock);
+		TracedAssets.Empty();
+	}
+}
+
+void FFlowTrace::Initialize()
+{
+	FlowTrace::TraceStoppedHandle = FTraceAuxiliary::OnTraceStopped.AddStatic(&FlowTrace::OnTraceStopped);
+}
+
+void FFlowTrace::Shutdown()
+{
+	FTraceAuxiliary::OnTraceStopped.Remove(FlowTrace::TraceStoppedHandle);
+	FlowTrace::TraceStoppedHandle.Reset();
+
+	FScopeLock Lock(&FlowTrace::TracedAssetsLock);
+	FlowTrace::TracedAssets.Empty();
+}
+
+uint32 FFlowTrace::OutputAssetSpec(const UFlowAsset& TemplateAsset)
+{
+	FScopeLock Lock(&FlowTrace::TracedAssetsLock);
+
+	if (const uint32* AssetId = FlowTrace::TracedAssets.Find(&TemplateAsset))
+	{
+		return *AssetId;
+	}
+
+	const uint32 NewAssetId = ++FlowTrace::LastAssetId;
+	FlowTrace::TracedAssets.Add(&TemplateAsset, NewAssetId);
+
+	const FString Path = TemplateAsset.GetPathName();
+	UE_TRACE_LOG(Flow, AssetSpec, FlowChannel)
+		<< AssetSpec.AssetId(NewAssetId)
+		<< AssetSpec.Path(*Path, Path.Len());
+
+	return NewAssetId;
+}
+
+void FFlowTrace::OutputInstanceCreated(const UFlowAsset& Instance)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(FlowChannel))
+	{
+		return;
+	}
+
+	const UFlowAsset* TemplateAsset = Instance.GetTemplateAsset();
+	const uint32 AssetId = TemplateAsset ? OutputAssetSpec(*TemplateAsset) : 0;
+
+	UE_TRACE_LOG(Flow, InstanceCreated, FlowChannel)
+		<< InstanceCreated.Cycle(FPlatformTime::Cycles64())
+		<< InstanceCreated.InstanceId(Instance.GetUniqueID())
+		<< InstanceCreated.AssetId(AssetId);
+}
+
+void FFlowTrace::OutputInstanceDestroyed(const UFlowAsset& Instance)
+{
+	UE_TRACE_LOG(Flow, InstanceDestroyed, FlowChannel)
+		<< InstanceDestroyed.Cycle(FPlatformTime::Cycles64())
+		<< InstanceDestroyed.InstanceId(Instance.GetUniqueID());
+}
+
+void FFlowTrace::OutputNodeActivated(const UFlowNode& Node)
+{
+	UE_TRACE_LOG(Flow, NodeActivated, FlowChannel)
+		<< NodeActivated.Cycle(FPlatformTime::Cycles64())
+		<< NodeActivated.InstanceId(FlowTrace::GetInstanceId(Node))
+		<< NodeActivated.NodeGuidHigh(FlowTrace::GetGuidHigh(Node.GetGuid()))
+		<< NodeActivated.NodeGuidLow(FlowTrace::GetGuidLow(Node.GetGuid()));
+}
+
+void FFlowTrace::OutputNodeFinished(const UFlowNode& Node)
+{
+	UE_TRACE_LOG(Flow, NodeFinished, FlowChannel)
+		<< NodeFinished.Cycle(FPlatformTime::Cycles64())
+		<< NodeFinished.InstanceId(FlowTrace::GetInstanceId(Node))
+		<< NodeFinished.NodeGuidHigh(FlowTrace::GetGuidHigh(Node.GetGuid()))
+		<< NodeFinished.NodeGuidLow(FlowTrace::GetGuidLow(Node.GetGuid()));
+}
+
+void FFlowTrace::OutputPinTriggered(const UFlowNode& Node, const int32 PinIndex, const bool bInputPin)
+{
+	UE_TRACE_LOG(Flow, PinTriggered, FlowChannel)
+		<< PinTriggered.Cycle(FPlatformTime::Cycles64())
+		<< PinTriggered.InstanceId(FlowTrace::GetInstanceId(Node))
+		<< PinTriggered.NodeGuidHigh(FlowTrace::GetGuidHigh(Node.GetGuid()))
+		<< PinTriggered.NodeGuidLow(FlowTrace::GetGuidLow(Node.GetGuid()))
+		<< PinTriggered.PinIndex(static_cast<uint16>(PinIndex))
+		<< PinTriggered.bInputPin(bInputPin);
+}
+
+void FFlowTrace::OutputDataPinResolved(const UFlowNode& Node, const int32 PinIndex)
+{
+	UE_TRACE_LOG(Flow, DataPinResolved, FlowChannel)
+		<< DataPinResolved.Cycle(FPlatformTime::Cycles64())
+		<< DataPinResolved.InstanceId(FlowTrace::GetInstanceId(Node))
+		<< DataPinResolved.NodeGuidHigh(FlowTrace::GetGuidHigh(Node.GetGuid()))
+		<< DataPinResolved.NodeGuidLow(FlowTrace::GetGuidLow(Node.GetGuid()))
+		<< DataPinResolved.PinIndex(static_cast<uint16>(PinIndex));
+}
+
+#endif
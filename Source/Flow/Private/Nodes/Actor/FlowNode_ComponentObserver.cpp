@@ -18,6 +18,8 @@ UFlowNode_ComponentObserver::UFlowNode_ComponentObserver(const FObjectInitialize
 
 	InputPins = {FFlowPin(TEXT("Start")), FFlowPin(TEXT("Stop"))};
 	OutputPins = {FFlowPin(TEXT("Success")), FFlowPin(TEXT("Completed")), FFlowPin(TEXT("Stopped"))};
+
+	SaveRecordReusableClass = StaticClass();
 }
 
 void UFlowNode_ComponentObserver::ExecuteInput(const FName& PinName)
@@ -68,10 +70,16 @@ void UFlowNode_ComponentObserver::StartObserving()
 			}
 		}
 		
-		FlowSubsystem->OnComponentRegistered.AddUniqueDynamic(this, &UFlowNode_ComponentObserver::OnComponentRegistered);
-		FlowSubsystem->OnComponentTagAdded.AddUniqueDynamic(this, &UFlowNode_ComponentObserver::OnComponentTagAdded);
-		FlowSubsystem->OnComponentTagRemoved.AddUniqueDynamic(this, &UFlowNode_ComponentObserver::OnComponentTagRemoved);
-		FlowSubsystem->OnComponentUnregistered.AddUniqueDynamic(this, &UFlowNode_ComponentObserver::OnComponentUnregistered);
+		if (!ComponentObserverHandle.IsValid())
+		{
+			FFlowComponentObserverCallbacks Callbacks;
+			Callbacks.OnComponentRegistered.BindUObject(this, &UFlowNode_ComponentObserver::OnComponentRegistered);
+			Callbacks.OnComponentTagAdded.BindUObject(this, &UFlowNode_ComponentObserver::OnComponentTagAdded);
+			Callbacks.OnComponentTagRemoved.BindUObject(this, &UFlowNode_ComponentObserver::OnComponentTagRemoved);
+			Callbacks.OnComponentUnregistered.BindUObject(this, &UFlowNode_ComponentObserver::OnComponentUnregistered);
+
+			ComponentObserverHandle = FlowSubsystem->AddComponentObserver(IdentityTags, bExactMatch, MoveTemp(Callbacks));
+		}
 	}
 }
 
@@ -79,11 +87,10 @@ void UFlowNode_ComponentObserver::StopObserving()
 {
 	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
 	{
-		FlowSubsystem->OnComponentRegistered.RemoveAll(this);
-		FlowSubsystem->OnComponentUnregistered.RemoveAll(this);
-		FlowSubsystem->OnComponentTagAdded.RemoveAll(this);
-		FlowSubsystem->OnComponentTagRemoved.RemoveAll(this);
+		FlowSubsystem->RemoveComponentObserver(ComponentObserverHandle);
 	}
+
+	ComponentObserverHandle.Reset();
 }
 
 void UFlowNode_ComponentObserver::OnComponentRegistered(UFlowComponent* Component)
@@ -125,6 +132,8 @@ void UFlowNode_ComponentObserver::OnEventReceived()
 	TriggerFirstOutput(false);
 
 	SuccessCount++;
+	MarkSaveDirty();
+
 	if (SuccessLimit > 0 && SuccessCount == SuccessLimit)
 	{
 		TriggerOutput(TEXT("Completed"), true);
@@ -24,9 +24,15 @@ void UFlowNode_NotifyActor::ExecuteInput(const FName& PinName)
 {
 	if (const UFlowSubsystem* FlowSubsystem = GetWorld()->GetGameInstance()->GetSubsystem<UFlowSubsystem>())
 	{
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FlowSubsystem->GetComponents<UFlowComponent>(IdentityTags, MatchType, bExactMatch))
+		TArray<UFlowComponent*, TInlineAllocator<16>> Components;
+		FlowSubsystem->FindComponents(IdentityTags, MatchType, bExactMatch, Components);
+
+		for (UFlowComponent* Component : Components)
 		{
-			Component->NotifyFromGraph(NotifyTags, NetMode);
+			if (IsValid(Component))
+			{
+				Component->NotifyFromGraph(NotifyTags, NetMode);
+			}
 		}
 	}
 
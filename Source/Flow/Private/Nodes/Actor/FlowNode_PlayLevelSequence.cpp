@@ -50,6 +50,9 @@ UFlowNode_PlayLevelSequence::UFlowNode_PlayLevelSequence(const FObjectInitialize
 	OutputPins.Add(FFlowPin(TEXT("Started")));
 	OutputPins.Add(FFlowPin(TEXT("Completed")));
 	OutputPins.Add(FFlowPin(TEXT("Stopped")));
+
+	// elapsed time is written in OnSave
+	SaveRecordReusableClass = nullptr;
 }
 
 #if WITH_EDITOR
@@ -5,6 +5,9 @@
 
 #include "FlowAsset.h"
 #include "FlowSettings.h"
+#include "FlowStats.h"
+#include "FlowSubsystem.h"
+#include "FlowTrace.h"
 #include "Interfaces/FlowNodeWithExternalDataPinSupplierInterface.h"
 #include "Types/FlowDataPinProperties.h"
 
@@ -16,8 +19,6 @@
 #include "Engine/BlueprintGeneratedClass.h"
 #include "GameFramework/Actor.h"
 #include "Misc/App.h"
-#include "Serialization/MemoryReader.h"
-#include "Serialization/MemoryWriter.h"
 
 FFlowPin UFlowNode::DefaultInputPin(TEXT("In"));
 FFlowPin UFlowNode::DefaultOutputPin(TEXT("Out"));
@@ -29,10 +30,12 @@ FString UFlowNode::NoActorsFound = TEXT("No actors found");
 
 UFlowNode::UFlowNode(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, NodeIndex(INDEX_NONE)
 	, AllowedSignalModes({EFlowSignalMode::Enabled, EFlowSignalMode::Disabled, EFlowSignalMode::PassThrough})
 	, SignalMode(EFlowSignalMode::Enabled)
 	, bPreloaded(false)
 	, ActivationState(EFlowNodeState::NeverActivated)
+	, SaveRecordReusableClass(UFlowNode::StaticClass())
 {
 #if WITH_EDITOR
 	Category = TEXT("Uncategorized");
@@ -430,9 +433,10 @@ bool UFlowNode::TryGetFlowDataPinSupplierDatasForPinName(
 
 	if (FindConnectedNodeForPinFast(PinName, &ConnectedNodeGuid, &ConnectedPinValueSupplier.SupplierPinName))
 	{
-		if (const UFlowAsset* FlowAsset = GetFlowAsset())
+		if (UFlowAsset* FlowAsset = GetFlowAsset())
 		{
-			const UFlowNode* SupplierFlowNode = FlowAsset->GetNode(ConnectedNodeGuid);
+			// supplier has to be the node of this instance, not yet instanced node would resolve values on the template
+			const UFlowNode* SupplierFlowNode = FlowAsset->GetOrCreateNodeInstance(ConnectedNodeGuid);
 
 			// If the connected node can supply data pin values, insert it into the top of the priority queue
 			const IFlowDataPinValueSupplierInterface* SupplierFlowNodeAsInterface = Cast<IFlowDataPinValueSupplierInterface>(SupplierFlowNode);
@@ -458,6 +462,48 @@ bool UFlowNode::TryGetFlowDataPinSupplierDatasForPinName(
 	return !InOutPinValueSupplierDatas.IsEmpty();
 }
 
+TMap<TObjectKey<UClass>, TMap<FName, const FProperty*>> UFlowNode::BoundPropertyCache;
+
+const TArray<FFlowPinValueSupplierData>& UFlowNode::GetCachedFlowDataPinSupplierDatasForPinName(const FName& PinName) const
+{
+	// generation 0 is never valid, so nodes outside of any asset rebuild the chain every time
+	const UFlowAsset* FlowAsset = GetFlowAsset();
+	const uint32 Generation = FlowAsset ? FlowAsset->GetDataPinSupplierGeneration() : 0;
+
+	FCachedDataPinSuppliers& CachedSuppliers = CachedDataPinSuppliers.FindOrAdd(PinName);
+	if (CachedSuppliers.Generation != Generation || Generation == 0)
+	{
+		CachedSuppliers.Suppliers.Reset();
+		TryGetFlowDataPinSupplierDatasForPinName(PinName, CachedSuppliers.Suppliers);
+		CachedSuppliers.Generation = Generation;
+	}
+
+	return CachedSuppliers.Suppliers;
+}
+
+const FProperty* UFlowNode::FindBoundPropertyCached(const UClass& Class, const FName& PropertyName)
+{
+	TMap<FName, const FProperty*>& ClassProperties = BoundPropertyCache.FindOrAdd(&Class);
+	if (const FProperty* const* CachedProperty = ClassProperties.Find(PropertyName))
+	{
+		return *CachedProperty;
+	}
+
+	// missing properties aren't cached, it's an error case anyway
+	const FProperty* FoundProperty = Class.FindPropertyByName(PropertyName);
+	if (FoundProperty)
+	{
+		ClassProperties.Add(PropertyName, FoundProperty);
+	}
+
+	return FoundProperty;
+}
+
+void UFlowNode::ClearBoundPropertyCache()
+{
+	BoundPropertyCache.Empty();
+}
+
 bool UFlowNode::TryFindPropertyByPinName(
 	const FName& PinName,
 	const FProperty*& OutFoundProperty,
@@ -486,8 +532,7 @@ bool UFlowNode::TryFindPropertyByRemappedPinName(
 	TInstancedStruct<FFlowDataPinProperty>& OutFoundInstancedStruct,
 	EFlowDataPinResolveResult& InOutResult) const
 {
-	const UClass* ThisClass = GetClass();
-	OutFoundProperty = ThisClass->FindPropertyByName(RemappedPinName);
+	OutFoundProperty = FindBoundPropertyCached(*GetClass(), RemappedPinName);
 
 	if (!OutFoundProperty)
 	{
@@ -506,6 +551,7 @@ TSet<UFlowNode*> UFlowNode::GatherConnectedNodes() const
 	TSet<UFlowNode*> Result;
 	for (const TPair<FName, FConnectedPin>& Connection : Connections)
 	{
+		// read-only traversal, it doesn't create nodes of the lazily instanced asset
 		Result.Emplace(GetFlowAsset()->GetNode(Connection.Value.NodeGuid));
 	}
 
@@ -788,48 +834,136 @@ void UFlowNode::TriggerFlush()
 	FlushContent();
 }
 
+void UFlowNode::GatherPreloadableContent(TArray<FSoftObjectPath>& OutContent) const
+{
+	for (TFieldIterator<FProperty> PropertyIt(GetClass()); PropertyIt; ++PropertyIt)
+	{
+		if (const FSoftObjectProperty* SoftObjectProperty = CastField<FSoftObjectProperty>(*PropertyIt))
+		{
+			const FSoftObjectPtr SoftObject = SoftObjectProperty->GetPropertyValue_InContainer(this);
+			if (!SoftObject.IsNull())
+			{
+				OutContent.AddUnique(SoftObject.ToSoftObjectPath());
+			}
+		}
+		else if (const FStructProperty* StructProperty = CastField<FStructProperty>(*PropertyIt))
+		{
+			if (StructProperty->Struct->IsChildOf(FFlowDataPinOutputProperty_Class::StaticStruct()))
+			{
+				const FSoftClassPath& ClassPath = StructProperty->ContainerPtrToValuePtr<FFlowDataPinOutputProperty_Class>(this)->GetAsSoftClass();
+				if (!ClassPath.IsNull())
+				{
+					OutContent.AddUnique(ClassPath);
+				}
+			}
+		}
+	}
+}
+
+void UFlowNode::SetFlowTimer(FFlowTimerHandle& InOutHandle, FFlowTimerDelegate&& Delegate, const float Rate, const bool bLoop, const float FirstDelay) const
+{
+	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+	{
+		FlowSubsystem->GetTimerWheel().SetTimer(InOutHandle, MoveTemp(Delegate), Rate, bLoop, FirstDelay);
+	}
+	else
+	{
+		LogError(TEXT("No Flow Subsystem, timer can't be set"));
+	}
+}
+
+void UFlowNode::SetFlowTimerForNextTick(FFlowTimerHandle& InOutHandle, FFlowTimerDelegate&& Delegate) const
+{
+	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+	{
+		FlowSubsystem->GetTimerWheel().SetTimerForNextTick(InOutHandle, MoveTemp(Delegate));
+	}
+	else
+	{
+		LogError(TEXT("No Flow Subsystem, timer can't be set"));
+	}
+}
+
+void UFlowNode::ClearFlowTimer(FFlowTimerHandle& InOutHandle) const
+{
+	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
+	{
+		FlowSubsystem->GetTimerWheel().ClearTimer(InOutHandle);
+	}
+	InOutHandle.Invalidate();
+}
+
+float UFlowNode::GetFlowTimerRemaining(const FFlowTimerHandle& Handle) const
+{
+	const UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	return FlowSubsystem ? FlowSubsystem->GetTimerWheel().GetTimerRemaining(Handle) : -1.0f;
+}
+
+float UFlowNode::GetFlowTimerElapsed(const FFlowTimerHandle& Handle) const
+{
+	const UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	return FlowSubsystem ? FlowSubsystem->GetTimerWheel().GetTimerElapsed(Handle) : -1.0f;
+}
+
 void UFlowNode::TriggerInput(const FName& PinName, const EFlowPinActivationType ActivationType /*= Default*/)
 {
+	const int32 PinIndex = InputPins.IndexOfByKey(PinName);
+	if (PinIndex == INDEX_NONE)
+	{
+#if !UE_BUILD_SHIPPING
+		LogError(FString::Printf(TEXT("Input Pin name %s invalid"), *PinName.ToString()));
+#endif // UE_BUILD_SHIPPING
+		return;
+	}
+
+	TriggerInputByIndex(PinIndex, ActivationType);
+}
+
+void UFlowNode::TriggerInputByIndex(const int32 PinIndex, const EFlowPinActivationType ActivationType /*= Default*/)
+{
+	FLOW_SCOPE_CYCLE_COUNTER(TriggerInput);
+
 	if (SignalMode == EFlowSignalMode::Disabled)
 	{
 		// entirely ignore any Input activation
 	}
 
-	if (InputPins.Contains(PinName))
+	if (!InputPins.IsValidIndex(PinIndex))
 	{
-		if (SignalMode == EFlowSignalMode::Enabled)
-		{
-			const EFlowNodeState PreviousActivationState = ActivationState;
-			if (PreviousActivationState != EFlowNodeState::Active)
-			{
-				OnActivate();
-			}
+		return;
+	}
 
-			ActivationState = EFlowNodeState::Active;
+	const FName PinName = InputPins[PinIndex].PinName;
+
+	FLOW_INC_FRAME_COUNTER(PinActivations);
+
+	if (SignalMode == EFlowSignalMode::Enabled)
+	{
+		const EFlowNodeState PreviousActivationState = ActivationState;
+		if (PreviousActivationState != EFlowNodeState::Active)
+		{
+			TRACE_FLOW_NODE_ACTIVATED(*this);
+			MarkSaveDirty();
+			OnActivate();
 		}
 
+		ActivationState = EFlowNodeState::Active;
+	}
+
 #if !UE_BUILD_SHIPPING
-		// record for debugging
-		TArray<FPinRecord>& Records = InputRecords.FindOrAdd(PinName);
-		Records.Add(FPinRecord(FApp::GetCurrentTime(), ActivationType));
+	// record for debugging
+	PinRecordHistory.Add(PinIndex, true, FPinRecord(FApp::GetCurrentTime(), ActivationType), UFlowSettings::Get()->PinActivationHistorySize);
+	TRACE_FLOW_PIN_TRIGGERED(*this, PinIndex, true);
 
-		LogVerbose(FString::Printf(TEXT("Triggering input %s."), *PinName.ToString()));
+	FLOW_LOG_VERBOSE(TEXT("Triggering input %s."), *PinName.ToString());
 #endif // UE_BUILD_SHIPPING
 
 #if WITH_EDITOR
-		if (GEditor && UFlowAsset::GetFlowGraphInterface().IsValid())
-		{
-			UFlowAsset::GetFlowGraphInterface()->OnInputTriggered(GraphNode, InputPins.IndexOfByKey(PinName));
-		}
-#endif // WITH_EDITOR
-	}
-	else
+	if (GEditor && UFlowAsset::GetFlowGraphInterface().IsValid())
 	{
-#if !UE_BUILD_SHIPPING
-		LogError(FString::Printf(TEXT("Input Pin name %s invalid"), *PinName.ToString()));
-#endif // UE_BUILD_SHIPPING
-		return;
+		UFlowAsset::GetFlowGraphInterface()->OnInputTriggered(GraphNode, PinIndex);
 	}
+#endif // WITH_EDITOR
 
 	switch (SignalMode)
 	{
@@ -876,19 +1010,21 @@ void UFlowNode::TriggerOutput(const FName PinName, const bool bFinish /*= false*
 		Finish();
 	}
 
+	const int32 PinIndex = OutputPins.IndexOfByKey(PinName);
+
 #if !UE_BUILD_SHIPPING
-	if (OutputPins.Contains(PinName))
+	if (PinIndex != INDEX_NONE)
 	{
 		// record for debugging, even if nothing is connected to this pin
-		TArray<FPinRecord>& Records = OutputRecords.FindOrAdd(PinName);
-		Records.Add(FPinRecord(FApp::GetCurrentTime(), ActivationType));
+		PinRecordHistory.Add(PinIndex, false, FPinRecord(FApp::GetCurrentTime(), ActivationType), UFlowSettings::Get()->PinActivationHistorySize);
+		TRACE_FLOW_PIN_TRIGGERED(*this, PinIndex, false);
 
-		LogVerbose(FString::Printf(TEXT("\n Triggering output: %s.  bFinish: %s "), *PinName.ToString(), bFinish ? TEXT("true") : TEXT("false")));
+		FLOW_LOG_VERBOSE(TEXT("\n Triggering output: %s.  bFinish: %s "), *PinName.ToString(), bFinish ? TEXT("true") : TEXT("false"));
 
 #if WITH_EDITOR
 		if (GEditor && UFlowAsset::GetFlowGraphInterface().IsValid())
 		{
-			UFlowAsset::GetFlowGraphInterface()->OnOutputTriggered(GraphNode, OutputPins.IndexOfByKey(PinName));
+			UFlowAsset::GetFlowGraphInterface()->OnOutputTriggered(GraphNode, PinIndex);
 		}
 #endif
 	}
@@ -899,20 +1035,32 @@ void UFlowNode::TriggerOutput(const FName PinName, const bool bFinish /*= false*
 #endif // UE_BUILD_SHIPPING
 
 #if WITH_EDITOR
-	LogVerbose(FString::Printf(TEXT("\n Description: %s"), *GetNodeDescription()));
-	LogVerbose(FString::Printf(TEXT("\n Status: %s"), *GetStatusStringForNodeAndAddOns()));
+	FLOW_LOG_VERBOSE(TEXT("\n Description: %s"), *GetNodeDescription());
+	FLOW_LOG_VERBOSE(TEXT("\n Status: %s"), *GetStatusStringForNodeAndAddOns());
 #endif
 
 	// call the next node
-	if (OutputPins.Contains(PinName) && Connections.Contains(PinName))
+	if (PinIndex != INDEX_NONE)
 	{
-		const FConnectedPin FlowPin = GetConnection(PinName);
-		GetFlowAsset()->TriggerInput(FlowPin.NodeGuid, FlowPin.PinName);
+		UFlowAsset* FlowAsset = GetFlowAsset();
+		if (const FFlowCompiledEdge* Edge = FlowAsset->GetCompiledGraph().FindOutputEdge(NodeIndex, PinIndex))
+		{
+			if (Edge->IsConnected())
+			{
+				FlowAsset->TriggerInput(Edge->NodeIndex, Edge->PinIndex);
+			}
+		}
+		else if (const FConnectedPin* Connection = Connections.Find(PinName))
+		{
+			// node isn't part of the compiled graph
+			FlowAsset->TriggerInput(Connection->NodeGuid, Connection->PinName);
+		}
 	}
 }
 
 void UFlowNode::Finish()
 {
+	TRACE_FLOW_NODE_FINISHED(*this);
 	Deactivate();
 	GetFlowAsset()->FinishNode(this);
 }
@@ -934,6 +1082,7 @@ void UFlowNode::Deactivate()
 		ActivationState = EFlowNodeState::Completed;
 	}
 
+	MarkSaveDirty();
 	Cleanup();
 }
 
@@ -941,27 +1090,73 @@ void UFlowNode::ResetRecords()
 {
 	ActivationState = EFlowNodeState::NeverActivated;
 
+	MarkSaveDirty();
+	CachedSaveRecord = FFlowNodeSaveData();
+	CachedSaveGeneration = 0;
+
 #if !UE_BUILD_SHIPPING
-	InputRecords.Empty();
-	OutputRecords.Empty();
+	PinRecordHistory.Reset();
 #endif
 }
 
+void UFlowNode::ResetForPool(const UFlowNode& NodeTemplate)
+{
+	check(NodeTemplate.GetClass() == GetClass());
+
+	ResetRecords();
+	bPreloaded = false;
+	CachedDataPinSuppliers.Empty();
+
+	for (TFieldIterator<FProperty> PropertyIt(GetClass()); PropertyIt; ++PropertyIt)
+	{
+		// instanced subobjects would be shared with the template, AddOns are instantiated again by InitializeInstance
+		// duplicate-transient properties aren't part of the template state
+		if (!PropertyIt->HasAnyPropertyFlags(CPF_InstancedReference | CPF_ContainsInstancedReference | CPF_DuplicateTransient))
+		{
+			PropertyIt->CopyCompleteValue_InContainer(this, &NodeTemplate);
+		}
+	}
+}
+
 void UFlowNode::SaveInstance(FFlowNodeSaveData& NodeRecord)
 {
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	const bool bIncrementalSaving = UFlowSettings::Get()->bIncrementalSaving;
+	const uint32 SaveTableSerial = FlowSubsystem ? FlowSubsystem->GetSaveTableSerialForSaving() : 0;
+
+	if (bIncrementalSaving && CachedSaveGeneration == SaveGeneration && CachedSaveTableSerial == SaveTableSerial && CanReuseSaveRecord())
+	{
+		NodeRecord = CachedSaveRecord;
+		if (FlowSubsystem)
+		{
+			FlowSubsystem->LastSaveStats.ReusedRecords++;
+		}
+		return;
+	}
+
 	NodeRecord.NodeGuid = NodeGuid;
 	OnSave();
 
-	FMemoryWriter MemoryWriter(NodeRecord.NodeData, true);
-	FFlowArchive Ar(MemoryWriter);
-	Serialize(Ar);
+	FFlowSaveSerializer::SaveObject(*this, NodeRecord.NodeData, FlowSubsystem ? FlowSubsystem->GetSaveTableForSaving() : nullptr);
+
+	if (FlowSubsystem)
+	{
+		FlowSubsystem->LastSaveStats.SerializedRecords++;
+	}
+
+	if (bIncrementalSaving)
+	{
+		CachedSaveRecord = NodeRecord;
+		CachedSaveGeneration = SaveGeneration;
+		CachedSaveTableSerial = SaveTableSerial;
+	}
 }
 
 void UFlowNode::LoadInstance(const FFlowNodeSaveData& NodeRecord)
 {
-	FMemoryReader MemoryReader(NodeRecord.NodeData, true);
-	FFlowArchive Ar(MemoryReader);
-	Serialize(Ar);
+	const UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	FFlowSaveSerializer::LoadObject(*this, NodeRecord.NodeData, FlowSubsystem ? FlowSubsystem->GetSaveTableForLoading() : nullptr);
+	MarkSaveDirty();
 
 	if (UFlowAsset* FlowAsset = GetFlowAsset())
 	{
@@ -986,6 +1181,18 @@ void UFlowNode::LoadInstance(const FFlowNodeSaveData& NodeRecord)
 	}
 }
 
+void UFlowNode::MarkSaveDirty()
+{
+	SaveGeneration++;
+}
+
+bool UFlowNode::CanReuseSaveRecord() const
+{
+	return SaveRecordReusableClass
+		&& !GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UFlowNode, OnSave))
+		&& !FFlowSaveSerializer::DeclaresSaveGameProperties(GetClass(), SaveRecordReusableClass);
+}
+
 void UFlowNode::OnSave_Implementation()
 {
 }
@@ -1011,27 +1218,35 @@ void UFlowNode::OnPassThrough_Implementation()
 }
 
 #if WITH_EDITOR
-TMap<uint8, FPinRecord> UFlowNode::GetWireRecords() const
+TMap<int32, FPinRecord> UFlowNode::GetWireRecords() const
 {
-	TMap<uint8, FPinRecord> Result;
-	for (const TPair<FName, TArray<FPinRecord>>& Record : OutputRecords)
+	TMap<int32, FPinRecord> Result;
+	for (int32 PinIndex = 0; PinIndex < PinRecordHistory.GetPinsNum(false); PinIndex++)
 	{
-		Result.Emplace(OutputPins.IndexOfByKey(Record.Key), Record.Value.Last());
+		if (const FPinRecord* Record = PinRecordHistory.GetLastRecord(PinIndex, false))
+		{
+			Result.Emplace(PinIndex, *Record);
+		}
 	}
 	return Result;
 }
 
 TArray<FPinRecord> UFlowNode::GetPinRecords(const FName& PinName, const EEdGraphPinDirection PinDirection) const
 {
-	switch (PinDirection)
+	TArray<FPinRecord> Result;
+	if (PinDirection != EGPD_Input && PinDirection != EGPD_Output)
 	{
-		case EGPD_Input:
-			return InputRecords.FindRef(PinName);
-		case EGPD_Output:
-			return OutputRecords.FindRef(PinName);
-		default:
-			return TArray<FPinRecord>();
+		return Result;
 	}
+
+	const bool bInputPin = PinDirection == EGPD_Input;
+	const int32 PinIndex = bInputPin ? InputPins.IndexOfByKey(PinName) : OutputPins.IndexOfByKey(PinName);
+
+	PinRecordHistory.ForEachRecord(PinIndex, bInputPin, [&Result](const FPinRecord& Record)
+	{
+		Result.Add(Record);
+	});
+	return Result;
 }
 
 #endif
@@ -1066,7 +1281,8 @@ UFlowNode* UFlowNode::GetInspectedInstance() const
 {
 	if (const UFlowAsset* FlowInstance = GetFlowAsset()->GetInspectedInstance())
 	{
-		return FlowInstance->GetNode(GetGuid());
+		// node might not be instanced yet, if the asset uses lazy node instancing
+		return FlowInstance->GetNodeInstance(GetGuid());
 	}
 
 	return nullptr;
@@ -5,7 +5,9 @@
 #include "AddOns/FlowNodeAddOn.h"
 #include "FlowAsset.h"
 #include "FlowLogChannels.h"
+#include "FlowStats.h"
 #include "FlowSubsystem.h"
+#include "FlowTrace.h"
 #include "FlowTypes.h"
 #include "Interfaces/FlowDataPinValueSupplierInterface.h"
 
@@ -20,7 +22,6 @@
 #include "Engine/World.h"
 #include "GameFramework/Actor.h"
 #include "Misc/App.h"
-#include "Misc/Paths.h"
 #include "Serialization/MemoryReader.h"
 #include "Serialization/MemoryWriter.h"
 
@@ -875,7 +876,7 @@ void UFlowNodeBase::LogNote(FString Message) const
 void UFlowNodeBase::LogVerbose(FString Message) const
 {
 #if !UE_BUILD_SHIPPING
-	if (BuildMessage(Message))
+	if (UE_LOG_ACTIVE(LogFlow, Verbose) && BuildMessage(Message))
 	{
 		// Output Log
 		UE_LOG(LogFlow, Verbose, TEXT("%s"), *Message);
@@ -889,8 +890,8 @@ bool UFlowNodeBase::BuildMessage(FString& Message) const
 	UFlowAsset* FlowAsset = GetFlowAsset();
 	if (FlowAsset && FlowAsset->GetTemplateAsset()) // this is runtime log which is should be only called on runtime instances of asset
 	{
-		const FString TemplatePath = FlowAsset->GetTemplateAsset()->GetPathName();
-		Message.Append(TEXT(" --- node ")).Append(GetName()).Append(TEXT(", asset ")).Append(FPaths::GetPath(TemplatePath) / FPaths::GetBaseFilename(TemplatePath));
+		// package name equals the asset path without the object name, no need to split the full path name
+		Message.Append(TEXT(" --- node ")).Append(GetName()).Append(TEXT(", asset ")).Append(FlowAsset->GetTemplateAsset()->GetPackage()->GetName());
 
 		return true;
 	}
@@ -901,6 +902,8 @@ bool UFlowNodeBase::BuildMessage(FString& Message) const
 
 EFlowDataPinResolveResult UFlowNodeBase::TryResolveDataPinPrerequisites(const FName& PinName, const UFlowNode*& FlowNode, const FFlowPin*& FlowPin, EFlowPinType PinType) const
 {
+	FLOW_INC_FRAME_COUNTER(DataPinResolves);
+
 	FlowNode = GetFlowNodeSelfOrOwner();
 
 	if (!IsValid(FlowNode))
@@ -921,6 +924,8 @@ EFlowDataPinResolveResult UFlowNodeBase::TryResolveDataPinPrerequisites(const FN
 		return EFlowDataPinResolveResult::FailedMismatchedType;
 	}
 
+	TRACE_FLOW_DATA_PIN_RESOLVED(*FlowNode, UE_PTRDIFF_TO_INT32(FlowPin - FlowNode->GetInputPins().GetData()));
+
 	return EFlowDataPinResolveResult::Success;
 }
 
@@ -936,7 +941,8 @@ bool TResolveDataPinWorkingData<TFlowDataPinResultType, PinType>::TrySetupWorkin
 		return false;
 	}
 
-	if (!FlowNode->TryGetFlowDataPinSupplierDatasForPinName(FlowPin->PinName, PinValueSupplierDatas))
+	PinValueSupplierDatas = FlowNode->GetCachedFlowDataPinSupplierDatasForPinName(FlowPin->PinName);
+	if (PinValueSupplierDatas.IsEmpty())
 	{
 		return false;
 	}
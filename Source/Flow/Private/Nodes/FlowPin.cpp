@@ -29,17 +29,20 @@ FString FPinRecord::PassThroughActivation = TEXT(" (pass-through activation)");
 
 FPinRecord::FPinRecord()
 	: Time(0.0f)
-	, HumanReadableTime(FString())
 	, ActivationType(EFlowPinActivationType::Default)
 {
 }
 
 FPinRecord::FPinRecord(const double InTime, const EFlowPinActivationType InActivationType)
 	: Time(InTime)
+	, SystemTime(FDateTime::Now())
 	, ActivationType(InActivationType)
 {
-	const FDateTime SystemTime(FDateTime::Now());
-	HumanReadableTime = DoubleDigit(SystemTime.GetHour()) + TEXT(".")
+}
+
+FString FPinRecord::GetHumanReadableTime() const
+{
+	return DoubleDigit(SystemTime.GetHour()) + TEXT(".")
 		+ DoubleDigit(SystemTime.GetMinute()) + TEXT(".")
 		+ DoubleDigit(SystemTime.GetSecond()) + TEXT(":")
 		+ DoubleDigit(SystemTime.GetMillisecond()).Left(3);
@@ -49,6 +52,56 @@ FORCEINLINE FString FPinRecord::DoubleDigit(const int32 Number)
 {
 	return Number > 9 ? FString::FromInt(Number) : TEXT("0") + FString::FromInt(Number);
 }
+
+void FPinRecordHistory::Add(const int32 PinIndex, const bool bInputPin, const FPinRecord& Record, const int32 Capacity)
+{
+	if (Capacity <= 0 || PinIndex < 0)
+	{
+		return;
+	}
+
+	TArray<FPinRing>& Pins = bInputPin ? InputPins : OutputPins;
+	if (PinIndex >= Pins.Num())
+	{
+		Pins.SetNum(PinIndex + 1);
+	}
+	FPinRing& Ring = Pins[PinIndex];
+
+	// append only while the buffer didn't wrap around yet, otherwise the order of records would break
+	if (Ring.Records.Num() < Capacity && Ring.Head == 0)
+	{
+		// allocate the whole buffer once, so recording this pin never allocates again
+		if (Ring.Records.Max() < Capacity)
+		{
+			Ring.Records.Reserve(Capacity);
+		}
+
+		Ring.Records.Add(Record);
+		return;
+	}
+
+	// buffer is full, overwrite the oldest record
+	Ring.Records[Ring.Head] = Record;
+	Ring.Head = (Ring.Head + 1) % Ring.Records.Num();
+}
+
+const FPinRecord* FPinRecordHistory::GetLastRecord(const int32 PinIndex, const bool bInputPin) const
+{
+	const TArray<FPinRing>& Pins = bInputPin ? InputPins : OutputPins;
+	if (Pins.IsValidIndex(PinIndex) && Pins[PinIndex].Records.Num() > 0)
+	{
+		const FPinRing& Ring = Pins[PinIndex];
+		return &Ring.Records[(Ring.Head + Ring.Records.Num() - 1) % Ring.Records.Num()];
+	}
+
+	return nullptr;
+}
+
+void FPinRecordHistory::Reset()
+{
+	InputPins.Reset();
+	OutputPins.Reset();
+}
 #endif
 
 //////////////////////////////////////////////////////////////////////////
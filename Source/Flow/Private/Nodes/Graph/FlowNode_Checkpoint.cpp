@@ -9,26 +9,90 @@
 
 UFlowNode_Checkpoint::UFlowNode_Checkpoint(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
+	, bOutputTriggered(false)
 {
 #if WITH_EDITOR
 	Category = TEXT("Graph");
 #endif
+
+	OutputPins.Add(FFlowPin(TEXT("Saved")));
+	OutputPins.Add(FFlowPin(TEXT("Failed")));
+
+	SaveRecordReusableClass = StaticClass();
 }
 
 void UFlowNode_Checkpoint::ExecuteInput(const FName& PinName)
 {
-	if (GetFlowSubsystem())
+	if (UFlowSubsystem* FlowSubsystem = GetFlowSubsystem())
 	{
-		UFlowSaveGame* NewSaveGame = Cast<UFlowSaveGame>(UGameplayStatics::CreateSaveGameObject(UFlowSaveGame::StaticClass()));
-		GetFlowSubsystem()->OnGameSaved(NewSaveGame);
+		// checkpoints activated in the same frame share the SaveGame, so none of them is superseded
+		UFlowSaveGame* SaveGame = FlowSubsystem->GetPendingSaveGame(GetDefault<UFlowSaveGame>()->SaveSlotName, 0);
+		if (SaveGame == nullptr)
+		{
+			SaveGame = Cast<UFlowSaveGame>(UGameplayStatics::CreateSaveGameObject(UFlowSaveGame::StaticClass()));
+		}
 
-		UGameplayStatics::SaveGameToSlot(NewSaveGame, NewSaveGame->SaveSlotName, 0);
+		FlowSubsystem->SaveGameAsync(SaveGame, 0,
+			FFlowSaveGameCompleted::CreateUObject(this, &UFlowNode_Checkpoint::OnSaveGameWritten),
+			FFlowSaveGameCaptured::CreateUObject(this, &UFlowNode_Checkpoint::OnSaveGameCaptured));
+	}
+	else
+	{
+		TriggerFirstOutput(true);
 	}
-
-	TriggerFirstOutput(true);
 }
 
 void UFlowNode_Checkpoint::OnLoad_Implementation()
 {
-	TriggerFirstOutput(true);
+	if (bOutputTriggered)
+	{
+		// saved by another checkpoint while this one was waiting for its write, nodes after this one restored their own state
+		Finish();
+	}
+	else
+	{
+		TriggerFirstOutput(true);
+	}
+}
+
+void UFlowNode_Checkpoint::Cleanup()
+{
+	bOutputTriggered = false;
+
+	Super::Cleanup();
+}
+
+void UFlowNode_Checkpoint::OnSaveGameCaptured(UFlowSaveGame* SaveGame)
+{
+	// snapshot has been captured while this node was active, so the loaded game would trigger the output again
+	if (GetActivationState() == EFlowNodeState::Active && !bOutputTriggered)
+	{
+		bOutputTriggered = true;
+		MarkSaveDirty();
+		TriggerFirstOutput(false);
+	}
+}
+
+void UFlowNode_Checkpoint::OnSaveGameWritten(UFlowSaveGame* SaveGame, const EFlowSaveGameResult Result)
+{
+	if (GetActivationState() != EFlowNodeState::Active)
+	{
+		return;
+	}
+
+	// state of this node is captured by other save of the same slot, which doesn't report back to this node
+	if (Result == EFlowSaveGameResult::Superseded)
+	{
+		TriggerFirstOutput(true);
+		return;
+	}
+
+	if (!bOutputTriggered)
+	{
+		bOutputTriggered = true;
+		MarkSaveDirty();
+		TriggerFirstOutput(false);
+	}
+
+	TriggerOutput(Result == EFlowSaveGameResult::Saved ? TEXT("Saved") : TEXT("Failed"), true);
 }
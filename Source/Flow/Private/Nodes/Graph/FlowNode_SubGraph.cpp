@@ -17,6 +17,8 @@ FFlowPin UFlowNode_SubGraph::FinishPin(TEXT("Finish"));
 UFlowNode_SubGraph::UFlowNode_SubGraph(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, bCanInstanceIdenticalAsset(false)
+	, bStartOnAssetLoaded(false)
+	, bRestoreOnAssetLoaded(false)
 {
 #if WITH_EDITOR
 	Category = TEXT("Graph");
@@ -27,6 +29,8 @@ UFlowNode_SubGraph::UFlowNode_SubGraph(const FObjectInitializer& ObjectInitializ
 
 	InputPins = {StartPin};
 	OutputPins = {FinishPin};
+
+	SaveRecordReusableClass = StaticClass();
 }
 
 bool UFlowNode_SubGraph::CanBeAssetInstanced() const
@@ -34,16 +38,122 @@ bool UFlowNode_SubGraph::CanBeAssetInstanced() const
 	return !Asset.IsNull() && (bCanInstanceIdenticalAsset || Asset.ToString() != GetFlowAsset()->GetTemplateAsset()->GetPathName());
 }
 
+bool UFlowNode_SubGraph::ShouldLoadAssetAsync() const
+{
+	return UFlowSettings::Get()->bAsyncLoadSubGraphs && Asset.Get() == nullptr;
+}
+
+void UFlowNode_SubGraph::RequestAssetLoad()
+{
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	if (AssetLoadHandle.IsValid() || FlowSubsystem == nullptr)
+	{
+		return;
+	}
+
+	const UFlowSettings* Settings = UFlowSettings::Get();
+	AssetLoadHandle = FlowSubsystem->GetStreamableManager().RequestAsyncLoad(Asset.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &UFlowNode_SubGraph::OnAssetLoaded), Settings->SubGraphLoadPriority);
+
+	if (!AssetLoadHandle.IsValid())
+	{
+		LogError(FString::Printf(TEXT("Failed to request loading of Flow Asset %s"), *Asset.ToString()));
+		return;
+	}
+
+	if (AssetLoadHandle->IsLoadingInProgress() && Settings->SubGraphLoadTimeout > 0.0f)
+	{
+		SetFlowTimer(AssetLoadTimeoutHandle, FFlowTimerDelegate::CreateUObject(this, &UFlowNode_SubGraph::OnAssetLoadTimeout), Settings->SubGraphLoadTimeout, false);
+	}
+}
+
+void UFlowNode_SubGraph::CancelAssetLoad()
+{
+	if (AssetLoadHandle.IsValid())
+	{
+		AssetLoadHandle->CancelHandle();
+		AssetLoadHandle.Reset();
+	}
+
+	ClearFlowTimer(AssetLoadTimeoutHandle);
+
+	bStartOnAssetLoaded = false;
+	bRestoreOnAssetLoaded = false;
+}
+
+void UFlowNode_SubGraph::OnAssetLoaded()
+{
+	ClearFlowTimer(AssetLoadTimeoutHandle);
+
+	UFlowSubsystem* FlowSubsystem = GetFlowSubsystem();
+	if (FlowSubsystem == nullptr)
+	{
+		return;
+	}
+
+	if (Asset.Get() == nullptr)
+	{
+		LogError(FString::Printf(TEXT("Failed to load Flow Asset %s"), *Asset.ToString()));
+		return;
+	}
+
+	if (bRestoreOnAssetLoaded)
+	{
+		bRestoreOnAssetLoaded = false;
+		FlowSubsystem->LoadSubFlow(this, SavedAssetInstanceName);
+		SavedAssetInstanceName = FString();
+		MarkSaveDirty();
+	}
+	else if (bStartOnAssetLoaded)
+	{
+		bStartOnAssetLoaded = false;
+		MarkSaveDirty();
+		FlowSubsystem->CreateSubFlow(this);
+	}
+	else if (bPreloaded)
+	{
+		FlowSubsystem->CreateSubFlow(this, FString(), true);
+	}
+}
+
+void UFlowNode_SubGraph::OnAssetLoadTimeout()
+{
+	LogWarning(FString::Printf(TEXT("Async loading of Flow Asset %s timed out after %.2f seconds, finishing it synchronously"), *Asset.ToString(), UFlowSettings::Get()->SubGraphLoadTimeout));
+	CompleteAssetLoad();
+}
+
+void UFlowNode_SubGraph::CompleteAssetLoad()
+{
+	// drop the streamable callback, as we complete the load here
+	if (AssetLoadHandle.IsValid())
+	{
+		AssetLoadHandle->CancelHandle();
+		AssetLoadHandle.Reset();
+	}
+
+	(void) Asset.LoadSynchronous();
+	OnAssetLoaded();
+}
+
 void UFlowNode_SubGraph::PreloadContent()
 {
 	if (CanBeAssetInstanced() && GetFlowSubsystem())
 	{
-		GetFlowSubsystem()->CreateSubFlow(this, FString(), true);
+		if (ShouldLoadAssetAsync())
+		{
+			// sub-flow will be preloaded once the asset is loaded
+			RequestAssetLoad();
+		}
+		else
+		{
+			GetFlowSubsystem()->CreateSubFlow(this, FString(), true);
+		}
 	}
 }
 
 void UFlowNode_SubGraph::FlushContent()
 {
+	CancelAssetLoad();
+
 	if (CanBeAssetInstanced() && GetFlowSubsystem())
 	{
 		GetFlowSubsystem()->RemoveSubFlow(this, EFlowFinishPolicy::Abort);
@@ -69,7 +179,13 @@ void UFlowNode_SubGraph::ExecuteInput(const FName& PinName)
 	
 	if (PinName == TEXT("Start"))
 	{
-		if (GetFlowSubsystem())
+		if (ShouldLoadAssetAsync())
+		{
+			bStartOnAssetLoaded = true;
+			MarkSaveDirty();
+			RequestAssetLoad();
+		}
+		else if (GetFlowSubsystem())
 		{
 			GetFlowSubsystem()->CreateSubFlow(this);
 		}
@@ -82,6 +198,8 @@ void UFlowNode_SubGraph::ExecuteInput(const FName& PinName)
 
 void UFlowNode_SubGraph::Cleanup()
 {
+	CancelAssetLoad();
+
 	if (CanBeAssetInstanced() && GetFlowSubsystem())
 	{
 		GetFlowSubsystem()->RemoveSubFlow(this, EFlowFinishPolicy::Keep);
@@ -97,8 +215,21 @@ void UFlowNode_SubGraph::OnLoad_Implementation()
 {
 	if (!SavedAssetInstanceName.IsEmpty() && !Asset.IsNull())
 	{
-		GetFlowSubsystem()->LoadSubFlow(this, SavedAssetInstanceName);
-		SavedAssetInstanceName = FString();
+		if (ShouldLoadAssetAsync())
+		{
+			bRestoreOnAssetLoaded = true;
+			RequestAssetLoad();
+		}
+		else
+		{
+			GetFlowSubsystem()->LoadSubFlow(this, SavedAssetInstanceName);
+			SavedAssetInstanceName = FString();
+		}
+	}
+	else if (bStartOnAssetLoaded && !Asset.IsNull())
+	{
+		// SaveGame was written while the asset was loading
+		RequestAssetLoad();
 	}
 }
 
@@ -24,6 +24,8 @@ UFlowNode_Counter::UFlowNode_Counter(const FObjectInitializer& ObjectInitializer
 	OutputPins.Add(FFlowPin(TEXT("Step")));
 	OutputPins.Add(FFlowPin(TEXT("Goal")));
 	OutputPins.Add(FFlowPin(TEXT("Skipped")));
+
+	SaveRecordReusableClass = StaticClass();
 }
 
 void UFlowNode_Counter::ExecuteInput(const FName& PinName)
@@ -31,6 +33,7 @@ void UFlowNode_Counter::ExecuteInput(const FName& PinName)
 	if (PinName == TEXT("Increment"))
 	{
 		CurrentSum++;
+		MarkSaveDirty();
 		if (CurrentSum == Goal)
 		{
 			TriggerOutput(TEXT("Goal"), true);
@@ -45,6 +48,7 @@ void UFlowNode_Counter::ExecuteInput(const FName& PinName)
 	if (PinName == TEXT("Decrement"))
 	{
 		CurrentSum--;
+		MarkSaveDirty();
 		if (CurrentSum == 0)
 		{
 			TriggerOutput(TEXT("Zero"), true);
@@ -20,12 +20,16 @@ UFlowNode_ExecutionMultiGate::UFlowNode_ExecutionMultiGate(const FObjectInitiali
 	InputPins.Add(FFlowPin(TEXT("Reset"), ResetPinTooltip));
 	SetNumberedOutputPins(0, 1);
 	AllowedSignalModes = {EFlowSignalMode::Enabled, EFlowSignalMode::Disabled};
+
+	SaveRecordReusableClass = StaticClass();
 }
 
 void UFlowNode_ExecutionMultiGate::ExecuteInput(const FName& PinName)
 {
 	if (PinName == DefaultInputPin.PinName)
 	{
+		MarkSaveDirty();
+
 		if (Completed.Num() == 0)
 		{
 			Completed.Init(false, OutputPins.Num());
@@ -15,6 +15,8 @@ UFlowNode_ExecutionSequence::UFlowNode_ExecutionSequence(const FObjectInitialize
 
 	SetNumberedOutputPins(0, 1);
 	AllowedSignalModes = {EFlowSignalMode::Enabled, EFlowSignalMode::Disabled};
+
+	SaveRecordReusableClass = StaticClass();
 }
 
 void UFlowNode_ExecutionSequence::ExecuteInput(const FName& PinName)
@@ -52,6 +54,7 @@ void UFlowNode_ExecutionSequence::ExecuteNewConnections()
 		if (!ExecutedConnections.Contains(Connection.NodeGuid))
 		{
 			ExecutedConnections.Emplace(Connection.NodeGuid);
+			MarkSaveDirty();
 			TriggerOutput(Output.PinName, false);
 		}
 	}
@@ -13,11 +13,18 @@ UFlowNode_LogicalAND::UFlowNode_LogicalAND(const FObjectInitializer& ObjectIniti
 #endif
 
 	SetNumberedInputPins(0, 1);
+
+	SaveRecordReusableClass = StaticClass();
 }
 
 void UFlowNode_LogicalAND::ExecuteInput(const FName& PinName)
 {
-	ExecutedInputNames.Add(PinName);
+	bool bAlreadyExecuted = false;
+	ExecutedInputNames.Add(PinName, &bAlreadyExecuted);
+	if (!bAlreadyExecuted)
+	{
+		MarkSaveDirty();
+	}
 
 	if (ExecutedInputNames.Num() == InputPins.Num())
 	{
@@ -18,6 +18,8 @@ UFlowNode_LogicalOR::UFlowNode_LogicalOR(const FObjectInitializer& ObjectInitial
 	SetNumberedInputPins(0, 1);
 	InputPins.Add(FFlowPin(TEXT("Enable"), TEXT("Enabling resets Execution Count")));
 	InputPins.Add(FFlowPin(TEXT("Disable"), TEXT("Disabling resets Execution Count")));
+
+	SaveRecordReusableClass = StaticClass();
 }
 
 void UFlowNode_LogicalOR::ExecuteInput(const FName& PinName)
@@ -28,6 +30,7 @@ void UFlowNode_LogicalOR::ExecuteInput(const FName& PinName)
 		{
 			ResetCounter();
 			bEnabled = true;
+			MarkSaveDirty();
 		}
 		return;
 	}
@@ -37,6 +40,7 @@ void UFlowNode_LogicalOR::ExecuteInput(const FName& PinName)
 		if (bEnabled)
 		{
 			bEnabled = false;
+			MarkSaveDirty();
 			Finish();
 		}
 		return;
@@ -49,6 +53,7 @@ void UFlowNode_LogicalOR::ExecuteInput(const FName& PinName)
 		{
 			bEnabled = false;
 		}
+		MarkSaveDirty();
 
 		TriggerFirstOutput(true);
 	}
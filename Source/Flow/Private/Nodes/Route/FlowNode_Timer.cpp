@@ -2,9 +2,7 @@
 
 #include "Nodes/Route/FlowNode_Timer.h"
 #include "FlowSettings.h"
-
-#include "Engine/World.h"
-#include "TimerManager.h"
+#include "FlowSubsystem.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNode_Timer)
 
@@ -35,6 +33,9 @@ UFlowNode_Timer::UFlowNode_Timer(const FObjectInitializer& ObjectInitializer)
 	OutputPins.Add(FFlowPin(TEXT("Skipped")));
 
 	INPIN_CompletionTime = GET_MEMBER_NAME_CHECKED(UFlowNode_Timer, CompletionTime);
+
+	// elapsed time is written in OnSave
+	SaveRecordReusableClass = nullptr;
 }
 
 void UFlowNode_Timer::InitializeInstance()
@@ -70,26 +71,26 @@ void UFlowNode_Timer::ExecuteInput(const FName& PinName)
 
 void UFlowNode_Timer::SetTimer()
 {
-	if (GetWorld())
+	if (GetFlowSubsystem())
 	{
 		if (StepTime > 0.0f)
 		{
-			GetWorld()->GetTimerManager().SetTimer(StepTimerHandle, this, &UFlowNode_Timer::OnStep, StepTime, true);
+			SetFlowTimer(StepTimerHandle, FFlowTimerDelegate::CreateUObject(this, &UFlowNode_Timer::OnStep), StepTime, true);
 		}
 
 		ResolvedCompletionTime = ResolveCompletionTime();
 		if (ResolvedCompletionTime > UE_KINDA_SMALL_NUMBER)
 		{
-			GetWorld()->GetTimerManager().SetTimer(CompletionTimerHandle, this, &UFlowNode_Timer::OnCompletion, ResolvedCompletionTime, false);
+			SetFlowTimer(CompletionTimerHandle, FFlowTimerDelegate::CreateUObject(this, &UFlowNode_Timer::OnCompletion), ResolvedCompletionTime, false);
 		}
 		else
 		{
-			GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UFlowNode_Timer::OnCompletion);
+			SetFlowTimerForNextTick(CompletionTimerHandle, FFlowTimerDelegate::CreateUObject(this, &UFlowNode_Timer::OnCompletion));
 		}
 	}
 	else
 	{
-		LogError(TEXT("No valid world"));
+		LogError(TEXT("No valid Flow Subsystem"));
 		TriggerOutput(TEXT("Completed"), true);
 	}
 }
@@ -142,34 +143,22 @@ void UFlowNode_Timer::OnCompletion()
 
 void UFlowNode_Timer::Cleanup()
 {
-	if (GetWorld())
-	{
-		GetWorld()->GetTimerManager().ClearTimer(CompletionTimerHandle);
-	}
-	CompletionTimerHandle.Invalidate();
-
-	if (GetWorld())
-	{
-		GetWorld()->GetTimerManager().ClearTimer(StepTimerHandle);
-	}
-	StepTimerHandle.Invalidate();
+	ClearFlowTimer(CompletionTimerHandle);
+	ClearFlowTimer(StepTimerHandle);
 
 	SumOfSteps = 0.0f;
 }
 
 void UFlowNode_Timer::OnSave_Implementation()
 {
-	if (GetWorld())
+	if (CompletionTimerHandle.IsValid())
 	{
-		if (CompletionTimerHandle.IsValid())
-		{
-			RemainingCompletionTime = GetWorld()->GetTimerManager().GetTimerRemaining(CompletionTimerHandle);
-		}
+		RemainingCompletionTime = GetFlowTimerRemaining(CompletionTimerHandle);
+	}
 
-		if (StepTimerHandle.IsValid())
-		{
-			RemainingStepTime = GetWorld()->GetTimerManager().GetTimerRemaining(StepTimerHandle);
-		}
+	if (StepTimerHandle.IsValid())
+	{
+		RemainingStepTime = GetFlowTimerRemaining(StepTimerHandle);
 	}
 }
 
@@ -179,10 +168,10 @@ void UFlowNode_Timer::OnLoad_Implementation()
 	{
 		if (RemainingStepTime > 0.0f)
 		{
-			GetWorld()->GetTimerManager().SetTimer(StepTimerHandle, this, &UFlowNode_Timer::OnStep, StepTime, true, RemainingStepTime);
+			SetFlowTimer(StepTimerHandle, FFlowTimerDelegate::CreateUObject(this, &UFlowNode_Timer::OnStep), StepTime, true, RemainingStepTime);
 		}
 
-		GetWorld()->GetTimerManager().SetTimer(CompletionTimerHandle, this, &UFlowNode_Timer::OnCompletion, RemainingCompletionTime, false);
+		SetFlowTimer(CompletionTimerHandle, FFlowTimerDelegate::CreateUObject(this, &UFlowNode_Timer::OnCompletion), RemainingCompletionTime, false);
 
 		RemainingStepTime = 0.0f;
 		RemainingCompletionTime = 0.0f;
@@ -242,9 +231,9 @@ FString UFlowNode_Timer::GetStatusString() const
 	{
 		ProgressString = FString::Printf(TEXT("%.*f"), 2, SumOfSteps);
 	}
-	else if (CompletionTimerHandle.IsValid() && GetWorld())
+	else if (CompletionTimerHandle.IsValid())
 	{
-		ProgressString = FString::Printf(TEXT("%.*f"), 2, GetWorld()->GetTimerManager().GetTimerElapsed(CompletionTimerHandle));
+		ProgressString = FString::Printf(TEXT("%.*f"), 2, GetFlowTimerElapsed(CompletionTimerHandle));
 	}
 
 	if (!ProgressString.IsEmpty())
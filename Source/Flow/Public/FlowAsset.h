@@ -10,6 +10,7 @@
 #include "FlowMessageLog.h"
 #endif
 
+#include "Containers/Ticker.h"
 #include "UObject/ObjectKey.h"
 #include "FlowAsset.generated.h"
 
@@ -17,6 +18,7 @@ class UFlowNode_CustomOutput;
 class UFlowNode_CustomInput;
 class UFlowNode_SubGraph;
 class UFlowSubsystem;
+struct FStreamableHandle;
 
 class UEdGraph;
 class UEdGraphNode;
@@ -69,6 +71,70 @@ struct FFlowHarvestDataPinsWorkingData
 	bool bPinNameMapChanged = false;
 };
 
+// Pin activation waiting in the signal queue of Flow Asset instance
+struct FFlowPendingSignal
+{
+	int32 NodeIndex;
+	int32 PinIndex;
+
+	FFlowPendingSignal(const int32 InNodeIndex, const int32 InPinIndex)
+		: NodeIndex(InNodeIndex)
+		, PinIndex(InPinIndex)
+	{
+	}
+};
+
+// Connection of an output pin, pointing to the input pin by indices in the compiled graph
+USTRUCT()
+struct FLOW_API FFlowCompiledEdge
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 NodeIndex = INDEX_NONE;
+
+	UPROPERTY()
+	int32 PinIndex = INDEX_NONE;
+
+	bool IsConnected() const { return NodeIndex != INDEX_NONE; }
+};
+
+/**
+ * Index-based copy of graph connections, used by runtime instead of hashing node GUIDs and pin names
+ * Every node has a dense index and output pins of all nodes are stored in a single flat array
+ */
+USTRUCT()
+struct FLOW_API FFlowCompiledGraph
+{
+	GENERATED_BODY()
+
+	// GUID of node at given index
+	UPROPERTY()
+	TArray<FGuid> NodeGuids;
+
+	// Index of the first output edge of every node, the last element is the total number of edges
+	UPROPERTY()
+	TArray<int32> FirstOutputEdges;
+
+	// Target of every output pin, in the order of node indices and output pins
+	UPROPERTY()
+	TArray<FFlowCompiledEdge> OutputEdges;
+
+	const FFlowCompiledEdge* FindOutputEdge(const int32 NodeIndex, const int32 OutputPinIndex) const
+	{
+		if (OutputPinIndex >= 0 && FirstOutputEdges.IsValidIndex(NodeIndex + 1) && NodeIndex >= 0)
+		{
+			const int32 EdgeIndex = FirstOutputEdges[NodeIndex] + OutputPinIndex;
+			if (EdgeIndex < FirstOutputEdges[NodeIndex + 1])
+			{
+				return &OutputEdges[EdgeIndex];
+			}
+		}
+
+		return nullptr;
+	}
+};
+
 /**
  * Single asset containing flow nodes.
  */
@@ -95,6 +161,12 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset")
 	bool bWorldBound;
 
+	// If enabled, asset instance creates node objects only when the node is activated, loaded from SaveGame or preloaded
+	// Until then, node lookups on the instance return the template node, which must be treated as read-only
+	// Saves memory and initialization time for large graphs instantiated many times, where most of nodes are never reached
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flow Asset")
+	bool bLazyNodeInstancing;
+
 //////////////////////////////////////////////////////////////////////////
 // Graph
 
@@ -107,6 +179,7 @@ public:
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 	virtual void PostDuplicate(bool bDuplicateForPIE) override;
 	virtual void PostLoad() override;
+	virtual void PreSave(FObjectPreSaveContext SaveContext) override;
 	// --
 
 public:
@@ -164,6 +237,10 @@ private:
 	UPROPERTY()
 	TMap<FGuid, TObjectPtr<UFlowNode>> Nodes;
 
+	// Built on saving the asset and after editing connections, instances read it from the template asset
+	UPROPERTY()
+	FFlowCompiledGraph CompiledGraph;
+
 #if WITH_EDITORONLY_DATA
 protected:
 	/**
@@ -214,6 +291,14 @@ protected:
 #endif
 
 public:
+	// Assigns dense indices to nodes in execution order and flattens connections of output pins
+	void CompileGraph();
+	bool IsGraphCompiled() const;
+
+	const FFlowCompiledGraph& GetCompiledGraph() const { return TemplateAsset ? TemplateAsset->CompiledGraph : CompiledGraph; }
+
+	// Node access doesn't create node instances
+	// If bLazyNodeInstancing is enabled, nodes of asset instance that haven't been instanced yet are template nodes, treat them as read-only
 	const TMap<FGuid, UFlowNode*>& GetNodes() const { return ObjectPtrDecay(Nodes); }
 	UFlowNode* GetNode(const FGuid& Guid) const { return Nodes.FindRef(Guid); }
 
@@ -233,6 +318,7 @@ public:
 	UFUNCTION(BlueprintPure, Category = "FlowAsset")
 	virtual UFlowNode* GetDefaultEntryNode() const;
 
+	// Walks connections without instancing nodes, see GetNodes() for nodes returned by lazily instanced asset
 	UFUNCTION(BlueprintPure, Category = "FlowAsset", meta = (DeterminesOutputType = "FlowNodeClass"))
 	TArray<UFlowNode*> GetNodesInExecutionOrder(UFlowNode* FirstIteratedNode, const TSubclassOf<UFlowNode> FlowNodeClass);
 
@@ -356,7 +442,14 @@ protected:
 	UPROPERTY()
 	TSet<TObjectPtr<UFlowNode>> PreloadedNodes;
 
+	// Async loads of content requested by predictive preloading, per index of the upcoming node
+	// Null handle means node has no content to load
+	TMap<int32, TSharedPtr<FStreamableHandle>> PredictivePreloads;
+
+	FTSTicker::FDelegateHandle PredictivePreloadHandle;
+
 	// Nodes that have any work left, not marked as Finished yet
+	// Kept in the order of activation, SaveInstance iterates this list instead of traversing the graph
 	UPROPERTY()
 	TArray<TObjectPtr<UFlowNode>> ActiveNodes;
 
@@ -364,8 +457,32 @@ protected:
 	UPROPERTY()
 	TArray<TObjectPtr<UFlowNode>> RecordedNodes;
 
+	// Nodes of this instance by index in the compiled graph, contains template nodes not instanced yet if bLazyNodeInstancing is enabled
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UFlowNode>> NodesByIndex;
+
 	EFlowFinishPolicy FinishPolicy;
 
+	// Number of node objects created for this instance, equals number of nodes unless bLazyNodeInstancing is enabled
+	int32 InstancedNodesNum;
+
+	// Version of data pin supplier chains cached by nodes of this asset
+	uint32 DataPinSupplierGeneration;
+
+	// Signals waiting for execution, used only if bUseSignalQueue is enabled in Flow Settings
+	// Stored as stack, so signals are executed in the same depth-first order as without the queue
+	// Signals triggered from outside of the queue are added to the bottom, so they don't overtake signals deferred to the next frame
+	TArray<FFlowPendingSignal> PendingSignals;
+
+	// True while executing signals from the queue, prevents recursive draining
+	bool bDrainingSignals;
+
+	// Signals executed in the current frame, used to apply MaxSignalsPerFrame budget
+	int32 SignalsInCurrentFrame;
+	uint64 SignalBudgetFrame;
+
+	FTSTicker::FDelegateHandle DeferredDrainHandle;
+
 public:
 	UE_DEPRECATED(5.4, "Use version that takes a UFlowAssetReference instead.")
 	virtual void InitializeInstance(const TWeakObjectPtr<UObject> InOwner, UFlowAsset* InTemplateAsset) { InitializeInstance(InOwner, *InTemplateAsset); }
@@ -376,6 +493,39 @@ public:
 
 	UFlowAsset* GetTemplateAsset() const { return TemplateAsset; }
 
+	// Returns runtime node object, creates it first if bLazyNodeInstancing is enabled and node hasn't been instanced yet
+	UFlowNode* GetOrCreateNodeInstance(const FGuid& NodeGuid);
+	UFlowNode* GetOrCreateNodeInstance(const int32 NodeIndex);
+	bool IsNodeInstanced(const UFlowNode* Node) const { return Node && Node->GetOuter() == this; }
+
+	// Returns runtime node object only if it already exists
+	UFlowNode* GetNodeInstance(const FGuid& NodeGuid) const
+	{
+		UFlowNode* Node = Nodes.FindRef(NodeGuid);
+		return IsNodeInstanced(Node) ? Node : nullptr;
+	}
+	int32 GetInstancedNodesNum() const { return InstancedNodesNum; }
+
+	// Invalidates supplier chains cached by nodes of this asset
+	// Needs to be called whenever nodes, connections or external data pin suppliers of this asset change
+	void InvalidateDataPinSupplierCache() { DataPinSupplierGeneration = DataPinSupplierGeneration == MAX_uint32 ? 1 : DataPinSupplierGeneration + 1; }
+	uint32 GetDataPinSupplierGeneration() const { return DataPinSupplierGeneration; }
+
+protected:
+	UFlowNode* CreateNodeInstance(UFlowNode* NodeTemplate);
+	void InitializeNodeInstance(UFlowNode* NodeInstance);
+
+	// Creates node objects in advance, without initializing them, used when warming up the instance pool
+	void PreinstantiateNodes();
+
+	// Instances with Blueprint nodes aren't pooled, the Blueprint ubergraph frame of used node can't be restored from the template
+	bool CanResetInstanceForPool() const;
+
+	// Clears runtime state of deinitialized instance, so it can be initialized again by the instance pool
+	void ResetInstanceForPool(const UFlowAsset& InTemplateAsset);
+
+public:
+
 	// Object that spawned Root Flow instance, i.e. World Settings or Player Controller
 	// This pointer is passed to child instances: Flow Asset instances created by the SubGraph nodes
 	UFUNCTION(BlueprintPure, Category = "Flow")
@@ -394,6 +544,19 @@ public:
 	// Opportunity to preload content of project-specific nodes
 	virtual void PreloadNodes() {}
 
+	// Preloads content of the given node, instancing the node if needed
+	UFlowNode* PreloadNode(const FGuid& NodeGuid);
+
+protected:
+	// Updates predictive preloading on the next tick, see UFlowSettings::PredictivePreloadDepth
+	void SchedulePredictivePreload();
+
+	// Requests content of nodes up to PredictivePreloadDepth connections ahead of active nodes, releases content of nodes out of range
+	void UpdatePredictivePreload();
+	void ClearPredictivePreloads();
+
+public:
+
 	virtual void PreStartFlow();
 	virtual void StartFlow(IFlowDataPinValueSupplierInterface* DataPinValueSupplier = nullptr);
 
@@ -411,6 +574,14 @@ protected:
 	void TriggerCustomOutput(const FName& EventName);
 
 	void TriggerInput(const FGuid& NodeGuid, const FName& PinName);
+	void TriggerInput(const int32 NodeIndex, const int32 PinIndex);
+	void ExecuteInput(const int32 NodeIndex, const int32 PinIndex);
+	void ExecuteInput(UFlowNode* Node, const int32 PinIndex);
+
+	// Executes queued signals until the queue is empty or the frame budget is spent
+	void DrainSignalQueue();
+	void ScheduleDeferredDrain();
+	void ClearSignalQueue();
 
 	void FinishNode(UFlowNode* Node);
 	void ResetNodes();
@@ -457,9 +628,29 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "SaveGame")
 	void LoadInstance(const FFlowAssetSaveData& AssetRecord);
 
+	// Forces serializing this asset instance on the next save, call it whenever SaveGame properties change
+	UFUNCTION(BlueprintCallable, Category = "SaveGame")
+	void MarkSaveDirty();
+
 protected:
 	virtual void OnActivationStateLoaded(UFlowNode* Node);
 
+	// Restores sub-flows still waiting for their asset to load, including nested ones
+	// Called before saving, as their records exist only in the loaded SaveGame
+	void CompletePendingSubFlowRestores();
+
+	// By default, asset data is reused only if the asset class doesn't declare its own SaveGame properties, nor implements OnSave in blueprint
+	// Override it, if every write of the SaveGame properties calls MarkSaveDirty
+	virtual bool CanReuseSaveRecord() const;
+
+	// Incremented on every change of the instance state, see UFlowSettings::bIncrementalSaving
+	uint32 SaveGeneration = 1;
+
+	// Asset data written by the last save and the state it was written from
+	TArray<uint8> CachedAssetData;
+	uint32 CachedSaveGeneration = 0;
+	uint32 CachedSaveTableSerial = 0;
+
 	UFUNCTION(BlueprintNativeEvent, Category = "SaveGame")
 	void OnSave();
 
@@ -4,6 +4,7 @@
 
 #include "Components/ActorComponent.h"
 #include "GameplayTagContainer.h"
+#include "Net/Serialization/FastArraySerializer.h"
 
 #include "FlowSave.h"
 #include "FlowTypes.h"
@@ -12,25 +13,102 @@
 
 class UFlowAsset;
 class UFlowSubsystem;
+class UNetConnection;
 
+// Action waiting for the Soft Root Flow asset to be loaded
+enum class EFlowSoftRootFlowAction : uint8
+{
+	None,
+	AutoStart,
+	Start,
+	Load
+};
+
+UENUM()
+enum class EFlowNotifyStreamType : uint8
+{
+	SentNotifyTags,
+	NotifyFromGraph,
+	NotifyFromAnotherComponent
+};
+
+/**
+ * Single notify call replicated by the Flow Component
+ */
 USTRUCT()
-struct FNotifyTagReplication
+struct FFlowNotifyStreamItem : public FFastArraySerializerItem
 {
 	GENERATED_BODY()
 
+	// Order of notifies sent by the owning component
+	UPROPERTY()
+	uint32 Sequence = 0;
+
+	UPROPERTY()
+	EFlowNotifyStreamType Type = EFlowNotifyStreamType::SentNotifyTags;
+
+	// Used only by notifies sent to another actor
 	UPROPERTY()
 	FGameplayTag ActorTag;
 
 	UPROPERTY()
-	FGameplayTag NotifyTag;
+	FGameplayTagContainer NotifyTags;
+};
+
+/**
+ * Replicates every notify sent by the Flow Component, in the order of sending
+ * Notifies sent within the same net update are delta-serialized together
+ * Notifies are removed once delivered to every connection replicating the owner
+ */
+USTRUCT()
+struct FFlowNotifyStream : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FFlowNotifyStreamItem> Items;
+
+	class UFlowComponent* OwnerComponent = nullptr;
 
-	FNotifyTagReplication() {}
+	// Server: sequence of the next added notify
+	uint32 NextSequence = 1;
 
-	FNotifyTagReplication(const FGameplayTag& InActorTag, const FGameplayTag& InNotifyTag)
-		: ActorTag(InActorTag)
-		, NotifyTag(InNotifyTag)
+	// Client: sequence of the last dispatched notify
+	uint32 LastDispatchedSequence = 0;
+
+	// Server: delivery of the stream to a single client connection
+	struct FConnectionAck
 	{
-	}
+		TWeakObjectPtr<UNetConnection> Connection;
+
+		// Last sequence sent to the connection, and the last packet that could carry it
+		uint32 SentSequence = 0;
+		int32 SentPacketId = INDEX_NONE;
+
+		// Last sequence the connection acknowledged
+		uint32 AckedSequence = 0;
+	};
+
+	TArray<FConnectionAck> ConnectionAcks;
+
+	void AddNotify(const EFlowNotifyStreamType Type, const FGameplayTag& ActorTag, const FGameplayTagContainer& NotifyTags);
+	void PruneDeliveredNotifies();
+
+	void PostReplicatedAdd(const TArrayView<int32>& AddedIndices, int32 FinalSize);
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+
+private:
+	void UpdateConnectionAck(const FNetDeltaSerializeInfo& DeltaParms);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFlowNotifyStream> : public TStructOpsTypeTraitsBase2<FFlowNotifyStream>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
 };
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FFlowComponentTagsReplicated, class UFlowComponent*, FlowComponent, const FGameplayTagContainer&, CurrentTags);
@@ -48,6 +126,7 @@ class FLOW_API UFlowComponent : public UActorComponent, public IFlowOwnerInterfa
 
 	friend class UFlowSubsystem;
 	
+	virtual void PostInitProperties() override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 	
 //////////////////////////////////////////////////////////////////////////
@@ -86,6 +165,29 @@ protected:
 	void UnregisterWithFlowSubsystem();
 	virtual void BeginRootFlow(bool bComponentLoadedFromSaveGame);
 
+	// Requests the load of Soft Root Flow, action is executed once the asset is loaded
+	void RequestSoftRootFlow(const EFlowSoftRootFlowAction Action);
+	void CancelSoftRootFlow();
+
+	// UFlowSubsystem-only access
+	void OnSoftRootFlowLoaded(UFlowAsset* LoadedAsset);
+
+	// Loads Soft Root Flow synchronously if it waits to be restored from SaveGame, UFlowSubsystem-only access
+	// Saving carries the loaded records forward instead, this is a fallback if the SaveGame table doesn't match them
+	void CompleteSoftRootFlowLoad();
+
+	EFlowSoftRootFlowAction PendingSoftRootFlowAction;
+
+	// This component is counted in the Root Flow load report, UFlowSubsystem-only access
+	bool bSoftRootFlowReported;
+	bool bSoftRootFlowWaited;
+
+	// Starts Root Flow on Begin Play, or queues the start if Flow Settings enable the startup queue
+	void AutoStartRootFlow();
+
+	// UFlowSubsystem-only access, saved as bRootFlowStartPending
+	bool bRootFlowStartQueued;
+
 private:
 	UFUNCTION()
 	void OnRep_AddedIdentityTags();
@@ -111,7 +213,8 @@ public:
 
 private:
 	// Stores only recently sent tags
-	UPROPERTY(ReplicatedUsing = OnRep_SentNotifyTags)
+	// Replicated only with the initial state of the component, later notifies update it through the notify stream
+	UPROPERTY(Replicated)
 	FGameplayTagContainer RecentlySentNotifyTags;
 
 public:
@@ -128,8 +231,7 @@ public:
 	void BulkNotifyGraph(const FGameplayTagContainer NotifyTags, const EFlowNetMode NetMode = EFlowNetMode::Authority);
 
 private:
-	UFUNCTION()
-	void OnRep_SentNotifyTags();
+	void BroadcastSentNotifyTags();
 
 public:
 	FFlowComponentNotify OnNotifyFromComponent;
@@ -137,19 +239,9 @@ public:
 //////////////////////////////////////////////////////////////////////////
 // Component receiving Notify Tags from Flow Graph
 
-private:
-	// Stores only recently replicated tags
-	UPROPERTY(ReplicatedUsing = OnRep_NotifyTagsFromGraph)
-	FGameplayTagContainer NotifyTagsFromGraph;
-
 public:
 	virtual void NotifyFromGraph(const FGameplayTagContainer& NotifyTags, const EFlowNetMode NetMode = EFlowNetMode::Authority);
 
-private:
-	UFUNCTION()
-	void OnRep_NotifyTagsFromGraph();
-
-public:
 	// Receive notification from Flow graph or another Flow Component
 	UPROPERTY(BlueprintAssignable, Category = "Flow")
 	FFlowComponentDynamicNotify ReceiveNotify;
@@ -157,19 +249,35 @@ public:
 //////////////////////////////////////////////////////////////////////////
 // Sending Notify Tags between Flow components
 
-private:
-	// Stores only recently replicated tags
-	UPROPERTY(ReplicatedUsing = OnRep_NotifyTagsFromAnotherComponent)
-	TArray<FNotifyTagReplication> NotifyTagsFromAnotherComponent;
-
 public:
 	// Send notification to another actor containing Flow Component
 	UFUNCTION(BlueprintCallable, Category = "Flow")
 	virtual void NotifyActor(const FGameplayTag ActorTag, const FGameplayTag NotifyTag, const EFlowNetMode NetMode = EFlowNetMode::Authority);
 
 private:
-	UFUNCTION()
-	void OnRep_NotifyTagsFromAnotherComponent();
+	void BroadcastNotifyToActor(const FGameplayTag& ActorTag, const FGameplayTagContainer& NotifyTags);
+
+//////////////////////////////////////////////////////////////////////////
+// Notify replication
+
+private:
+	friend struct FFlowNotifyStream;
+
+	// Sequence of the last notify sent before the component started replicating to the client
+	// Clients treat older notifies as history, so they aren't dispatched again when the actor becomes relevant
+	// Regular properties are received before the notify stream, so it's known when stream items arrive
+	UPROPERTY(Replicated)
+	uint32 InitialNotifySequence = 0;
+
+	// All notifies sent on the server, replicated in order
+	UPROPERTY(Replicated)
+	FFlowNotifyStream NotifyStream;
+
+	bool ShouldReplicateNotifies() const;
+	void ReplicateNotify(const EFlowNotifyStreamType Type, const FGameplayTag& ActorTag, const FGameplayTagContainer& NotifyTags);
+
+	// Called on clients for every received notify
+	void OnNotifyReplicated(const FFlowNotifyStreamItem& Notify);
 
 //////////////////////////////////////////////////////////////////////////
 // Root Flow
@@ -179,10 +287,19 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RootFlow")
 	TObjectPtr<UFlowAsset> RootFlow;
 
+	// Used if Root Flow isn't set, asset is loaded asynchronously when Root Flow is started or loaded from SaveGame
+	// Components referencing the same asset share a single load
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RootFlow")
+	TSoftObjectPtr<UFlowAsset> SoftRootFlow;
+
 	// If true, component will start Root Flow on Begin Play
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RootFlow")
 	bool bAutoStartRootFlow;
 
+	// Order of starting Root Flows queued on Begin Play, used if the startup queue is enabled in Flow Settings
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RootFlow", meta = (EditCondition = "bAutoStartRootFlow"))
+	EFlowStartPriority RootFlowStartPriority;
+
 	// Networking mode for creating this Root Flow
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RootFlow")
 	EFlowNetMode RootFlowMode;
@@ -194,6 +311,10 @@ public:
 	UPROPERTY(SaveGame)
 	FString SavedAssetInstanceName;
 
+	// Root Flow start was queued or waited for Soft Root Flow asset while saving, it's queued again after loading
+	UPROPERTY(SaveGame)
+	bool bRootFlowStartPending;
+
 	// This will instantiate Flow Asset assigned on this component.
 	// Created Flow Asset instance will be a "root flow", as additional Flow Assets can be instantiated via Sub Graph node
 	UFUNCTION(BlueprintCallable, Category = "RootFlow")
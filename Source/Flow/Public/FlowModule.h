@@ -4,9 +4,22 @@
 
 #include "Modules/ModuleInterface.h"
 
+#if WITH_EDITOR
+#include "UObject/UObjectGlobals.h"
+#endif
+
 class FFlowModule final : public IModuleInterface
 {
 public:
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+#if WITH_EDITOR
+private:
+	// Blueprint recompilation and hot reload invalidate cached FProperty pointers
+	void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap);
+	void OnReloadComplete(EReloadCompleteReason Reason);
+
+	static void ClearClassCaches();
+#endif
 };
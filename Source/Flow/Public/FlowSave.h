@@ -3,7 +3,9 @@
 #pragma once
 
 #include "GameFramework/SaveGame.h"
+#include "Serialization/ArchiveProxy.h"
 #include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "UObject/SoftObjectPath.h"
 #include "FlowSave.generated.h"
 
 USTRUCT(BlueprintType)
@@ -40,12 +42,33 @@ struct FLOW_API FFlowAssetSaveData
 	UPROPERTY(SaveGame, VisibleAnywhere, Category = "Flow")
 	TArray<FFlowNodeSaveData> NodeRecords;
 
+	// Records of active sub-flows, including their own sub-flows, written right before this record
+	UPROPERTY(SaveGame, VisibleAnywhere, Category = "Flow")
+	int32 SubFlowRecordsNum = 0;
+
 	friend FArchive& operator<<(FArchive& Ar, FFlowAssetSaveData& InAssetData)
 	{
 		return Ar;
 	}
 };
 
+/**
+ * Records written by the last OnGameSaved call
+ */
+USTRUCT(BlueprintType)
+struct FLOW_API FFlowSaveStats
+{
+	GENERATED_BODY()
+
+	// Records copied from the previous save, as their objects didn't change
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 ReusedRecords = 0;
+
+	// Records serialized again
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 SerializedRecords = 0;
+};
+
 USTRUCT(BlueprintType)
 struct FLOW_API FFlowComponentSaveData
 {
@@ -74,6 +97,117 @@ struct FLOW_API FFlowArchive : public FObjectAndNameAsStringProxyArchive
 	}
 };
 
+/**
+ * Names and object paths shared by all records of a single SaveGame
+ * Records written by FFlowCompactArchive store only indices to these arrays
+ */
+USTRUCT()
+struct FLOW_API FFlowSaveTable
+{
+	GENERATED_BODY()
+
+	UPROPERTY(SaveGame)
+	TArray<FName> Names;
+
+	UPROPERTY(SaveGame)
+	TArray<FSoftObjectPath> ObjectPaths;
+
+	int32 AddName(const FName& Name);
+	int32 AddObjectPath(const FSoftObjectPath& ObjectPath);
+
+	// Removes all entries, records written with the previous entries can't be loaded anymore
+	void Reset();
+
+	int32 Num() const { return Names.Num() + ObjectPaths.Num(); }
+
+	// Identifies this table, records cached for incremental saving can be reused only with the same table
+	uint32 GetSerialNumber() const { return SerialNumber; }
+
+private:
+	uint32 SerialNumber = ++NextSerialNumber;
+	static uint32 NextSerialNumber;
+
+	void BuildLookups();
+
+	TMap<FName, int32> NameLookup;
+	TMap<FSoftObjectPath, int32> ObjectPathLookup;
+
+public:
+	friend FArchive& operator<<(FArchive& Ar, FFlowSaveTable& SaveTable)
+	{
+		Ar << SaveTable.Names;
+		Ar << SaveTable.ObjectPaths;
+
+		if (Ar.IsLoading())
+		{
+			// loaded entries replace the previous ones
+			SaveTable.SerialNumber = ++NextSerialNumber;
+			SaveTable.BuildLookups();
+		}
+
+		return Ar;
+	}
+};
+
+struct FLOW_API FFlowSaveVersion
+{
+	enum Type : uint32
+	{
+		// Names and object references stored as varint indices to FFlowSaveTable
+		CompactArchive = 1,
+
+		// -----<new versions can be added above this line>-------------------------------------------------
+		VersionPlusOne,
+		LatestVersion = VersionPlusOne - 1
+	};
+
+	// Written at the beginning of every compact record, legacy records written by FFlowArchive don't have it
+	static constexpr uint32 Magic = 0x57464C46; // "FLFW"
+
+	// Written at the beginning of SaveGame data compressed by Flow Subsystem, see UFlowSaveGame::Serialize
+	static constexpr uint32 CompressedMagic = 0x5A464C46; // "FLFZ"
+};
+
+/**
+ * Save archive writing names and object references as varint indices to the per-save table, instead of full strings
+ */
+struct FLOW_API FFlowCompactArchive : public FArchiveProxy
+{
+	FFlowCompactArchive(FArchive& InInnerArchive, FFlowSaveTable& InSaveTable);
+
+	virtual FArchive& operator<<(FName& Value) override;
+	virtual FArchive& operator<<(UObject*& Value) override;
+	virtual FArchive& operator<<(FObjectPtr& Value) override;
+	virtual FArchive& operator<<(FWeakObjectPtr& Value) override;
+	virtual FArchive& operator<<(FSoftObjectPtr& Value) override;
+	virtual FArchive& operator<<(FSoftObjectPath& Value) override;
+
+protected:
+	void SerializeIndex(int32& Index);
+
+	FFlowSaveTable& SaveTable;
+};
+
+/**
+ * Serializes SaveGame properties of Flow objects into records
+ * Compact archive is used if the save table is provided, loading detects the format of the record
+ */
+struct FLOW_API FFlowSaveSerializer
+{
+	static void SaveObject(UObject& Object, TArray<uint8>& OutData, FFlowSaveTable* SaveTable);
+	static void LoadObject(UObject& Object, const TArray<uint8>& Data, FFlowSaveTable* SaveTable);
+
+	static bool IsCompactRecord(const TArray<uint8>& Data);
+
+	// True if classes between Class and AuditedClass declare SaveGame properties, AuditedClass itself isn't checked
+	static bool DeclaresSaveGameProperties(const UClass* Class, const UClass* AuditedClass);
+
+	// Whole SaveGame data, compressed data starts with FFlowSaveVersion::CompressedMagic
+	static bool CompressSaveData(const TArray<uint8>& Data, TArray<uint8>& OutCompressedData);
+	static bool DecompressSaveData(const TArray<uint8>& Data, TArray<uint8>& OutData);
+	static bool IsCompressedSaveData(const TArray<uint8>& Data);
+};
+
 UCLASS(BlueprintType)
 class FLOW_API UFlowSaveGame : public USaveGame
 {
@@ -90,11 +224,26 @@ public:
 
 	UPROPERTY(VisibleAnywhere, Category = "Flow")
 	TArray<FFlowAssetSaveData> FlowInstances;
+
+	// Shared by records written in the compact format
+	UPROPERTY()
+	FFlowSaveTable SaveTable;
+
+	// Set on the empty SaveGame written by UFlowSubsystem::SaveGameAsync if bCompressSaveGames is enabled
+	// The archive continues with compressed data of the captured SaveGame, loaded by Serialize
+	UPROPERTY()
+	bool bHasCompressedData = false;
+
+	// True if any record needs SaveTable to be loaded
+	bool HasCompactRecords() const;
+
+	virtual void Serialize(FArchive& Ar) override;
 	
 	friend FArchive& operator<<(FArchive& Ar, UFlowSaveGame& SaveGame)
 	{
 		Ar << SaveGame.FlowComponents;
 		Ar << SaveGame.FlowInstances;
+		Ar << SaveGame.SaveTable;
 		return Ar;
 	}
 };
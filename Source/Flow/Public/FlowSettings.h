@@ -7,6 +7,7 @@
 #include "UObject/SoftObjectPath.h"
 #include "FlowSettings.generated.h"
 
+class UFlowAsset;
 class UFlowNode;
 
 /**
@@ -28,9 +29,30 @@ class FLOW_API UFlowSettings : public UDeveloperSettings
 	UPROPERTY(Config, EditAnywhere, Category = "Networking")
 	bool bCreateFlowSubsystemOnClients;
 
+	// Notifies replicated by Flow Components are kept until every client acknowledged them
+	// This limits the notify stream if a client stops acknowledging, the oldest notifies are dropped then
+	UPROPERTY(Config, EditAnywhere, Category = "Networking", meta = (ClampMin = 1))
+	int32 MaxReplicatedNotifies;
+
 	UPROPERTY(Config, EditAnywhere, Category = "SaveSystem")
 	bool bWarnAboutMissingIdentityTags;
 
+	// If enabled, records written by Flow Subsystem store names and object references as indices to a table shared by the whole SaveGame
+	// This makes saves much smaller, records saved in the legacy format can still be loaded
+	UPROPERTY(Config, EditAnywhere, Category = "SaveSystem")
+	bool bUseCompactSaveArchive;
+
+	// If enabled, Flow Asset instances and nodes reuse their previous save record if nothing changed since the last save
+	// OnSave is called only for changed objects, activation state changes are tracked automatically
+	// Nodes declaring SaveGame properties are always serialized, unless the class opts in via SaveRecordReusableClass and calls MarkSaveDirty on every write
+	UPROPERTY(Config, EditAnywhere, Category = "SaveSystem")
+	bool bIncrementalSaving;
+
+	// If enabled, SaveGameAsync compresses the save file on the background thread
+	// UFlowSaveGame decompresses itself while loading, so the save is loaded by UGameplayStatics::LoadGameFromSlot as usual
+	UPROPERTY(Config, EditAnywhere, Category = "SaveSystem")
+	bool bCompressSaveGames;
+
 	// If enabled, runtime logs will be added when a flow node signal mode is set to Disabled
 	UPROPERTY(Config, EditAnywhere, Category = "Flow")
 	bool bLogOnSignalDisabled;
@@ -39,11 +61,89 @@ class FLOW_API UFlowSettings : public UDeveloperSettings
 	UPROPERTY(Config, EditAnywhere, Category = "Flow")
 	bool bLogOnSignalPassthrough;
 
+	// If enabled, signals between nodes are queued on the Flow Asset instance and executed in a loop
+	// This keeps the call stack flat for long chains of instant nodes, at the cost of triggering nodes after the current node returns
+	UPROPERTY(Config, EditAnywhere, Category = "Flow")
+	bool bUseSignalQueue;
+
+	// Maximum number of queued signals executed by a single Flow Asset instance per frame, remaining signals are executed next frame
+	// 0 means no limit
+	UPROPERTY(Config, EditAnywhere, Category = "Flow", meta = (EditCondition = "bUseSignalQueue", ClampMin = 0))
+	int32 MaxSignalsPerFrame;
+
+	// Maximum number of queued signals executed in a single drain of the queue, signals deferred to the next frame start a new count
+	// Exceeding this limit is treated as an infinite loop in the graph, the queue is discarded and an error is logged
+	UPROPERTY(Config, EditAnywhere, Category = "Flow", meta = (EditCondition = "bUseSignalQueue", ClampMin = 1))
+	int32 MaxSignalsBeforeLoopGuard;
+
+	// Maximum number of finished Flow Asset instances kept per template, reused on creating the next instance of the same template
+	// Properties of pooled nodes are restored from template nodes, native members not exposed to reflection must be reset in UFlowNode::ResetForPool
+	// Instances which instanced Blueprint nodes aren't pooled
+	// 0 disables pooling
+	UPROPERTY(Config, EditAnywhere, Category = "Flow", meta = (ClampMin = 0))
+	int32 MaxPooledInstancesPerTemplate;
+
+	// Number of instances created in advance for given assets, once the world initialized its actors
+	// Capped by MaxPooledInstancesPerTemplate
+	UPROPERTY(Config, EditAnywhere, Category = "Flow")
+	TMap<TSoftObjectPtr<UFlowAsset>, int32> PooledInstancesToWarmUp;
+
+	// If enabled, Sub Graph node loads its Flow Asset asynchronously and starts the sub-flow once loading completes
+	// Otherwise asset is loaded synchronously, blocking the game thread
+	UPROPERTY(Config, EditAnywhere, Category = "Flow")
+	bool bAsyncLoadSubGraphs;
+
+	// Priority of async loading Sub Graph assets, higher values are loaded first
+	UPROPERTY(Config, EditAnywhere, Category = "Flow", meta = (EditCondition = "bAsyncLoadSubGraphs"))
+	int32 SubGraphLoadPriority;
+
+	// Time in seconds after which the pending async load is completed synchronously
+	// 0 means no timeout
+	UPROPERTY(Config, EditAnywhere, Category = "Flow", meta = (EditCondition = "bAsyncLoadSubGraphs", ClampMin = 0.0f))
+	float SubGraphLoadTimeout;
+
+	// Number of connections followed from active nodes to find upcoming nodes
+	// Content of upcoming nodes is loaded asynchronously in advance and released once nodes fall out of range
+	// 0 disables predictive preloading
+	UPROPERTY(Config, EditAnywhere, Category = "Preloading", meta = (ClampMin = 0))
+	int32 PredictivePreloadDepth;
+
+	// Maximum number of upcoming nodes of given class having their content preloaded, per Flow Asset instance
+	// Nodes closer to active nodes take precedence, classes not listed here aren't limited
+	UPROPERTY(Config, EditAnywhere, Category = "Preloading", meta = (EditCondition = "PredictivePreloadDepth > 0"))
+	TMap<TSoftClassPtr<UFlowNode>, int32> PredictivePreloadBudgets;
+
+	// Priority of async loading requested by predictive preloading, higher values are loaded first
+	UPROPERTY(Config, EditAnywhere, Category = "Preloading", meta = (EditCondition = "PredictivePreloadDepth > 0"))
+	int32 PredictivePreloadPriority;
+
+	// Returns the budget of the most derived class listed in PredictivePreloadBudgets, INDEX_NONE if node class isn't limited
+	int32 GetPredictivePreloadBudget(const UClass* NodeClass, const UClass*& OutBudgetClass) const;
+
+	// If enabled, Flow Components auto-starting their Root Flow are queued in Flow Subsystem
+	// Queued Root Flows are started over next frames within the startup budget, in order of Root Flow Start Priority
+	UPROPERTY(Config, EditAnywhere, Category = "Startup")
+	bool bQueueRootFlowStarts;
+
+	// Maximum number of queued Root Flows started per frame, 0 means no limit
+	UPROPERTY(Config, EditAnywhere, Category = "Startup", meta = (EditCondition = "bQueueRootFlowStarts", ClampMin = 0))
+	int32 MaxRootFlowStartsPerFrame;
+
+	// Time in milliseconds spent per frame on starting queued Root Flows, 0 means no limit
+	// At least one Root Flow is started every frame, Story Critical ones are started regardless of the budget
+	UPROPERTY(Config, EditAnywhere, Category = "Startup", meta = (EditCondition = "bQueueRootFlowStarts", ClampMin = 0.0f))
+	float RootFlowStartBudgetMs;
+
 	// Adjust the Titles for FlowNodes to be more expressive than default
 	// by incorporating data that would otherwise go in the Description
 	UPROPERTY(EditAnywhere, config, Category = "Nodes")
 	bool bUseAdaptiveNodeTitles;
 
+	// Number of recent activations kept for every pin of node instance for debugging, older activations of the pin are discarded
+	// Not available in Shipping builds
+	UPROPERTY(EditAnywhere, config, Category = "Nodes", meta = (ClampMin = 0))
+	int32 PinActivationHistorySize;
+
 #if WITH_EDITOR
 	DECLARE_DELEGATE(FFlowSettingsEvent);
 	FFlowSettingsEvent OnAdaptiveNodeTitlesChanged;
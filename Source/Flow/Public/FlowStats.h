@@ -0,0 +1,51 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("Flow"), STATGROUP_Flow, STATCAT_Advanced);
+
+// Counts
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Flow Instances"), STAT_FlowInstances, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Nodes"), STAT_FlowActiveNodes, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Timers"), STAT_FlowActiveTimers, STATGROUP_Flow, FLOW_API);
+
+// Per-frame counters
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pin Activations"), STAT_FlowPinActivations, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Data Pin Resolves"), STAT_FlowDataPinResolves, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("SubFlow Creations"), STAT_FlowSubFlowCreations, STATGROUP_Flow, FLOW_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Queued Root Flow Starts"), STAT_FlowQueuedRootFlowStarts, STATGROUP_Flow, FLOW_API);
+
+// Timers
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TriggerInput"), STAT_FlowTriggerInput, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ExecuteInput"), STAT_FlowExecuteInput, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CreateFlowInstance"), STAT_FlowCreateFlowInstance, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("InitializeInstance"), STAT_FlowInitializeInstance, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SaveInstance"), STAT_FlowSaveInstance, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LoadInstance"), STAT_FlowLoadInstance, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Save Game"), STAT_FlowSaveGame, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Game"), STAT_FlowLoadGame, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("TickTimers"), STAT_FlowTickTimers, STATGROUP_Flow, FLOW_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("StartQueuedRootFlows"), STAT_FlowStartQueuedRootFlows, STATGROUP_Flow, FLOW_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(FLOW_API, Flow);
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(FLOW_API, FlowInstances);
+
+// Times the scope in "stat Flow" and CSV captures, falls back to an Insights event if stats are compiled out
+#if STATS
+#define FLOW_SCOPE_CYCLE_COUNTER(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_Flow##Name); \
+	CSV_SCOPED_TIMING_STAT(Flow, Name)
+#else
+#define FLOW_SCOPE_CYCLE_COUNTER(Name) \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Flow##Name); \
+	CSV_SCOPED_TIMING_STAT(Flow, Name)
+#endif
+
+// Increments per-frame counter in "stat Flow" and CSV captures
+#define FLOW_INC_FRAME_COUNTER(Name) \
+	INC_DWORD_STAT(STAT_Flow##Name); \
+	CSV_CUSTOM_STAT(Flow, Name, 1, ECsvCustomStatOp::Accumulate)
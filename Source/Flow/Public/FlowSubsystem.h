@@ -2,11 +2,17 @@
 
 #pragma once
 
+#include "Async/Future.h"
+#include "Containers/Ticker.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/World.h"
 #include "GameFramework/Actor.h"
 #include "GameplayTagContainer.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 
 #include "FlowComponent.h"
+#include "FlowTimerWheel.h"
 #include "FlowSubsystem.generated.h"
 
 class UFlowAsset;
@@ -18,6 +24,109 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FTaggedFlowComponentEvent, UFlowCom
 
 DECLARE_DELEGATE_OneParam(FNativeFlowAssetEvent, class UFlowAsset*);
 
+UENUM(BlueprintType)
+enum class EFlowSaveGameResult : uint8
+{
+	Saved,
+	Failed,
+
+	// Other SaveGame object has been requested for the same slot before capturing this one
+	// This SaveGame hasn't been captured nor written, state of the game is captured by the other request
+	Superseded
+};
+
+DECLARE_DELEGATE_OneParam(FFlowSaveGameCaptured, class UFlowSaveGame*);
+DECLARE_DELEGATE_TwoParams(FFlowSaveGameCompleted, class UFlowSaveGame*, const EFlowSaveGameResult);
+
+DECLARE_DELEGATE_OneParam(FNativeFlowComponentEvent, UFlowComponent*);
+DECLARE_DELEGATE_TwoParams(FNativeTaggedFlowComponentEvent, UFlowComponent*, const FGameplayTagContainer&);
+
+/**
+ * SaveGame waiting for its snapshot, requests for the same slot are coalesced into one
+ */
+USTRUCT()
+struct FFlowSaveGameRequest
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	TObjectPtr<UFlowSaveGame> SaveGame = nullptr;
+
+	int32 UserIndex = 0;
+
+	TArray<FFlowSaveGameCaptured> CapturedCallbacks;
+	TArray<FFlowSaveGameCompleted> CompletedCallbacks;
+};
+
+/**
+ * Native callbacks of the component observer, see UFlowSubsystem::AddComponentObserver
+ */
+struct FFlowComponentObserverCallbacks
+{
+	FNativeFlowComponentEvent OnComponentRegistered;
+	FNativeTaggedFlowComponentEvent OnComponentTagAdded;
+	FNativeTaggedFlowComponentEvent OnComponentTagRemoved;
+	FNativeFlowComponentEvent OnComponentUnregistered;
+};
+
+/**
+ * Deinitialized instances of a single Flow Asset template, waiting to be reused
+ */
+USTRUCT()
+struct FLOW_API FFlowInstancePool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<UFlowAsset>> Instances;
+
+	// Frame in which the matching instance was returned to the pool, instance isn't reused in the same frame
+	TArray<uint64> ReturnFrames;
+
+	// Instances taken from the pool
+	int32 Hits = 0;
+
+	// Instances created because the pool was empty
+	int32 Misses = 0;
+};
+
+/**
+ * Memory report entry of the soft Root Flow asset, see UFlowSubsystem::GetRootFlowLoadReport
+ */
+USTRUCT(BlueprintType)
+struct FLOW_API FFlowRootFlowLoadReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	FSoftObjectPath Asset;
+
+	// Registered Flow Components with this asset as the Soft Root Flow
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 Components = 0;
+
+	// Registered components which had to wait for the asset, sharing a single load request
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 WaitingComponents = 0;
+
+	// Async loads requested for this asset
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int32 LoadRequests = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	bool bLoaded = false;
+
+	// Size of the asset package on disk, as reported by the asset registry
+	// It's -1 if not available, which is common in cooked builds without the full asset registry
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int64 PackageSize = INDEX_NONE;
+
+	// Size of packages hard referenced by the asset, directly or indirectly, loaded together with it
+	// Packages shared with other assets are counted for each of them, these might be loaded already
+	UPROPERTY(BlueprintReadOnly, Category = "Flow")
+	int64 DependenciesSize = 0;
+};
+
 /**
  * Flow Subsystem
  * - manages lifetime of Flow Graphs
@@ -45,10 +154,45 @@ private:
 	UPROPERTY()
 	TMap<TObjectPtr<UFlowAsset>, TWeakObjectPtr<UObject>> RootInstances;
 
+	/* Root instances indexed by their owner, kept in sync with RootInstances */
+	TMultiMap<TWeakObjectPtr<const UObject>, UFlowAsset*> RootInstancesByOwner;
+
 	/* Assets instanced by Sub Graph nodes */
 	UPROPERTY()
 	TMap<TObjectPtr<UFlowNode_SubGraph>, TObjectPtr<UFlowAsset>> InstancedSubFlows;
 
+	/* Finished instances kept for reuse, per template asset */
+	UPROPERTY()
+	TMap<TObjectPtr<UFlowAsset>, FFlowInstancePool> InstancePools;
+
+	/* Prevents returning instances to the pool while all flows are being aborted */
+	bool bAbortingActiveFlows;
+
+	/* Async loading of Flow Assets, i.e. requested by Sub Graph nodes */
+	FStreamableManager StreamableManager;
+
+	/* Timers of all Flow nodes, advanced once per frame by the world time */
+	FFlowTimerWheel TimerWheel;
+
+	FTSTicker::FDelegateHandle TimerWheelTickHandle;
+	TWeakObjectPtr<UWorld> TimerWheelWorld;
+	double TimerWheelWorldTime;
+
+	/* Shared async load of the soft Root Flow asset, completed for all components waiting on it */
+	struct FRootFlowLoad
+	{
+		TSharedPtr<FStreamableHandle> Handle;
+		TArray<TWeakObjectPtr<UFlowComponent>> WaitingComponents;
+	};
+
+	TMap<FSoftObjectPath, FRootFlowLoad> RootFlowLoads;
+	TMap<FSoftObjectPath, FFlowRootFlowLoadReport> RootFlowLoadStats;
+
+	/* Components waiting for their Root Flow to be started within the startup budget, per priority */
+	TArray<TWeakObjectPtr<UFlowComponent>> QueuedRootFlowStarts[static_cast<int32>(EFlowStartPriority::Max)];
+
+	FTSTicker::FDelegateHandle RootFlowStartTickHandle;
+
 #if WITH_EDITOR
 public:
 	/* Called after creating the first instance of given Flow Asset */
@@ -89,6 +233,20 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem", meta = (DefaultToSelf = "Owner"))
 	virtual void FinishAllRootFlows(UObject* Owner, const EFlowFinishPolicy FinishPolicy);
 
+	/* Finishes Root Flows of all given owners at once, i.e. while despawning many actors */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem")
+	virtual void FinishRootFlowsOfOwners(const TArray<UObject*>& Owners, const EFlowFinishPolicy FinishPolicy);
+
+	/* Queues start of the component's Root Flow, started over next frames within the startup budget set in Flow Settings */
+	void QueueRootFlowStart(UFlowComponent* Component);
+
+	/* Immediately starts all queued Root Flows, i.e. before a cutscene relying on them */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem")
+	void FlushQueuedRootFlowStarts();
+
+	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
+	int32 GetQueuedRootFlowStartsNum() const;
+
 protected:
 	UFlowAsset* CreateSubFlow(UFlowNode_SubGraph* SubGraphNode, const FString& SavedInstanceName = FString(), const bool bPreloading = false);
 	void RemoveSubFlow(UFlowNode_SubGraph* SubGraphNode, const EFlowFinishPolicy FinishPolicy);
@@ -99,6 +257,60 @@ public:
 	virtual void AddInstancedTemplate(UFlowAsset* Template);
 	virtual void RemoveInstancedTemplate(UFlowAsset* Template);
 
+	/* Creates instances of given asset in advance, so the next CreateFlowInstance calls can reuse them */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem")
+	void WarmUpInstancePool(UFlowAsset* Template, const int32 InstancesNum);
+
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem")
+	void EmptyInstancePools();
+
+	const FFlowInstancePool* GetInstancePool(UFlowAsset* Template) const { return InstancePools.Find(Template); }
+
+	FStreamableManager& GetStreamableManager() { return StreamableManager; }
+
+	FFlowTimerWheel& GetTimerWheel() { return TimerWheel; }
+	const FFlowTimerWheel& GetTimerWheel() const { return TimerWheel; }
+
+	/* Lists soft Root Flow assets used by registered Flow Components, and how many of them are still not loaded */
+	UFUNCTION(BlueprintCallable, Category = "FlowSubsystem")
+	TArray<FFlowRootFlowLoadReport> GetRootFlowLoadReport() const;
+
+	/* Logs the report, deferred size sums up PackageSize and DependenciesSize of assets not loaded */
+	void LogRootFlowLoadReport() const;
+
+protected:
+	UFlowAsset* TakeInstanceFromPool(UFlowAsset* Template, const FString& NewInstanceName);
+	void ReturnInstanceToPool(UFlowAsset* Instance, UFlowAsset* Template);
+
+	void OnWorldInitializedActors(const UWorld::FActorsInitializedParams& Params);
+
+	bool TickTimerWheel(float DeltaTime);
+
+	void AddRootInstance(UObject* Owner, UFlowAsset* Instance);
+	bool RemoveRootInstance(UFlowAsset* Instance);
+
+	void AddSoftRootFlowComponent(UFlowComponent* Component);
+	void RemoveSoftRootFlowComponent(UFlowComponent* Component);
+
+	/* Loads the soft Root Flow asset, components requesting the same asset share a single load */
+	void RequestRootFlowLoad(UFlowComponent* Component, const TSoftObjectPtr<UFlowAsset>& FlowAsset);
+	void CancelRootFlowLoad(UFlowComponent* Component, const TSoftObjectPtr<UFlowAsset>& FlowAsset);
+	void OnRootFlowLoaded(FSoftObjectPath AssetPath);
+
+	bool TickQueuedRootFlowStarts(float DeltaTime);
+
+	/* Starts queued Root Flows in order of priority, lower priorities wait until higher ones are started */
+	void StartQueuedRootFlows(const bool bIgnoreBudget);
+
+#if CSV_PROFILER
+	/* Records instance counts of every template at the end of CSV profiler frame */
+	void RecordCsvInstanceStats();
+
+	FDelegateHandle CsvProfileEndFrameHandle;
+#endif
+
+public:
+
 	/* Returns all assets instanced by object from another system like World Settings */
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
 	TMap<UObject*, UFlowAsset*> GetRootInstances() const;
@@ -137,6 +349,99 @@ public:
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem")
 	UFlowSaveGame* GetLoadedSaveGame() const { return LoadedSaveGame; }
 
+	/**
+	 * Finds record of Flow Asset instance in the loaded SaveGame
+	 * @param bMatchWorld If true, only record saved in the current world is accepted
+	 */
+	const FFlowAssetSaveData* FindLoadedAssetRecord(const FString& InstanceName, const bool bMatchWorld) const;
+	int32 FindLoadedAssetRecordIndex(const FString& InstanceName, const bool bMatchWorld) const;
+
+	/* Finds record of Flow Component in the loaded SaveGame, saved in the current world */
+	const FFlowComponentSaveData* FindLoadedComponentRecord(const FString& ActorInstanceName) const;
+
+	/* Table used to write compact records, available only during OnGameSaved and if enabled in Flow Settings */
+	FFlowSaveTable* GetSaveTableForSaving();
+
+	/* Table used to read compact records of the loaded SaveGame */
+	FFlowSaveTable* GetSaveTableForLoading() const;
+
+	/* Serial number of the table used for saving, zero if records are written in the legacy format */
+	uint32 GetSaveTableSerialForSaving() const;
+
+	/* Counters of records reused and serialized by the last OnGameSaved */
+	UPROPERTY(BlueprintReadOnly, Category = "FlowSubsystem")
+	FFlowSaveStats LastSaveStats;
+
+protected:
+	/* Rebuilds lookup of the loaded SaveGame records by instance name */
+	void BuildLoadedRecordIndices();
+
+	/* SaveGame currently written by OnGameSaved */
+	UPROPERTY(Transient)
+	TObjectPtr<UFlowSaveGame> SavingGame;
+
+	/**
+	 * Names and object paths of compact records, kept between saves so unchanged records can be reused
+	 * Only extended by saving, every SaveGame receives its copy. Rebuilt only when it grew twice since the last compaction
+	 */
+	FFlowSaveTable SaveTable;
+	int32 SaveTableEntriesAfterCompaction = 0;
+	bool bCompactingSaveTable = false;
+
+	/**
+	 * Adopts the table of SaveGame with records of other worlds, or compacts the table if it grew too much
+	 * @param RequiredTable Table indexed by records copied into SaveGame, it's adopted instead of compacting
+	 * @return False if records of other worlds index a different table than RequiredTable
+	 */
+	bool PrepareSaveTable(const UFlowSaveGame& SaveGame, const FFlowSaveTable* RequiredTable);
+
+	/* Copies loaded records of Soft Root Flows waiting for their asset, including records of their sub-flows */
+	void GatherPendingRootFlowRecords(TArray<TWeakObjectPtr<UFlowComponent>>& OutComponents, TArray<FFlowAssetSaveData>& OutRecords) const;
+
+	/* Indices of LoadedSaveGame->FlowInstances by instance name */
+	TMultiMap<FString, int32> LoadedAssetRecordIndices;
+
+	/* Indices of LoadedSaveGame->FlowComponents by actor instance name */
+	TMultiMap<FString, int32> LoadedComponentRecordIndices;
+
+public:
+	/**
+	 * Captures the state of Flow Graphs and Flow Components into SaveGame at the end of the frame, then writes it to the slot on a background thread
+	 * Requests for the same slot and SaveGame object made before capturing are coalesced, all their callbacks receive it
+	 * Request with other SaveGame object for the same slot supersedes the pending one, which is completed with EFlowSaveGameResult::Superseded
+	 * Only one write is in flight at the time, requests made during the write are captured after it
+	 */
+	virtual void SaveGameAsync(UFlowSaveGame* SaveGame, const int32 UserIndex, const FFlowSaveGameCompleted& OnCompleted = FFlowSaveGameCompleted(),
+		const FFlowSaveGameCaptured& OnCaptured = FFlowSaveGameCaptured());
+
+	bool IsWritingSaveGame() const { return InFlightSaveGame != nullptr; }
+
+	/* Blocks until the in-flight write and all pending requests are written */
+	void FlushSaveGameWrites();
+
+	/* SaveGame of the request waiting for capture, passing it to SaveGameAsync coalesces with that request */
+	UFlowSaveGame* GetPendingSaveGame(const FString& SlotName, const int32 UserIndex) const;
+
+protected:
+	bool TickSaveGameRequests(float DeltaTime);
+	void StartSaveGameWrite();
+	void OnSaveGameWritten(const bool bSuccess);
+
+	UPROPERTY(Transient)
+	TArray<FFlowSaveGameRequest> PendingSaveRequests;
+
+	FTSTicker::FDelegateHandle SaveGameTickHandle;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UFlowSaveGame> InFlightSaveGame;
+
+	TArray<FFlowSaveGameCompleted> InFlightSaveCallbacks;
+
+	TFuture<bool> SaveGameWriteTask;
+	uint32 SaveGameWriteSerial;
+
+public:
+
 //////////////////////////////////////////////////////////////////////////
 // Component Registry
 
@@ -144,6 +449,23 @@ protected:
 	/* All the Flow Components currently existing in the world */
 	TMultiMap<FGameplayTag, TWeakObjectPtr<UFlowComponent>> FlowComponentRegistry;
 
+	/* Flow Components registered under every Identity Tag and all its parent tags, used by non-exact queries
+	 * Value counts how many Identity Tags of the component contributed to this entry */
+	TMap<FGameplayTag, TMap<TWeakObjectPtr<UFlowComponent>, int32>> FlowComponentHierarchyRegistry;
+
+	struct FComponentObserver
+	{
+		FGameplayTagContainer IdentityTags;
+		bool bExactMatch = true;
+		FFlowComponentObserverCallbacks Callbacks;
+	};
+
+	/* Native observers of the component registry */
+	TMap<FDelegateHandle, FComponentObserver> ComponentObservers;
+
+	/* Component observers indexed by each of their Identity Tags */
+	TMultiMap<FGameplayTag, FDelegateHandle> ComponentObserversByTag;
+
 protected:
 	virtual void RegisterComponent(UFlowComponent* Component);
 	virtual void OnIdentityTagAdded(UFlowComponent* Component, const FGameplayTag& AddedTag);
@@ -153,6 +475,29 @@ protected:
 	virtual void OnIdentityTagRemoved(UFlowComponent* Component, const FGameplayTag& RemovedTag);
 	virtual void OnIdentityTagsRemoved(UFlowComponent* Component, const FGameplayTagContainer& RemovedTags);
 
+	void AddToRegistry(UFlowComponent* Component, const FGameplayTag& Tag);
+	void RemoveFromRegistry(UFlowComponent* Component, const FGameplayTag& Tag);
+
+	/* Collects observers that might be interested in the component identified by given tags */
+	void FindComponentObservers(const FGameplayTagContainer& ComponentTags, const FGameplayTagContainer& ChangedTags, TArray<FDelegateHandle, TInlineAllocator<16>>& OutObservers) const;
+
+	void NotifyComponentRegistered(UFlowComponent* Component, const FGameplayTagContainer& AddedTags);
+	void NotifyComponentTagAdded(UFlowComponent* Component, const FGameplayTagContainer& AddedTags);
+	void NotifyComponentTagRemoved(UFlowComponent* Component, const FGameplayTagContainer& RemovedTags);
+	void NotifyComponentUnregistered(UFlowComponent* Component, const FGameplayTagContainer& RemovedTags);
+
+public:
+	/**
+	 * Registers native callbacks for changes in the component registry.
+	 * Unlike OnComponentRegistered and similar delegates, callbacks are called only for components having at least one tag matching given Identity Tags.
+	 * Callbacks still need to validate the full match, i.e. if all tags are required.
+	 *
+	 * @param IdentityTags Tags to match against Identity Tags of registered Flow Components
+	 * @param bExactMatch If false, callbacks are also called for components having child tags of given Identity Tags
+	 */
+	FDelegateHandle AddComponentObserver(const FGameplayTagContainer& IdentityTags, const bool bExactMatch, FFlowComponentObserverCallbacks&& Callbacks);
+	void RemoveComponentObserver(FDelegateHandle& ObserverHandle);
+
 public:
 	/* Called when actor with Flow Component appears in the world */
 	UPROPERTY(BlueprintAssignable, Category = "FlowSubsystem")
@@ -177,7 +522,7 @@ public:
 	 * 
 	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
 	 * @param ComponentClass Only components matching this class we'll be returned
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching.
 	 */
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ComponentClass"))
 	TSet<UFlowComponent*> GetFlowComponentsByTag(const FGameplayTag Tag, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch = true) const;
@@ -188,7 +533,7 @@ public:
 	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
 	 * @param MatchType If Any, returned component needs to have only one of given tags. If All, component needs to have all given Identity Tags
 	 * @param ComponentClass Only components matching this class we'll be returned
-	* @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	* @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching.
 	 */
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ComponentClass"))
 	TSet<UFlowComponent*> GetFlowComponentsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<UFlowComponent> ComponentClass, const bool bExactMatch = true) const;
@@ -198,7 +543,7 @@ public:
 	 * 
 	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
 	 * @param ActorClass Only actors matching this class we'll be returned
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching.
 	 */
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ActorClass"))
 	TSet<AActor*> GetFlowActorsByTag(const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
@@ -209,7 +554,7 @@ public:
 	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
 	 * @param MatchType If Any, returned component needs to have only one of given tags. If All, component needs to have all given Identity Tags
 	 * @param ActorClass Only actors matching this class we'll be returned
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching.
 	 */
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ActorClass"))
 	TSet<AActor*> GetFlowActorsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
@@ -219,7 +564,7 @@ public:
 	 * 
 	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
 	 * @param ActorClass Only actors matching this class we'll be returned
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching.
 	 */
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ActorClass"))
 	TMap<AActor*, UFlowComponent*> GetFlowActorsAndComponentsByTag(const FGameplayTag Tag, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
@@ -230,7 +575,7 @@ public:
 	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
 	 * @param MatchType If Any, returned component needs to have only one of given tags. If All, component needs to have all given Identity Tags
 	 * @param ActorClass Only actors matching this class we'll be returned
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching.
 	 */
 	UFUNCTION(BlueprintPure, Category = "FlowSubsystem", meta = (DeterminesOutputType = "ActorClass"))
 	TMap<AActor*, UFlowComponent*> GetFlowActorsAndComponentsByTags(const FGameplayTagContainer Tags, const EGameplayContainerMatchType MatchType, const TSubclassOf<AActor> ActorClass, const bool bExactMatch = true) const;
@@ -240,27 +585,22 @@ public:
 	 * 
 	 * @tparam T Only components matching this class we'll be returned
 	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching.
 	 */
 	template <class T>
 	TSet<TWeakObjectPtr<T>> GetComponents(const FGameplayTag& Tag, const bool bExactMatch = true) const
 	{
 		static_assert(TPointerIsConvertibleFromTo<T, const UActorComponent>::Value, "'T' template parameter to GetComponents must be derived from UActorComponent");
 
-		TArray<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-		FindComponents(Tag, bExactMatch, FoundComponents);
-
 		TSet<TWeakObjectPtr<T>> Result;
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+		VisitComponents(Tag, bExactMatch, [&Result](UFlowComponent* Component)
 		{
-			if (Component.IsValid())
+			if (T* ComponentOfClass = Cast<T>(Component))
 			{
-				if (T* ComponentOfClass = Cast<T>(Component))
-				{
-					Result.Emplace(ComponentOfClass);
-				}
+				Result.Emplace(ComponentOfClass);
 			}
-		}
+			return true;
+		});
 
 		return Result;
 	}
@@ -271,27 +611,22 @@ public:
 	 * @tparam T Only components matching this class we'll be returned
 	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
 	 * @param MatchType If Any, returned component needs to have only one of given tags. If All, component needs to have all given Identity Tags
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching.
 	 */
 	template <class T>
 	TSet<TWeakObjectPtr<T>> GetComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch = true) const
 	{
 		static_assert(TPointerIsConvertibleFromTo<T, const UActorComponent>::Value, "'T' template parameter to GetComponents must be derived from UActorComponent");
 
-		TSet<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-		FindComponents(Tags, MatchType, bExactMatch, FoundComponents);
-
 		TSet<TWeakObjectPtr<T>> Result;
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+		VisitComponents(Tags, MatchType, bExactMatch, [&Result](UFlowComponent* Component)
 		{
-			if (Component.IsValid())
+			if (T* ComponentOfClass = Cast<T>(Component))
 			{
-				if (T* ComponentOfClass = Cast<T>(Component))
-				{
-					Result.Emplace(ComponentOfClass);
-				}
+				Result.Emplace(ComponentOfClass);
 			}
-		}
+			return true;
+		});
 
 		return Result;
 	}
@@ -301,27 +636,22 @@ public:
 	 * 
 	 * @tparam T Only components matching this class we'll be returned
 	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching.
 	 */
 	template <class T>
 	TSet<TWeakObjectPtr<T>> GetActors(const FGameplayTag& Tag, const bool bExactMatch = true) const
 	{
 		static_assert(TPointerIsConvertibleFromTo<T, const AActor>::Value, "'T' template parameter to GetActors must be derived from AActor");
 
-		TArray<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-		FindComponents(Tag, bExactMatch, FoundComponents);
-
 		TSet<TWeakObjectPtr<T>> Result;
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+		VisitComponents(Tag, bExactMatch, [&Result](UFlowComponent* Component)
 		{
-			if (Component.IsValid())
+			if (T* ActorOfClass = Cast<T>(Component->GetOwner()))
 			{
-				if (T* ActorOfClass = Cast<T>(Component->GetOwner()))
-				{
-					Result.Emplace(ActorOfClass);
-				}
+				Result.Emplace(ActorOfClass);
 			}
-		}
+			return true;
+		});
 
 		return Result;
 	}
@@ -332,27 +662,22 @@ public:
 	 * @tparam T Only actors matching this class we'll be returned
 	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
 	 * @param MatchType If Any, returned component needs to have only one of given tags. If All, component needs to have all given Identity Tags
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching.
 	 */
 	template <class T>
 	TSet<TWeakObjectPtr<T>> GetActors(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch = true) const
 	{
 		static_assert(TPointerIsConvertibleFromTo<T, const AActor>::Value, "'T' template parameter to GetActors must be derived from AActor");
 
-		TSet<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-		FindComponents(Tags, MatchType, bExactMatch, FoundComponents);
-
 		TSet<TWeakObjectPtr<T>> Result;
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+		VisitComponents(Tags, MatchType, bExactMatch, [&Result](UFlowComponent* Component)
 		{
-			if (Component.IsValid())
+			if (T* ActorOfClass = Cast<T>(Component->GetOwner()))
 			{
-				if (T* ActorOfClass = Cast<T>(Component->GetOwner()))
-				{
-					Result.Emplace(ActorOfClass);
-				}
+				Result.Emplace(ActorOfClass);
 			}
-		}
+			return true;
+		});
 
 		return Result;
 	}
@@ -363,7 +688,7 @@ public:
 	 * @tparam ActorT Only actors matching this class we'll be returned
 	 * @tparam ComponentT Only components matching this class we'll be returned
 	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching.
 	 */
 	template <class ActorT, class ComponentT>
 	TMap<TWeakObjectPtr<ActorT>, TWeakObjectPtr<ComponentT>> GetActorsAndComponents(const FGameplayTag& Tag, const bool bExactMatch = true) const
@@ -371,22 +696,17 @@ public:
 		static_assert(TPointerIsConvertibleFromTo<ActorT, const AActor>::Value, "'ActorT' template parameter to GetActorsAndComponents must be derived from AActor");
 		static_assert(TPointerIsConvertibleFromTo<ComponentT, const UActorComponent>::Value, "'ComponentT' template parameter to GetActorsAndComponents must be derived from UActorComponent");
 
-		TArray<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-		FindComponents(Tag, bExactMatch, FoundComponents);
-
 		TMap<TWeakObjectPtr<ActorT>, TWeakObjectPtr<ComponentT>> Result;
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+		VisitComponents(Tag, bExactMatch, [&Result](UFlowComponent* Component)
 		{
-			if (Component.IsValid())
+			ComponentT* ComponentOfClass = Cast<ComponentT>(Component);
+			ActorT* ActorOfClass = Cast<ActorT>(Component->GetOwner());
+			if (ComponentOfClass && ActorOfClass)
 			{
-				ComponentT* ComponentOfClass = Cast<ComponentT>(Component);
-				ActorT* ActorOfClass = Cast<ActorT>(Component->GetOwner());
-				if (ComponentOfClass && ActorOfClass)
-				{
-					Result.Emplace(ActorOfClass, ComponentOfClass);
-				}
+				Result.Emplace(ActorOfClass, ComponentOfClass);
 			}
-		}
+			return true;
+		});
 
 		return Result;
 	}
@@ -398,7 +718,7 @@ public:
 	 * @tparam ComponentT Only components matching this class we'll be returned
 	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
 	 * @param MatchType If Any, returned component needs to have only one of given tags. If All, component needs to have all given Identity Tags
-	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching. Be careful, using latter option may be very expensive, as the search cost is proportional to the number of registered Gameplay Tags!
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching.
 	 */
 	template <class ActorT, class ComponentT>
 	TMap<TWeakObjectPtr<ActorT>, TWeakObjectPtr<ComponentT>> GetActorsAndComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch = true) const
@@ -406,27 +726,243 @@ public:
 		static_assert(TPointerIsConvertibleFromTo<ActorT, const AActor>::Value, "'ActorT' template parameter to GetActorsAndComponents must be derived from AActor");
 		static_assert(TPointerIsConvertibleFromTo<ComponentT, const UActorComponent>::Value, "'ComponentT' template parameter to GetActorsAndComponents must be derived from UActorComponent");
 
-		TSet<TWeakObjectPtr<UFlowComponent>> FoundComponents;
-		FindComponents(Tags, MatchType, bExactMatch, FoundComponents);
-
 		TMap<TWeakObjectPtr<ActorT>, TWeakObjectPtr<ComponentT>> Result;
-		for (const TWeakObjectPtr<UFlowComponent>& Component : FoundComponents)
+		VisitComponents(Tags, MatchType, bExactMatch, [&Result](UFlowComponent* Component)
 		{
-			if (Component.IsValid())
+			ComponentT* ComponentOfClass = Cast<ComponentT>(Component);
+			ActorT* ActorOfClass = Cast<ActorT>(Component->GetOwner());
+			if (ComponentOfClass && ActorOfClass)
 			{
-				ComponentT* ComponentOfClass = Cast<ComponentT>(Component);
-				ActorT* ActorOfClass = Cast<ActorT>(Component->GetOwner());
-				if (ComponentOfClass && ActorOfClass)
+				Result.Emplace(ActorOfClass, ComponentOfClass);
+			}
+			return true;
+		});
+
+		return Result;
+	}
+
+	/**
+	 * Adds all registered Flow Components identified by given tag to the provided array, without allocating any temporary containers
+	 * Every component is added only once, array isn't emptied before adding components
+	 * 
+	 * @tparam T Only components matching this class we'll be added
+	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
+	 */
+	template <class T, typename AllocatorType>
+	void FindComponents(const FGameplayTag& Tag, const bool bExactMatch, TArray<T*, AllocatorType>& OutComponents) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<T, const UActorComponent>::Value, "'T' template parameter to FindComponents must be derived from UActorComponent");
+
+		VisitComponents(Tag, bExactMatch, [&OutComponents](UFlowComponent* Component)
+		{
+			if (T* ComponentOfClass = Cast<T>(Component))
+			{
+				OutComponents.Emplace(ComponentOfClass);
+			}
+			return true;
+		});
+	}
+
+	/**
+	 * Adds all registered Flow Components identified by Any or All provided tags to the provided array, without allocating any temporary containers
+	 * Every component is added only once, array isn't emptied before adding components
+	 * 
+	 * @tparam T Only components matching this class we'll be added
+	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
+	 * @param MatchType If Any, component needs to have only one of given tags. If All, component needs to have all given Identity Tags
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
+	 */
+	template <class T, typename AllocatorType>
+	void FindComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TArray<T*, AllocatorType>& OutComponents) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<T, const UActorComponent>::Value, "'T' template parameter to FindComponents must be derived from UActorComponent");
+
+		VisitComponents(Tags, MatchType, bExactMatch, [&OutComponents](UFlowComponent* Component)
+		{
+			if (T* ComponentOfClass = Cast<T>(Component))
+			{
+				OutComponents.Emplace(ComponentOfClass);
+			}
+			return true;
+		});
+	}
+
+	/**
+	 * Adds owners of all registered Flow Components identified by given tag to the provided array, temporary set allocates only for large results
+	 * Every actor is added only once, array isn't emptied before adding actors
+	 * 
+	 * @tparam T Only actors matching this class we'll be added
+	 * @param Tag Tag to check if it matches Identity Tags of registered Flow Components
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
+	 */
+	template <class T, typename AllocatorType>
+	void FindActors(const FGameplayTag& Tag, const bool bExactMatch, TArray<T*, AllocatorType>& OutActors) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<T, const AActor>::Value, "'T' template parameter to FindActors must be derived from AActor");
+
+		// actor might own multiple Flow Components, set keeps deduplication linear and doesn't allocate for small results
+		TSet<T*, DefaultKeyFuncs<T*>, TInlineSetAllocator<64>> AddedActors;
+		AddedActors.Append(OutActors);
+
+		VisitComponents(Tag, bExactMatch, [&OutActors, &AddedActors](UFlowComponent* Component)
+		{
+			if (T* ActorOfClass = Cast<T>(Component->GetOwner()))
+			{
+				bool bAlreadyAdded = false;
+				AddedActors.Add(ActorOfClass, &bAlreadyAdded);
+				if (!bAlreadyAdded)
 				{
-					Result.Emplace(ActorOfClass, ComponentOfClass);
+					OutActors.Emplace(ActorOfClass);
 				}
 			}
-		}
+			return true;
+		});
+	}
 
-		return Result;
+	/**
+	 * Adds owners of all registered Flow Components identified by Any or All provided tags to the provided array, temporary set allocates only for large results
+	 * Every actor is added only once, array isn't emptied before adding actors
+	 * 
+	 * @tparam T Only actors matching this class we'll be added
+	 * @param Tags Container to check if it matches Identity Tags of registered Flow Components
+	 * @param MatchType If Any, component needs to have only one of given tags. If All, component needs to have all given Identity Tags
+	 * @param bExactMatch If true, the tag has to be exactly present, if false then TagContainer will include it's parent tags while matching
+	 */
+	template <class T, typename AllocatorType>
+	void FindActors(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TArray<T*, AllocatorType>& OutActors) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<T, const AActor>::Value, "'T' template parameter to FindActors must be derived from AActor");
+
+		// actor might own multiple Flow Components, set keeps deduplication linear and doesn't allocate for small results
+		TSet<T*, DefaultKeyFuncs<T*>, TInlineSetAllocator<64>> AddedActors;
+		AddedActors.Append(OutActors);
+
+		VisitComponents(Tags, MatchType, bExactMatch, [&OutActors, &AddedActors](UFlowComponent* Component)
+		{
+			if (T* ActorOfClass = Cast<T>(Component->GetOwner()))
+			{
+				bool bAlreadyAdded = false;
+				AddedActors.Add(ActorOfClass, &bAlreadyAdded);
+				if (!bAlreadyAdded)
+				{
+					OutActors.Emplace(ActorOfClass);
+				}
+			}
+			return true;
+		});
+	}
+
+	/**
+	 * Calls Func for every registered Flow Component identified by given tag. Nothing is allocated while iterating.
+	 * Func must not register or unregister Flow Components, use FindComponents with an inline array if that's needed.
+	 * 
+	 * @tparam T Only components matching this class we'll be visited
+	 * @param Func Callable taking T*. If it returns bool, returning false stops the iteration
+	 * @return False if iteration has been stopped by Func
+	 */
+	template <class T, typename FuncType>
+	bool ForEachComponent(const FGameplayTag& Tag, const bool bExactMatch, FuncType&& Func) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<T, const UActorComponent>::Value, "'T' template parameter to ForEachComponent must be derived from UActorComponent");
+
+		return VisitComponents(Tag, bExactMatch, [&Func](UFlowComponent* Component)
+		{
+			T* ComponentOfClass = Cast<T>(Component);
+			return ComponentOfClass == nullptr || InvokeVisitor(Func, ComponentOfClass);
+		});
+	}
+
+	/**
+	 * Calls Func for every registered Flow Component identified by Any or All provided tags. Nothing is allocated while iterating.
+	 * Func must not register or unregister Flow Components, use FindComponents with an inline array if that's needed.
+	 * 
+	 * @tparam T Only components matching this class we'll be visited
+	 * @param Func Callable taking T*. If it returns bool, returning false stops the iteration
+	 * @return False if iteration has been stopped by Func
+	 */
+	template <class T, typename FuncType>
+	bool ForEachComponent(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, FuncType&& Func) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<T, const UActorComponent>::Value, "'T' template parameter to ForEachComponent must be derived from UActorComponent");
+
+		return VisitComponents(Tags, MatchType, bExactMatch, [&Func](UFlowComponent* Component)
+		{
+			T* ComponentOfClass = Cast<T>(Component);
+			return ComponentOfClass == nullptr || InvokeVisitor(Func, ComponentOfClass);
+		});
+	}
+
+	/**
+	 * Calls Func for the owner of every registered Flow Component identified by given tag. Nothing is allocated while iterating.
+	 * Actor owning multiple matching Flow Components is visited multiple times.
+	 * 
+	 * @tparam ActorT Only actors matching this class we'll be visited
+	 * @tparam ComponentT Only components matching this class we'll be visited
+	 * @param Func Callable taking ActorT* and ComponentT*. If it returns bool, returning false stops the iteration
+	 * @return False if iteration has been stopped by Func
+	 */
+	template <class ActorT, class ComponentT, typename FuncType>
+	bool ForEachActorAndComponent(const FGameplayTag& Tag, const bool bExactMatch, FuncType&& Func) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<ActorT, const AActor>::Value, "'ActorT' template parameter to ForEachActorAndComponent must be derived from AActor");
+		static_assert(TPointerIsConvertibleFromTo<ComponentT, const UActorComponent>::Value, "'ComponentT' template parameter to ForEachActorAndComponent must be derived from UActorComponent");
+
+		return VisitComponents(Tag, bExactMatch, [&Func](UFlowComponent* Component)
+		{
+			ComponentT* ComponentOfClass = Cast<ComponentT>(Component);
+			ActorT* ActorOfClass = Cast<ActorT>(Component->GetOwner());
+			return ComponentOfClass == nullptr || ActorOfClass == nullptr || InvokeVisitor(Func, ActorOfClass, ComponentOfClass);
+		});
+	}
+
+	/**
+	 * Calls Func for the owner of every registered Flow Component identified by Any or All provided tags. Nothing is allocated while iterating.
+	 * Actor owning multiple matching Flow Components is visited multiple times.
+	 * 
+	 * @tparam ActorT Only actors matching this class we'll be visited
+	 * @tparam ComponentT Only components matching this class we'll be visited
+	 * @param Func Callable taking ActorT* and ComponentT*. If it returns bool, returning false stops the iteration
+	 * @return False if iteration has been stopped by Func
+	 */
+	template <class ActorT, class ComponentT, typename FuncType>
+	bool ForEachActorAndComponent(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, FuncType&& Func) const
+	{
+		static_assert(TPointerIsConvertibleFromTo<ActorT, const AActor>::Value, "'ActorT' template parameter to ForEachActorAndComponent must be derived from AActor");
+		static_assert(TPointerIsConvertibleFromTo<ComponentT, const UActorComponent>::Value, "'ComponentT' template parameter to ForEachActorAndComponent must be derived from UActorComponent");
+
+		return VisitComponents(Tags, MatchType, bExactMatch, [&Func](UFlowComponent* Component)
+		{
+			ComponentT* ComponentOfClass = Cast<ComponentT>(Component);
+			ActorT* ActorOfClass = Cast<ActorT>(Component->GetOwner());
+			return ComponentOfClass == nullptr || ActorOfClass == nullptr || InvokeVisitor(Func, ActorOfClass, ComponentOfClass);
+		});
 	}
 
 private:
-	void FindComponents(const FGameplayTag& Tag, const bool bExactMatch, TArray<TWeakObjectPtr<UFlowComponent>>& OutComponents) const;
-	void FindComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TSet<TWeakObjectPtr<UFlowComponent>>& OutComponents) const;
+	/* Allows visitors returning void, these never stop the iteration */
+	template <typename FuncType, typename... ArgTypes>
+	static bool InvokeVisitor(FuncType& Func, ArgTypes... Args)
+	{
+		if constexpr (std::is_void_v<decltype(Invoke(Func, Args...))>)
+		{
+			Invoke(Func, Args...);
+			return true;
+		}
+		else
+		{
+			return Invoke(Func, Args...);
+		}
+	}
+
+protected:
+	/**
+	 * Calls Visitor once for every valid registered component matching the query, until Visitor returns false
+	 * @return False if iteration has been stopped by the Visitor
+	 */
+	bool VisitComponents(const FGameplayTag& Tag, const bool bExactMatch, TFunctionRef<bool(UFlowComponent*)> Visitor) const;
+	bool VisitComponents(const FGameplayTagContainer& Tags, const EGameplayContainerMatchType MatchType, const bool bExactMatch, TFunctionRef<bool(UFlowComponent*)> Visitor) const;
+
+	/* Returns number of components registered under given tag, cheap upper bound of the query results */
+	int32 GetRegisteredComponentsNum(const FGameplayTag& Tag, const bool bExactMatch) const;
 };
@@ -0,0 +1,115 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Containers/SparseArray.h"
+#include "Delegates/Delegate.h"
+#include "Math/UnrealMathUtility.h"
+
+DECLARE_DELEGATE(FFlowTimerDelegate);
+
+/**
+ * Identifies a timer registered in FFlowTimerWheel
+ */
+struct FLOW_API FFlowTimerHandle
+{
+	friend class FFlowTimerWheel;
+
+	FFlowTimerHandle()
+		: Index(INDEX_NONE)
+		, Serial(0)
+	{
+	}
+
+	bool IsValid() const { return Serial != 0; }
+	void Invalidate() { *this = FFlowTimerHandle(); }
+
+	bool operator==(const FFlowTimerHandle& Other) const { return Index == Other.Index && Serial == Other.Serial; }
+	bool operator!=(const FFlowTimerHandle& Other) const { return !(*this == Other); }
+
+private:
+	int32 Index;
+	uint32 Serial;
+};
+
+/**
+ * Hierarchical timer wheel batching timers of all Flow nodes
+ * - time is quantized into ticks, every level has 64 slots and covers 64 times the range of the level below
+ * - setting and clearing timers doesn't touch other timers, cleared timers are dropped when their slot is reached
+ * - timers expired in the same Advance() call are fired in order of expiration time, then in order of creation
+ */
+class FLOW_API FFlowTimerWheel
+{
+public:
+	explicit FFlowTimerWheel(const double InTickInterval = 1.0 / 60.0);
+
+	/**
+	 * Sets timer, replacing the timer already using the handle
+	 * @param Rate Time between firing, timer is cleared if the value isn't positive
+	 * @param FirstDelay Time until the first firing, Rate is used if the value is negative
+	 */
+	void SetTimer(FFlowTimerHandle& InOutHandle, FFlowTimerDelegate&& Delegate, const float Rate, const bool bLoop, const float FirstDelay = -1.0f);
+
+	// Timer will be fired on the next Advance() call
+	void SetTimerForNextTick(FFlowTimerHandle& InOutHandle, FFlowTimerDelegate&& Delegate);
+
+	void ClearTimer(FFlowTimerHandle& InOutHandle);
+
+	bool IsTimerActive(const FFlowTimerHandle& Handle) const { return FindTimer(Handle) != nullptr; }
+
+	// Returns -1 if timer isn't active
+	float GetTimerRemaining(const FFlowTimerHandle& Handle) const;
+	float GetTimerElapsed(const FFlowTimerHandle& Handle) const;
+
+	// Moves wheel time forward and fires expired timers
+	void Advance(const double DeltaTime);
+
+	void Reset();
+
+	int32 Num() const { return Timers.Num(); }
+	double GetTime() const { return Time; }
+
+private:
+	static constexpr int32 SlotBits = 6;
+	static constexpr int32 SlotsPerLevel = 1 << SlotBits;
+	static constexpr int32 SlotMask = SlotsPerLevel - 1;
+	static constexpr int32 LevelsNum = 4;
+
+	struct FTimer
+	{
+		FFlowTimerDelegate Delegate;
+		double ExpireTime = 0.0;
+		float Rate = 0.0f;
+		bool bLoop = false;
+		uint32 Serial = 0;
+		uint64 Sequence = 0;
+	};
+
+	const FTimer* FindTimer(const FFlowTimerHandle& Handle) const;
+	FTimer* FindTimer(const FFlowTimerHandle& Handle);
+
+	FFlowTimerHandle AddTimer(FFlowTimerDelegate&& Delegate, const double ExpireTime, const float Rate, const bool bLoop);
+	void Schedule(const FFlowTimerHandle& Handle, const double ExpireTime);
+	void Reschedule(TArray<FFlowTimerHandle>& Handles);
+	void CascadeLevels();
+	void FireExpiredTimers();
+
+	int64 GetTick(const double InTime) const { return FMath::FloorToInt64(InTime / TickInterval); }
+
+	double TickInterval;
+	double Time;
+
+	// Last tick processed by Advance()
+	int64 CurrentTick;
+
+	TSparseArray<FTimer> Timers;
+	TArray<FFlowTimerHandle> Slots[LevelsNum][SlotsPerLevel];
+
+	// Timers beyond the range of the top level
+	TArray<FFlowTimerHandle> Overflow;
+
+	TArray<FFlowTimerHandle> ExpiredTimers;
+
+	uint32 NextSerial;
+	uint64 NextSequence;
+};
@@ -0,0 +1,62 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Trace/Config.h"
+#include "Trace/Trace.h"
+
+#if UE_TRACE_ENABLED && !UE_BUILD_SHIPPING
+#define FLOW_TRACE_ENABLED 1
+#else
+#define FLOW_TRACE_ENABLED 0
+#endif
+
+#if FLOW_TRACE_ENABLED
+
+class UFlowAsset;
+class UFlowNode;
+
+UE_TRACE_CHANNEL_EXTERN(FlowChannel, FLOW_API);
+
+/**
+ * Emits Flow execution events to Unreal Insights, enable with -trace=flow
+ * Asset paths are sent once per template as important events, other events carry only identifiers
+ * Events are analyzed by the FlowInsights editor module
+ */
+struct FLOW_API FFlowTrace
+{
+	// Forgets which asset paths have been sent, once the trace stops
+	static void Initialize();
+	static void Shutdown();
+
+	static void OutputInstanceCreated(const UFlowAsset& Instance);
+	static void OutputInstanceDestroyed(const UFlowAsset& Instance);
+
+	static void OutputNodeActivated(const UFlowNode& Node);
+	static void OutputNodeFinished(const UFlowNode& Node);
+
+	static void OutputPinTriggered(const UFlowNode& Node, const int32 PinIndex, const bool bInputPin);
+	static void OutputDataPinResolved(const UFlowNode& Node, const int32 PinIndex);
+
+private:
+	// Returns identifier of the template, sending its path first time it's traced
+	static uint32 OutputAssetSpec(const UFlowAsset& TemplateAsset);
+};
+
+#define TRACE_FLOW_INSTANCE_CREATED(Instance) FFlowTrace::OutputInstanceCreated(Instance)
+#define TRACE_FLOW_INSTANCE_DESTROYED(Instance) FFlowTrace::OutputInstanceDestroyed(Instance)
+#define TRACE_FLOW_NODE_ACTIVATED(Node) FFlowTrace::OutputNodeActivated(Node)
+#define TRACE_FLOW_NODE_FINISHED(Node) FFlowTrace::OutputNodeFinished(Node)
+#define TRACE_FLOW_PIN_TRIGGERED(Node, PinIndex, bInputPin) FFlowTrace::OutputPinTriggered(Node, PinIndex, bInputPin)
+#define TRACE_FLOW_DATA_PIN_RESOLVED(Node, PinIndex) FFlowTrace::OutputDataPinResolved(Node, PinIndex)
+
+#else
+
+#define TRACE_FLOW_INSTANCE_CREATED(Instance)
+#define TRACE_FLOW_INSTANCE_DESTROYED(Instance)
+#define TRACE_FLOW_NODE_ACTIVATED(Node)
+#define TRACE_FLOW_NODE_FINISHED(Node)
+#define TRACE_FLOW_PIN_TRIGGERED(Node, PinIndex, bInputPin)
+#define TRACE_FLOW_DATA_PIN_RESOLVED(Node, PinIndex)
+
+#endif
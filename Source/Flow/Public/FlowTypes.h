@@ -69,6 +69,17 @@ enum class EFlowNetMode : uint8
 	SinglePlayerOnly	UMETA(ToolTip = "Executed only in the single player, not available in multiplayer.")
 };
 
+UENUM(BlueprintType)
+enum class EFlowStartPriority : uint8
+{
+	StoryCritical	UMETA(ToolTip = "Started on the next frame regardless of the startup budget."),
+	High,
+	Normal,
+	Low,
+
+	Max UMETA(Hidden)
+};
+
 UENUM(BlueprintType)
 enum class EFlowTagContainerMatchType : uint8
 {
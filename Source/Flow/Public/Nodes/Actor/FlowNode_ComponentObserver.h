@@ -40,6 +40,9 @@ protected:
 
 	TMap<TWeakObjectPtr<AActor>, TWeakObjectPtr<UFlowComponent>> RegisteredActors;
 
+	// Subscription in the Flow Subsystem, notifying us only about components that might match Identity Tags
+	FDelegateHandle ComponentObserverHandle;
+
 protected:
 	virtual void ExecuteInput(const FName& PinName) override;
 	virtual void OnLoad_Implementation() override;
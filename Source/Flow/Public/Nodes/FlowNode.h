@@ -4,10 +4,13 @@
 
 #include "EdGraph/EdGraphNode.h"
 #include "GameplayTagContainer.h"
+#include "UObject/ObjectKey.h"
 #include "UObject/TextProperty.h"
 #include "VisualLogger/VisualLoggerDebugSnapshotInterface.h"
 
 #include "FlowNodeBase.h"
+#include "FlowSave.h"
+#include "FlowTimerWheel.h"
 #include "FlowTypes.h"
 #include "Interfaces/FlowDataPinValueSupplierInterface.h"
 #include "Nodes/FlowPin.h"
@@ -74,7 +77,14 @@ public:
 	UFUNCTION(BlueprintPure, Category = "FlowNode")
 	const FGuid& GetGuid() const { return NodeGuid; }
 
-public:	
+protected:
+	// Index of this node in the compiled graph, assigned by UFlowAsset::CompileGraph
+	UPROPERTY()
+	int32 NodeIndex;
+
+public:
+	int32 GetNodeIndex() const { return NodeIndex; }
+
 	virtual bool CanFinishGraph() const { return false; }
 
 protected:
@@ -170,6 +180,8 @@ public:
 	UE_DEPRECATED(5.5, "Please use GatherConnectedNodes instead.")
 	TSet<UFlowNode*> GetConnectedNodes() const { return GatherConnectedNodes(); }
 
+	// Returns nodes connected to outputs, without instancing them
+	// Nodes of the lazily instanced asset that haven't been instanced yet are returned as template nodes
 	UFUNCTION(BlueprintPure, Category= "FlowNode")
 	TSet<UFlowNode*> GatherConnectedNodes() const;
 	
@@ -252,6 +264,26 @@ public:
 		TArray<FFlowPinValueSupplierData>& InOutPinValueSupplierDatas) const;
 	// --
 
+	// Cached version of TryGetFlowDataPinSupplierDatasForPinName, rebuilt after UFlowAsset::InvalidateDataPinSupplierCache() call on the owning asset
+	const TArray<FFlowPinValueSupplierData>& GetCachedFlowDataPinSupplierDatasForPinName(const FName& PinName) const;
+
+	// Cached version of UClass::FindPropertyByName for properties bound to data pins
+	static const FProperty* FindBoundPropertyCached(const UClass& Class, const FName& PropertyName);
+
+	// Needs to be called when classes are recompiled or reloaded, as it invalidates FProperty pointers
+	static void ClearBoundPropertyCache();
+
+private:
+	struct FCachedDataPinSuppliers
+	{
+		uint32 Generation = 0;
+		TArray<FFlowPinValueSupplierData> Suppliers;
+	};
+
+	mutable TMap<FName, FCachedDataPinSuppliers> CachedDataPinSuppliers;
+
+	static TMap<TObjectKey<UClass>, TMap<FName, const FProperty*>> BoundPropertyCache;
+
 protected:
 
 	// Helper functions for the TrySupplyDataPin...() functions
@@ -319,18 +351,33 @@ public:
 #if !UE_BUILD_SHIPPING
 
 private:
-	TMap<FName, TArray<FPinRecord>> InputRecords;
-	TMap<FName, TArray<FPinRecord>> OutputRecords;
+	FPinRecordHistory PinRecordHistory;
 #endif
 
 public:
 	void TriggerPreload();
 	void TriggerFlush();
 
+	// Soft references to content used by this node, loaded in advance by predictive preloading (see UFlowSettings::PredictivePreloadDepth)
+	// Called on the template node, so it must read only properties set in the graph
+	// By default, it gathers soft object and soft class properties, and class data pins
+	virtual void GatherPreloadableContent(TArray<FSoftObjectPath>& OutContent) const;
+
+protected:
+	// Timers driven by the timer wheel of Flow Subsystem, much cheaper than world timers if many nodes are waiting
+	// Timers aren't cleared automatically, clear them in Cleanup()
+	void SetFlowTimer(FFlowTimerHandle& InOutHandle, FFlowTimerDelegate&& Delegate, const float Rate, const bool bLoop = false, const float FirstDelay = -1.0f) const;
+	void SetFlowTimerForNextTick(FFlowTimerHandle& InOutHandle, FFlowTimerDelegate&& Delegate) const;
+	void ClearFlowTimer(FFlowTimerHandle& InOutHandle) const;
+
+	float GetFlowTimerRemaining(const FFlowTimerHandle& Handle) const;
+	float GetFlowTimerElapsed(const FFlowTimerHandle& Handle) const;
+
 protected:
 
 	// Trigger execution of input pin
 	void TriggerInput(const FName& PinName, const EFlowPinActivationType ActivationType = EFlowPinActivationType::Default);
+	void TriggerInputByIndex(const int32 PinIndex, const EFlowPinActivationType ActivationType = EFlowPinActivationType::Default);
 
 protected:
 	void Deactivate();
@@ -340,9 +387,23 @@ protected:
 public:
 	virtual void Finish() override;
 
+public:
+	// Called on node of the instance returned to the pool (see UFlowSettings::MaxPooledInstancesPerTemplate)
+	// Reflected properties are copied from the template node, instances which instanced Blueprint nodes are never pooled
+	// Override to reset native members not exposed to reflection, calling Super is required
+	virtual void ResetForPool(const UFlowNode& NodeTemplate);
+
 private:
 	void ResetRecords();
 
+	// Incremented on every change of the node state, see UFlowSettings::bIncrementalSaving
+	uint32 SaveGeneration = 1;
+
+	// Record written by the last save and the state it was written from
+	FFlowNodeSaveData CachedSaveRecord;
+	uint32 CachedSaveGeneration = 0;
+	uint32 CachedSaveTableSerial = 0;
+
 //////////////////////////////////////////////////////////////////////////
 // SaveGame support
 
@@ -353,7 +414,18 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "FlowNode")
 	void LoadInstance(const FFlowNodeSaveData& NodeRecord);
 
+	// Forces serializing this node on the next save, call it whenever SaveGame properties change
+	UFUNCTION(BlueprintCallable, Category = "FlowNode")
+	void MarkSaveDirty();
+
 protected:
+	// Native class opted in to reusing the save record, its own SaveGame properties and the ones of its parents are trusted to call MarkSaveDirty on every write
+	// Set it to StaticClass() in the constructor of the node class, or to nullptr if SaveGame properties are updated in OnSave, i.e. from the elapsed time
+	// Derived classes declaring SaveGame properties, or implementing OnSave in blueprint, are always serialized
+	const UClass* SaveRecordReusableClass;
+
+	virtual bool CanReuseSaveRecord() const;
+
 	UFUNCTION(BlueprintNativeEvent, Category = "FlowNode")
 	void OnSave();
 
@@ -370,7 +442,7 @@ protected:
 public:
 	UFlowNode* GetInspectedInstance() const;
 
-	TMap<uint8, FPinRecord> GetWireRecords() const;
+	TMap<int32, FPinRecord> GetWireRecords() const;
 	TArray<FPinRecord> GetPinRecords(const FName& PinName, const EEdGraphPinDirection PinDirection) const;
 
 	// Information displayed while node is working - displayed over node as NodeInfoPopup
@@ -6,6 +6,7 @@
 
 #include "Interfaces/FlowCoreExecutableInterface.h"
 #include "Interfaces/FlowContextPinSupplierInterface.h"
+#include "FlowLogChannels.h"
 #include "FlowMessageLog.h"
 #include "FlowTags.h"
 #include "FlowTypes.h"
@@ -27,6 +28,21 @@ struct FFlowPin;
 DECLARE_DELEGATE(FFlowNodeEvent);
 #endif
 
+// Calls LogVerbose with a formatted message, formatting happens only if LogFlow has Verbose logging enabled
+// Compiled out in Shipping builds
+#if !UE_BUILD_SHIPPING
+#define FLOW_LOG_VERBOSE(Format, ...) \
+	do \
+	{ \
+		if (UE_LOG_ACTIVE(LogFlow, Verbose)) \
+		{ \
+			LogVerbose(FString::Printf(Format, ##__VA_ARGS__)); \
+		} \
+	} while (false)
+#else
+#define FLOW_LOG_VERBOSE(Format, ...) do {} while (false)
+#endif
+
 typedef TFunction<EFlowForEachAddOnFunctionReturnValue(const UFlowNodeAddOn&)> FConstFlowNodeAddOnFunction;
 typedef TFunction<EFlowForEachAddOnFunctionReturnValue(UFlowNodeAddOn&)> FFlowNodeAddOnFunction;
 
@@ -47,7 +63,7 @@ struct TResolveDataPinWorkingData
 	const UFlowNode* FlowNode = nullptr;
 	const FFlowPin* FlowPin = nullptr;
 	
-	TArray<FFlowPinValueSupplierData> PinValueSupplierDatas;
+	TArray<FFlowPinValueSupplierData, TInlineAllocator<4>> PinValueSupplierDatas;
 
 	static constexpr bool bCheckDefaultProperties = true;
 };
@@ -4,6 +4,7 @@
 
 #include "Types/FlowPinEnums.h"
 
+#include "Misc/DateTime.h"
 #include "Templates/SubclassOf.h"
 #include "UObject/ObjectMacros.h"
 
@@ -23,12 +24,14 @@ struct FLOW_API FFlowPin
 	UPROPERTY(EditDefaultsOnly, Category = FlowPin)
 	FName PinName;
 
+#if WITH_EDITORONLY_DATA
 	// An optional Display Name, you can use it to override PinName without the need to update graph connections
 	UPROPERTY(EditDefaultsOnly, Category = FlowPin)
 	FText PinFriendlyName;
 
 	UPROPERTY(EditDefaultsOnly, Category = FlowPin)
 	FString PinToolTip;
+#endif // WITH_EDITORONLY_DATA
 
 protected:
 	// PinType (implies PinCategory)
@@ -122,39 +125,51 @@ public:
 
 	FFlowPin(const FStringView InPinName, const FText& InPinFriendlyName)
 		: PinName(InPinName)
+#if WITH_EDITORONLY_DATA
 		, PinFriendlyName(InPinFriendlyName)
+#endif
 	{
 	}
 
 	FFlowPin(const FStringView InPinName, const FString& InPinTooltip)
 		: PinName(InPinName)
+#if WITH_EDITORONLY_DATA
 		, PinToolTip(InPinTooltip)
+#endif
 	{
 	}
 
 	FFlowPin(const FStringView InPinName, const FText& InPinFriendlyName, const FString& InPinTooltip)
 		: PinName(InPinName)
+#if WITH_EDITORONLY_DATA
 		, PinFriendlyName(InPinFriendlyName)
 		, PinToolTip(InPinTooltip)
+#endif
 	{
 	}
 
 	FFlowPin(const FName& InPinName, const FText& InPinFriendlyName)
 		: PinName(InPinName)
+#if WITH_EDITORONLY_DATA
 		, PinFriendlyName(InPinFriendlyName)
+#endif
 	{
 	}
 
 	FFlowPin(const FName& InPinName, const FText& InPinFriendlyName, const FString& InPinTooltip)
 		: PinName(InPinName)
+#if WITH_EDITORONLY_DATA
 		, PinFriendlyName(InPinFriendlyName)
 		, PinToolTip(InPinTooltip)
+#endif
 	{
 	}
 
 	FFlowPin(const FName& InPinName, const FText& InPinFriendlyName, EFlowPinType InFlowPinType, UObject* SubCategoryObject = nullptr)
 		: PinName(InPinName)
+#if WITH_EDITORONLY_DATA
 		, PinFriendlyName(InPinFriendlyName)
+#endif
 	{
 		SetPinType(InFlowPinType, SubCategoryObject);
 	}
@@ -387,7 +402,7 @@ enum class EFlowPinActivationType : uint8
 struct FLOW_API FPinRecord
 {
 	double Time;
-	FString HumanReadableTime;
+	FDateTime SystemTime;
 	EFlowPinActivationType ActivationType;
 
 	static FString NoActivations;
@@ -398,9 +413,53 @@ struct FLOW_API FPinRecord
 	FPinRecord();
 	FPinRecord(const double InTime, const EFlowPinActivationType InActivationType);
 
+	FString GetHumanReadableTime() const;
+
 private:
 	FORCEINLINE static FString DoubleDigit(const int32 Number);
 };
+
+// Fixed-capacity history of pin activations on a single node, every pin keeps its own recent records
+// The oldest records of the pin are overwritten, so frequently activated pins don't evict records of other pins
+struct FLOW_API FPinRecordHistory
+{
+	void Add(const int32 PinIndex, const bool bInputPin, const FPinRecord& Record, const int32 Capacity);
+	void Reset();
+
+	// Number of pins that might have records, pin indices are lower than this
+	int32 GetPinsNum(const bool bInputPin) const { return (bInputPin ? InputPins : OutputPins).Num(); }
+
+	// Returns nullptr if the pin wasn't activated
+	const FPinRecord* GetLastRecord(const int32 PinIndex, const bool bInputPin) const;
+
+	// Visits records of the pin in the order of activation, starting from the oldest one
+	template <typename FuncType>
+	void ForEachRecord(const int32 PinIndex, const bool bInputPin, FuncType Func) const
+	{
+		const TArray<FPinRing>& Pins = bInputPin ? InputPins : OutputPins;
+		if (Pins.IsValidIndex(PinIndex))
+		{
+			const FPinRing& Ring = Pins[PinIndex];
+			const int32 RecordsNum = Ring.Records.Num();
+			for (int32 i = 0; i < RecordsNum; i++)
+			{
+				Func(Ring.Records[(Ring.Head + i) % RecordsNum]);
+			}
+		}
+	}
+
+private:
+	struct FPinRing
+	{
+		TArray<FPinRecord> Records;
+
+		// Index of the oldest record, once the buffer is full
+		int32 Head = 0;
+	};
+
+	TArray<FPinRing> InputPins;
+	TArray<FPinRing> OutputPins;
+};
 #endif
 
 // It can represent any trait added on the specific node instance, i.e. breakpoint
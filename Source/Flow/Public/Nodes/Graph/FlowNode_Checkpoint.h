@@ -5,8 +5,13 @@
 #include "Nodes/FlowNode.h"
 #include "FlowNode_Checkpoint.generated.h"
 
+class UFlowSaveGame;
+enum class EFlowSaveGameResult : uint8;
+
 /**
  * Save the state of the game to the save file
+ * State is captured at the end of the frame, the save file is written in the background
+ * Default output is triggered after capturing the state, Saved or Failed output is triggered after writing it
  * It's recommended to replace this with game-specific variant and this node to UFlowGraphSettings::HiddenNodes
  */
 UCLASS(NotBlueprintable, meta = (DisplayName = "Checkpoint", Keywords = "autosave, save"))
@@ -15,6 +20,14 @@ class FLOW_API UFlowNode_Checkpoint final : public UFlowNode
 	GENERATED_UCLASS_BODY()
 
 protected:
+	// True after the default output has been triggered, the node only waits for the save file to be written
+	UPROPERTY(SaveGame)
+	bool bOutputTriggered;
+
 	virtual void ExecuteInput(const FName& PinName) override;
 	virtual void OnLoad_Implementation() override;
+	virtual void Cleanup() override;
+
+	void OnSaveGameCaptured(UFlowSaveGame* SaveGame);
+	void OnSaveGameWritten(UFlowSaveGame* SaveGame, const EFlowSaveGameResult Result);
 };
@@ -5,6 +5,8 @@
 #include "Nodes/FlowNode.h"
 #include "Interfaces/FlowDataPinGeneratorNodeInterface.h"
 
+#include "Engine/StreamableManager.h"
+
 #include "FlowNode_SubGraph.generated.h"
 
 /**
@@ -38,8 +40,31 @@ private:
 	UPROPERTY(SaveGame)
 	FString SavedAssetInstanceName;
 
+	// Start was triggered while the asset was loading asynchronously
+	// Saved, so loading SaveGame resumes starting the sub-flow
+	UPROPERTY(SaveGame)
+	bool bStartOnAssetLoaded;
+
+	// Sub-flow instance will be restored from SavedAssetInstanceName once the asset is loaded
+	bool bRestoreOnAssetLoaded;
+
+	TSharedPtr<FStreamableHandle> AssetLoadHandle;
+	FFlowTimerHandle AssetLoadTimeoutHandle;
+
 protected:
 	virtual bool CanBeAssetInstanced() const;
+
+	// True if the asset should be requested via async loading instead of loading it synchronously
+	bool ShouldLoadAssetAsync() const;
+
+	void RequestAssetLoad();
+	void CancelAssetLoad();
+
+	void OnAssetLoaded();
+	void OnAssetLoadTimeout();
+
+	// Loads the asset synchronously and proceeds as if the async request has finished
+	void CompleteAssetLoad();
 	
 	virtual void PreloadContent() override;
 	virtual void FlushContent() override;
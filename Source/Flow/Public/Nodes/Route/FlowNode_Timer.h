@@ -2,7 +2,6 @@
 
 #pragma once
 
-#include "Engine/EngineTypes.h"
 #include "Nodes/FlowNode.h"
 #include "FlowNode_Timer.generated.h"
 
@@ -26,8 +25,8 @@ protected:
 	static FName INPIN_CompletionTime;
 
 private:
-	FTimerHandle CompletionTimerHandle;
-	FTimerHandle StepTimerHandle;
+	FFlowTimerHandle CompletionTimerHandle;
+	FFlowTimerHandle StepTimerHandle;
 
 	UPROPERTY(SaveGame)
 	float ResolvedCompletionTime;
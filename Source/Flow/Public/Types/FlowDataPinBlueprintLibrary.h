@@ -35,8 +35,10 @@ public:
 			FString& OutPinToolTip)
 	{
 		OutPinName = Ref.PinName;
+#if WITH_EDITORONLY_DATA
 		OutPinFriendlyName = Ref.PinFriendlyName;
 		OutPinToolTip = Ref.PinToolTip;
+#endif
 	}
 
 	// Recommend implementing AutoConvert_FlowDataPinProperty... for every EFlowPinType
@@ -63,7 +63,7 @@ void FFlowGraphConnectionDrawingPolicy::BuildPaths()
 		{
 			const UFlowGraphNode* FlowGraphNode = Cast<UFlowGraphNode>(Node->GetGraphNode());
 
-			for (const TPair<uint8, FPinRecord>& Record : Node->GetWireRecords())
+			for (const TPair<int32, FPinRecord>& Record : Node->GetWireRecords())
 			{
 				if (!FlowGraphNode->OutputPins.IsValidIndex(Record.Key))
 				{
@@ -0,0 +1,37 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+using UnrealBuildTool;
+
+public class FlowInsights : ModuleRules
+{
+	public FlowInsights(ReadOnlyTargetRules target) : base(target)
+	{
+		if (CppStandard is null || CppStandard != CppStandardVersion.Cpp20)
+		{
+			CppStandard = CppStandardVersion.Cpp20;
+		}
+
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(new[]
+		{
+			"TraceServices"
+		});
+
+		PrivateDependencyModuleNames.AddRange(new[]
+		{
+			"Core",
+			"TraceAnalysis"
+		});
+
+		// Unreal Insights doesn't load game modules, node titles are resolved only in the editor
+		if (target.Type == TargetType.Editor)
+		{
+			PrivateDependencyModuleNames.AddRange(new[]
+			{
+				"CoreUObject",
+				"Flow"
+			});
+		}
+	}
+}
@@ -0,0 +1,5 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowInsightsLogChannels.h"
+
+DEFINE_LOG_CATEGORY(LogFlowInsights);
@@ -0,0 +1,70 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowInsightsModule.h"
+#include "FlowInsightsLogChannels.h"
+#include "FlowTraceModule.h"
+
+#include "Features/IModularFeatures.h"
+#include "HAL/IConsoleManager.h"
+#include "Modules/ModuleManager.h"
+#include "TraceServices/ITraceServicesModule.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+void FFlowInsightsModule::StartupModule()
+{
+	TraceModule = MakeShared<FFlowTraceModule>();
+	IModularFeatures::Get().RegisterModularFeature(TraceServices::ModuleFeatureName, TraceModule.Get());
+
+	ReportCommand = IConsoleManager::Get().RegisterConsoleCommand(
+		TEXT("Flow.TraceReport"),
+		TEXT("Analyzes given .utrace file and logs the hottest Flow nodes and the timeline of every Flow Asset instance"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&FFlowInsightsModule::ReportTraceFile),
+		ECVF_Default);
+}
+
+void FFlowInsightsModule::ShutdownModule()
+{
+	if (ReportCommand)
+	{
+		IConsoleManager::Get().UnregisterConsoleObject(ReportCommand);
+		ReportCommand = nullptr;
+	}
+
+	if (TraceModule.IsValid())
+	{
+		IModularFeatures::Get().UnregisterModularFeature(TraceServices::ModuleFeatureName, TraceModule.Get());
+		TraceModule.Reset();
+	}
+}
+
+void FFlowInsightsModule::ReportTraceFile(const TArray<FString>& Args)
+{
+	if (Args.Num() == 0)
+	{
+		UE_LOG(LogFlowInsights, Warning, TEXT("Usage: Flow.TraceReport <path to .utrace file>"));
+		return;
+	}
+
+	const TSharedPtr<TraceServices::IAnalysisService> AnalysisService = FModuleManager::LoadModuleChecked<ITraceServicesModule>("TraceServices").GetAnalysisService();
+	const TSharedPtr<const TraceServices::IAnalysisSession> Session = AnalysisService.IsValid() ? AnalysisService->Analyze(*Args[0]) : nullptr;
+	if (!Session.IsValid())
+	{
+		UE_LOG(LogFlowInsights, Error, TEXT("Failed to analyze trace file %s"), *Args[0]);
+		return;
+	}
+
+	TArray<FString> Lines;
+	FFlowTraceModule::BuildReport(*Session, Lines);
+	if (Lines.Num() == 0)
+	{
+		UE_LOG(LogFlowInsights, Display, TEXT("No Flow events in %s, record them with -trace=flow"), *Args[0]);
+		return;
+	}
+
+	for (const FString& Line : Lines)
+	{
+		UE_LOG(LogFlowInsights, Display, TEXT("%s"), *Line);
+	}
+}
+
+IMPLEMENT_MODULE(FFlowInsightsModule, FlowInsights)
@@ -0,0 +1,80 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTraceAnalyzer.h"
+#include "FlowTraceProvider.h"
+
+#include "TraceServices/Model/AnalysisSession.h"
+
+namespace FlowTraceAnalyzer
+{
+	// Reverts FlowTrace::GetGuidHigh and FlowTrace::GetGuidLow
+	FGuid GetNodeGuid(const UE::Trace::IAnalyzer::FEventData& EventData)
+	{
+		const uint64 High = EventData.GetValue<uint64>("NodeGuidHigh");
+		const uint64 Low = EventData.GetValue<uint64>("NodeGuidLow");
+		return FGuid(static_cast<uint32>(High >> 32), static_cast<uint32>(High), static_cast<uint32>(Low >> 32), static_cast<uint32>(Low));
+	}
+}
+
+FFlowTraceAnalyzer::FFlowTraceAnalyzer(TraceServices::IAnalysisSession& InSession, FFlowTraceProvider& InProvider)
+	: Session(InSession)
+	, Provider(InProvider)
+{
+}
+
+void FFlowTraceAnalyzer::OnAnalysisBegin(const FOnAnalysisContext& Context)
+{
+	FInterfaceBuilder& Builder = Context.InterfaceBuilder;
+
+	Builder.RouteEvent(RouteId_AssetSpec, "Flow", "AssetSpec");
+	Builder.RouteEvent(RouteId_InstanceCreated, "Flow", "InstanceCreated");
+	Builder.RouteEvent(RouteId_InstanceDestroyed, "Flow", "InstanceDestroyed");
+	Builder.RouteEvent(RouteId_NodeActivated, "Flow", "NodeActivated");
+	Builder.RouteEvent(RouteId_NodeFinished, "Flow", "NodeFinished");
+	Builder.RouteEvent(RouteId_PinTriggered, "Flow", "PinTriggered");
+	Builder.RouteEvent(RouteId_DataPinResolved, "Flow", "DataPinResolved");
+}
+
+bool FFlowTraceAnalyzer::OnEvent(uint16 RouteId, EStyle Style, const FOnEventContext& Context)
+{
+	TraceServices::FAnalysisSessionEditScope EditScope(Session);
+
+	const FEventData& EventData = Context.EventData;
+	if (RouteId == RouteId_AssetSpec)
+	{
+		FString Path;
+		EventData.GetString("Path", Path);
+		Provider.AddAssetPath(EventData.GetValue<uint32>("AssetId"), Path);
+		return true;
+	}
+
+	const double Time = Context.EventTime.AsSeconds(EventData.GetValue<uint64>("Cycle"));
+	const uint32 InstanceId = EventData.GetValue<uint32>("InstanceId");
+	Session.UpdateDurationSeconds(Time);
+
+	switch (RouteId)
+	{
+		case RouteId_InstanceCreated:
+			Provider.AddInstance(InstanceId, EventData.GetValue<uint32>("AssetId"), Time);
+			break;
+		case RouteId_InstanceDestroyed:
+			Provider.RemoveInstance(InstanceId, Time);
+			break;
+		case RouteId_NodeActivated:
+			Provider.OnNodeActivated(InstanceId, FlowTraceAnalyzer::GetNodeGuid(EventData), Time);
+			break;
+		case RouteId_NodeFinished:
+			Provider.OnNodeFinished(InstanceId, FlowTraceAnalyzer::GetNodeGuid(EventData), Time);
+			break;
+		case RouteId_PinTriggered:
+			Provider.OnPinTriggered(InstanceId, FlowTraceAnalyzer::GetNodeGuid(EventData), Time);
+			break;
+		case RouteId_DataPinResolved:
+			Provider.OnDataPinResolved(InstanceId, FlowTraceAnalyzer::GetNodeGuid(EventData), Time);
+			break;
+		default:
+			break;
+	}
+
+	return true;
+}
@@ -0,0 +1,114 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTraceModule.h"
+#include "FlowTraceAnalyzer.h"
+#include "FlowTraceProvider.h"
+
+#if WITH_EDITOR
+#include "FlowAsset.h"
+#include "Nodes/FlowNode.h"
+#endif
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+namespace FlowTraceModule
+{
+	constexpr int32 HottestNodesNum = 50;
+
+	FString GetAssetPath(const FFlowTraceProvider& Provider, const uint32 AssetId)
+	{
+		const FString* Path = Provider.FindAssetPath(AssetId);
+		return Path ? *Path : TEXT("<unknown asset>");
+	}
+
+	// Node title is available only if the asset is loaded in the editor, reports can be generated outside of the game thread
+	FString GetNodeName(const FFlowTraceProvider& Provider, const uint32 AssetId, const FGuid& NodeGuid)
+	{
+#if WITH_EDITOR
+		if (IsInGameThread())
+		{
+			if (const FString* Path = Provider.FindAssetPath(AssetId))
+			{
+				if (const UFlowAsset* FlowAsset = Cast<UFlowAsset>(FSoftObjectPath(*Path).ResolveObject()))
+				{
+					if (const UFlowNode* Node = FlowAsset->GetNode(NodeGuid))
+					{
+						return FString::Printf(TEXT("%s (%s)"), *Node->GetNodeTitle().ToString(), *NodeGuid.ToString());
+					}
+				}
+			}
+		}
+#endif
+
+		return NodeGuid.ToString();
+	}
+}
+
+void FFlowTraceModule::GetModuleInfo(TraceServices::FModuleInfo& OutModuleInfo)
+{
+	OutModuleInfo.Name = TEXT("FlowTrace");
+	OutModuleInfo.DisplayName = TEXT("Flow");
+}
+
+void FFlowTraceModule::OnAnalysisBegin(TraceServices::IAnalysisSession& Session)
+{
+	const TSharedPtr<FFlowTraceProvider> Provider = MakeShared<FFlowTraceProvider>(Session);
+	Session.AddProvider(FFlowTraceProvider::ProviderName, Provider);
+	Session.AddAnalyzer(new FFlowTraceAnalyzer(Session, *Provider));
+}
+
+void FFlowTraceModule::GetLoggers(TArray<const TCHAR*>& OutLoggers)
+{
+	OutLoggers.Add(TEXT("Flow"));
+}
+
+void FFlowTraceModule::GenerateReports(const TraceServices::IAnalysisSession& Session, const TCHAR* CmdLine, const TCHAR* OutputDirectory)
+{
+	TArray<FString> Lines;
+	BuildReport(Session, Lines);
+
+	if (Lines.Num() > 0)
+	{
+		FFileHelper::SaveStringArrayToFile(Lines, *FPaths::Combine(OutputDirectory, TEXT("FlowTrace.txt")));
+	}
+}
+
+void FFlowTraceModule::BuildReport(const TraceServices::IAnalysisSession& Session, TArray<FString>& OutLines)
+{
+	TraceServices::FAnalysisSessionReadScope ReadScope(Session);
+
+	const FFlowTraceProvider* Provider = Session.ReadProvider<FFlowTraceProvider>(FFlowTraceProvider::ProviderName);
+	if (Provider == nullptr || Provider->GetInstances().Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FFlowTraceNodeStats> HottestNodes;
+	Provider->GetHottestNodes(FlowTraceModule::HottestNodesNum, HottestNodes);
+
+	OutLines.Add(TEXT("Hottest nodes"));
+	OutLines.Add(FString::Printf(TEXT("%8s %11s %11s %9s %12s  %s"), TEXT("Events"), TEXT("Activations"), TEXT("PinTriggers"), TEXT("DataPins"), TEXT("ActiveMs"), TEXT("Node")));
+	for (const FFlowTraceNodeStats& Stats : HottestNodes)
+	{
+		OutLines.Add(FString::Printf(TEXT("%8u %11u %11u %9u %12.3f  %s %s"),
+			Stats.GetEventsNum(), Stats.Activations, Stats.PinTriggers, Stats.DataPinResolves, Stats.ActiveTime * 1000.0,
+			*FlowTraceModule::GetAssetPath(*Provider, Stats.AssetId), *FlowTraceModule::GetNodeName(*Provider, Stats.AssetId, Stats.NodeGuid)));
+	}
+
+	OutLines.Add(FString());
+	OutLines.Add(TEXT("Instances"));
+	for (const FFlowTraceInstance& Instance : Provider->GetInstances())
+	{
+		const FString DestroyTime = Instance.DestroyTime < 0.0 ? TEXT("...") : FString::Printf(TEXT("%.3f s"), Instance.DestroyTime);
+		OutLines.Add(FString::Printf(TEXT("[%.3f s - %s] %s #%u"), Instance.CreateTime, *DestroyTime, *FlowTraceModule::GetAssetPath(*Provider, Instance.AssetId), Instance.InstanceId));
+
+		for (const FFlowTraceNodeActivation& Activation : Instance.Activations)
+		{
+			const FString Duration = Activation.EndTime < 0.0 ? TEXT("unfinished") : FString::Printf(TEXT("%.3f ms"), (Activation.EndTime - Activation.StartTime) * 1000.0);
+			OutLines.Add(FString::Printf(TEXT("    +%10.3f ms %14s  %s"), (Activation.StartTime - Instance.CreateTime) * 1000.0, *Duration,
+				*FlowTraceModule::GetNodeName(*Provider, Instance.AssetId, Activation.NodeGuid)));
+		}
+	}
+}
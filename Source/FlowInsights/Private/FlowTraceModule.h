@@ -0,0 +1,19 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "TraceServices/ModuleService.h"
+
+// Adds FFlowTraceProvider to every analysis session
+class FFlowTraceModule final : public TraceServices::IModule
+{
+public:
+	virtual void GetModuleInfo(TraceServices::FModuleInfo& OutModuleInfo) override;
+	virtual void OnAnalysisBegin(TraceServices::IAnalysisSession& Session) override;
+	virtual void GetLoggers(TArray<const TCHAR*>& OutLoggers) override;
+	virtual void GenerateReports(const TraceServices::IAnalysisSession& Session, const TCHAR* CmdLine, const TCHAR* OutputDirectory) override;
+	virtual const TCHAR* GetCommandLineArgument() override { return TEXT("flowtrace"); }
+
+	// Lists the hottest nodes, then timeline of every instance
+	static void BuildReport(const TraceServices::IAnalysisSession& Session, TArray<FString>& OutLines);
+};
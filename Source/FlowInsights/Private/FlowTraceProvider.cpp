@@ -0,0 +1,144 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTraceProvider.h"
+
+const FName FFlowTraceProvider::ProviderName(TEXT("FlowTraceProvider"));
+
+FFlowTraceProvider::FFlowTraceProvider(TraceServices::IAnalysisSession& InSession)
+	: Session(InSession)
+{
+}
+
+void FFlowTraceProvider::AddAssetPath(const uint32 AssetId, const FString& Path)
+{
+	Session.WriteAccessCheck();
+
+	AssetPaths.Add(AssetId, Path);
+}
+
+void FFlowTraceProvider::AddInstance(const uint32 InstanceId, const uint32 AssetId, const double Time)
+{
+	Session.WriteAccessCheck();
+
+	// identifier of the destroyed instance might be reused
+	RemoveInstance(InstanceId, Time);
+
+	FFlowTraceInstance& Instance = Instances.AddDefaulted_GetRef();
+	Instance.InstanceId = InstanceId;
+	Instance.AssetId = AssetId;
+	Instance.CreateTime = Time;
+
+	LiveInstanceIndices.Add(InstanceId, Instances.Num() - 1);
+}
+
+void FFlowTraceProvider::RemoveInstance(const uint32 InstanceId, const double Time)
+{
+	Session.WriteAccessCheck();
+
+	int32 InstanceIndex = INDEX_NONE;
+	if (!LiveInstanceIndices.RemoveAndCopyValue(InstanceId, InstanceIndex))
+	{
+		return;
+	}
+
+	Instances[InstanceIndex].DestroyTime = Time;
+
+	// nodes still active are cleaned up with the instance
+	for (FFlowTraceNodeActivation& Activation : Instances[InstanceIndex].Activations)
+	{
+		if (Activation.EndTime < 0.0)
+		{
+			Activation.EndTime = Time;
+			OpenActivations.Remove(TPair<int32, FGuid>(InstanceIndex, Activation.NodeGuid));
+
+			GetNodeStats(InstanceIndex, Activation.NodeGuid).ActiveTime += Activation.EndTime - Activation.StartTime;
+		}
+	}
+}
+
+void FFlowTraceProvider::OnNodeActivated(const uint32 InstanceId, const FGuid& NodeGuid, const double Time)
+{
+	Session.WriteAccessCheck();
+
+	const int32 InstanceIndex = GetLiveInstanceIndex(InstanceId, Time);
+	FFlowTraceInstance& Instance = Instances[InstanceIndex];
+
+	FFlowTraceNodeActivation& Activation = Instance.Activations.AddDefaulted_GetRef();
+	Activation.NodeGuid = NodeGuid;
+	Activation.StartTime = Time;
+
+	OpenActivations.Add(TPair<int32, FGuid>(InstanceIndex, NodeGuid), Instance.Activations.Num() - 1);
+	GetNodeStats(InstanceIndex, NodeGuid).Activations++;
+}
+
+void FFlowTraceProvider::OnNodeFinished(const uint32 InstanceId, const FGuid& NodeGuid, const double Time)
+{
+	Session.WriteAccessCheck();
+
+	const int32* InstanceIndex = LiveInstanceIndices.Find(InstanceId);
+	if (InstanceIndex == nullptr)
+	{
+		return;
+	}
+
+	int32 ActivationIndex = INDEX_NONE;
+	if (OpenActivations.RemoveAndCopyValue(TPair<int32, FGuid>(*InstanceIndex, NodeGuid), ActivationIndex))
+	{
+		FFlowTraceNodeActivation& Activation = Instances[*InstanceIndex].Activations[ActivationIndex];
+		Activation.EndTime = Time;
+
+		GetNodeStats(*InstanceIndex, NodeGuid).ActiveTime += Activation.EndTime - Activation.StartTime;
+	}
+}
+
+void FFlowTraceProvider::OnPinTriggered(const uint32 InstanceId, const FGuid& NodeGuid, const double Time)
+{
+	Session.WriteAccessCheck();
+
+	GetNodeStats(GetLiveInstanceIndex(InstanceId, Time), NodeGuid).PinTriggers++;
+}
+
+void FFlowTraceProvider::OnDataPinResolved(const uint32 InstanceId, const FGuid& NodeGuid, const double Time)
+{
+	Session.WriteAccessCheck();
+
+	GetNodeStats(GetLiveInstanceIndex(InstanceId, Time), NodeGuid).DataPinResolves++;
+}
+
+void FFlowTraceProvider::GetHottestNodes(const int32 MaxNum, TArray<FFlowTraceNodeStats>& OutNodes) const
+{
+	Session.ReadAccessCheck();
+
+	NodeStats.GenerateValueArray(OutNodes);
+	OutNodes.Sort([](const FFlowTraceNodeStats& A, const FFlowTraceNodeStats& B)
+	{
+		return A.GetEventsNum() != B.GetEventsNum() ? A.GetEventsNum() > B.GetEventsNum() : A.ActiveTime > B.ActiveTime;
+	});
+
+	if (MaxNum >= 0 && OutNodes.Num() > MaxNum)
+	{
+		OutNodes.SetNum(MaxNum);
+	}
+}
+
+int32 FFlowTraceProvider::GetLiveInstanceIndex(const uint32 InstanceId, const double Time)
+{
+	if (const int32* InstanceIndex = LiveInstanceIndices.Find(InstanceId))
+	{
+		return *InstanceIndex;
+	}
+
+	// asset of this instance is unknown
+	AddInstance(InstanceId, 0, Time);
+	return Instances.Num() - 1;
+}
+
+FFlowTraceNodeStats& FFlowTraceProvider::GetNodeStats(const int32 InstanceIndex, const FGuid& NodeGuid)
+{
+	const uint32 AssetId = Instances[InstanceIndex].AssetId;
+
+	FFlowTraceNodeStats& Stats = NodeStats.FindOrAdd(TPair<uint32, FGuid>(AssetId, NodeGuid));
+	Stats.AssetId = AssetId;
+	Stats.NodeGuid = NodeGuid;
+	return Stats;
+}
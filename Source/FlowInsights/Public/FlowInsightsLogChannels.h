@@ -0,0 +1,7 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Logging/LogMacros.h"
+
+FLOWINSIGHTS_API DECLARE_LOG_CATEGORY_EXTERN(LogFlowInsights, Log, All);
@@ -0,0 +1,27 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Modules/ModuleInterface.h"
+
+class FFlowTraceModule;
+class IConsoleObject;
+
+/**
+ * Analyzes Flow execution recorded on FlowChannel, see FFlowTrace
+ * Registers the analyzer in Trace Services, so Flow events are available in every analysis session, in the editor and in Unreal Insights
+ * It doesn't add a track to the Timing View, results are available as text reports and through FFlowTraceProvider
+ */
+class FFlowInsightsModule final : public IModuleInterface
+{
+public:
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+
+private:
+	// Analyzes trace file and logs the hottest nodes and the timeline of every instance
+	static void ReportTraceFile(const TArray<FString>& Args);
+
+	TSharedPtr<FFlowTraceModule> TraceModule;
+	IConsoleObject* ReportCommand = nullptr;
+};
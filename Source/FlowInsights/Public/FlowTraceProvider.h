@@ -0,0 +1,84 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Misc/Guid.h"
+#include "TraceServices/Model/AnalysisSession.h"
+
+// Activation of a single node, EndTime is negative if the node didn't finish before the end of the trace
+struct FFlowTraceNodeActivation
+{
+	FGuid NodeGuid;
+	double StartTime = 0.0;
+	double EndTime = -1.0;
+};
+
+// Flow Asset instance recorded in the trace, with activations of its nodes in the order of activation
+struct FFlowTraceInstance
+{
+	uint32 InstanceId = 0;
+	uint32 AssetId = 0;
+	double CreateTime = 0.0;
+	double DestroyTime = -1.0;
+
+	TArray<FFlowTraceNodeActivation> Activations;
+};
+
+// Counters of a single node, summed over all instances of its asset
+struct FFlowTraceNodeStats
+{
+	uint32 AssetId = 0;
+	FGuid NodeGuid;
+
+	uint32 Activations = 0;
+	uint32 PinTriggers = 0;
+	uint32 DataPinResolves = 0;
+	double ActiveTime = 0.0;
+
+	uint32 GetEventsNum() const { return Activations + PinTriggers + DataPinResolves; }
+};
+
+/**
+ * Flow execution recorded by FlowChannel events
+ * Read it with IAnalysisSession::ReadProvider under FAnalysisSessionReadScope
+ */
+class FLOWINSIGHTS_API FFlowTraceProvider : public TraceServices::IProvider
+{
+public:
+	static const FName ProviderName;
+
+	explicit FFlowTraceProvider(TraceServices::IAnalysisSession& InSession);
+
+	void AddAssetPath(const uint32 AssetId, const FString& Path);
+	void AddInstance(const uint32 InstanceId, const uint32 AssetId, const double Time);
+	void RemoveInstance(const uint32 InstanceId, const double Time);
+
+	void OnNodeActivated(const uint32 InstanceId, const FGuid& NodeGuid, const double Time);
+	void OnNodeFinished(const uint32 InstanceId, const FGuid& NodeGuid, const double Time);
+	void OnPinTriggered(const uint32 InstanceId, const FGuid& NodeGuid, const double Time);
+	void OnDataPinResolved(const uint32 InstanceId, const FGuid& NodeGuid, const double Time);
+
+	const FString* FindAssetPath(const uint32 AssetId) const { return AssetPaths.Find(AssetId); }
+	const TArray<FFlowTraceInstance>& GetInstances() const { return Instances; }
+
+	// Nodes with the most events first
+	void GetHottestNodes(const int32 MaxNum, TArray<FFlowTraceNodeStats>& OutNodes) const;
+
+private:
+	// Instance created before enabling the channel is added on its first event
+	int32 GetLiveInstanceIndex(const uint32 InstanceId, const double Time);
+	FFlowTraceNodeStats& GetNodeStats(const int32 InstanceIndex, const FGuid& NodeGuid);
+
+	TraceServices::IAnalysisSession& Session;
+
+	TMap<uint32, FString> AssetPaths;
+	TArray<FFlowTraceInstance> Instances;
+
+	// Object identifiers are reused after destroying the instance, so only living instances are indexed
+	TMap<uint32, int32> LiveInstanceIndices;
+
+	// Index in FFlowTraceInstance::Activations of the node that didn't finish yet, by the instance index
+	TMap<TPair<int32, FGuid>, int32> OpenActivations;
+
+	TMap<TPair<uint32, FGuid>, FFlowTraceNodeStats> NodeStats;
+};
@@ -0,0 +1,21 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+using UnrealBuildTool;
+
+public class FlowTests : ModuleRules
+{
+	public FlowTests(ReadOnlyTargetRules target) : base(target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateDependencyModuleNames.AddRange(new[]
+		{
+			"Core",
+			"CoreUObject",
+			"Engine",
+			"Flow",
+			"GameplayTags",
+			"Json"
+		});
+	}
+}
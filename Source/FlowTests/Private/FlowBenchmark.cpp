@@ -0,0 +1,607 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+/**
+ * Benchmark of the Flow runtime on synthetic graphs, writes its results to a JSON report
+ *
+ * Run it headless:
+ * UnrealEditor-Cmd <Project>.uproject -ExecCmds="Automation RunTests Flow.Benchmark; Quit" -nullrhi -unattended -nosplash -nosound
+ *
+ * Report is written to <Project>/Saved/Automation/FlowBenchmark.json, unless -FlowBenchmarkOutput=<path> is provided
+ * Timings are reported in nanoseconds per operation, measured over several samples after warming up
+ */
+
+#include "FlowTestGraphBuilder.h"
+#include "FlowTestNodes.h"
+#include "FlowTestWorld.h"
+#include "FlowTestsLogChannels.h"
+
+#include "FlowAsset.h"
+#include "FlowSave.h"
+#include "FlowSettings.h"
+#include "FlowSubsystem.h"
+
+#include "Dom/JsonObject.h"
+#include "GameFramework/Actor.h"
+#include "HAL/PlatformProperties.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "NativeGameplayTags.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FlowBenchmark
+{
+	constexpr int32 WarmUpSamples = 3;
+	constexpr int32 MeasuredSamples = 20;
+
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Benchmark, "FlowTests.Benchmark");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Group0, "FlowTests.Benchmark.Group0");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Group1, "FlowTests.Benchmark.Group1");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Group2, "FlowTests.Benchmark.Group2");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Group3, "FlowTests.Benchmark.Group3");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Group4, "FlowTests.Benchmark.Group4");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Group5, "FlowTests.Benchmark.Group5");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Group6, "FlowTests.Benchmark.Group6");
+	UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Group7, "FlowTests.Benchmark.Group7");
+
+	// Calls the sample function after warming up, it returns seconds spent in the measured part of the sample
+	template <typename SampleFunctionType>
+	TArray<double> RunSamples(SampleFunctionType&& SampleFunction)
+	{
+		for (int32 SampleIndex = 0; SampleIndex < WarmUpSamples; SampleIndex++)
+		{
+			SampleFunction();
+		}
+
+		TArray<double> SampleSeconds;
+		SampleSeconds.Reserve(MeasuredSamples);
+		for (int32 SampleIndex = 0; SampleIndex < MeasuredSamples; SampleIndex++)
+		{
+			SampleSeconds.Add(SampleFunction());
+		}
+		return SampleSeconds;
+	}
+
+	template <typename FunctionType>
+	double Time(FunctionType&& Function)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Function();
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	class FReport
+	{
+	public:
+		FReport()
+			: Metadata(MakeShared<FJsonObject>())
+		{
+			const UFlowSettings* Settings = UFlowSettings::Get();
+
+			Metadata->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+			Metadata->SetStringField(TEXT("engine_version"), FEngineVersion::Current().ToString());
+			Metadata->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+			Metadata->SetStringField(TEXT("build_configuration"), LexToString(FApp::GetBuildConfiguration()));
+			Metadata->SetStringField(TEXT("cpu"), FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+			Metadata->SetNumberField(TEXT("logical_cores"), FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+			Metadata->SetNumberField(TEXT("warm_up_samples"), WarmUpSamples);
+			Metadata->SetNumberField(TEXT("measured_samples"), MeasuredSamples);
+
+			const TSharedRef<FJsonObject> SettingsObject = MakeShared<FJsonObject>();
+			SettingsObject->SetBoolField(TEXT("use_signal_queue"), Settings->bUseSignalQueue);
+			SettingsObject->SetNumberField(TEXT("max_pooled_instances_per_template"), Settings->MaxPooledInstancesPerTemplate);
+			SettingsObject->SetBoolField(TEXT("use_compact_save_archive"), Settings->bUseCompactSaveArchive);
+			SettingsObject->SetBoolField(TEXT("incremental_saving"), Settings->bIncrementalSaving);
+			Metadata->SetObjectField(TEXT("settings"), SettingsObject);
+		}
+
+		void AddTiming(const FString& Name, const FString& Description, const int32 OperationsPerSample, const TArray<double>& SampleSeconds)
+		{
+			TArray<double> Nanoseconds;
+			for (const double Seconds : SampleSeconds)
+			{
+				Nanoseconds.Add(Seconds * 1e9 / OperationsPerSample);
+			}
+			Nanoseconds.Sort();
+
+			const int32 Num = Nanoseconds.Num();
+			const double Median = Num % 2 == 0 ? (Nanoseconds[Num / 2 - 1] + Nanoseconds[Num / 2]) * 0.5 : Nanoseconds[Num / 2];
+			const double P95 = Nanoseconds[FMath::Clamp(FMath::CeilToInt(Num * 0.95) - 1, 0, Num - 1)];
+
+			double Mean = 0.0;
+			for (const double Value : Nanoseconds)
+			{
+				Mean += Value;
+			}
+			Mean /= Num;
+
+			double Variance = 0.0;
+			for (const double Value : Nanoseconds)
+			{
+				Variance += FMath::Square(Value - Mean);
+			}
+			const double StdDev = FMath::Sqrt(Variance / Num);
+
+			const TSharedRef<FJsonObject> Timing = MakeShared<FJsonObject>();
+			Timing->SetStringField(TEXT("name"), Name);
+			Timing->SetStringField(TEXT("description"), Description);
+			Timing->SetStringField(TEXT("unit"), TEXT("ns/op"));
+			Timing->SetNumberField(TEXT("operations_per_sample"), OperationsPerSample);
+			Timing->SetNumberField(TEXT("min"), Nanoseconds[0]);
+			Timing->SetNumberField(TEXT("median"), Median);
+			Timing->SetNumberField(TEXT("mean"), Mean);
+			Timing->SetNumberField(TEXT("stddev"), StdDev);
+			Timing->SetNumberField(TEXT("p95"), P95);
+			Timings.Add(MakeShared<FJsonValueObject>(Timing));
+
+			UE_LOG(LogFlowTests, Display, TEXT("%s: median %.1f ns/op, p95 %.1f ns/op"), *Name, Median, P95);
+		}
+
+		void AddSize(const FString& Name, const FString& Description, const int64 Bytes)
+		{
+			const TSharedRef<FJsonObject> Size = MakeShared<FJsonObject>();
+			Size->SetStringField(TEXT("name"), Name);
+			Size->SetStringField(TEXT("description"), Description);
+			Size->SetStringField(TEXT("unit"), TEXT("bytes"));
+			Size->SetNumberField(TEXT("value"), Bytes);
+			Sizes.Add(MakeShared<FJsonValueObject>(Size));
+
+			UE_LOG(LogFlowTests, Display, TEXT("%s: %lld bytes"), *Name, Bytes);
+		}
+
+		bool Write(const FString& FilePath) const
+		{
+			const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+			Root->SetObjectField(TEXT("metadata"), Metadata);
+			Root->SetArrayField(TEXT("timings"), Timings);
+			Root->SetArrayField(TEXT("sizes"), Sizes);
+
+			FString JsonString;
+			const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonString);
+			return FJsonSerializer::Serialize(Root, Writer) && FFileHelper::SaveStringToFile(JsonString, *FilePath);
+		}
+
+	private:
+		TSharedRef<FJsonObject> Metadata;
+		TArray<TSharedPtr<FJsonValue>> Timings;
+		TArray<TSharedPtr<FJsonValue>> Sizes;
+	};
+
+	FString GetReportPath()
+	{
+		FString FilePath;
+		if (FParse::Value(FCommandLine::Get(), TEXT("FlowBenchmarkOutput="), FilePath))
+		{
+			return FilePath;
+		}
+		return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Automation"), TEXT("FlowBenchmark.json"));
+	}
+
+	// Signal queue is measured without the frame budget, so every run completes within the sample
+	struct FSignalQueueGuard
+	{
+		explicit FSignalQueueGuard(const bool bUseSignalQueue)
+			: UseSignalQueue(UFlowSettings::Get()->bUseSignalQueue, bUseSignalQueue)
+			, SignalsPerFrame(UFlowSettings::Get()->MaxSignalsPerFrame, 0)
+			, SignalsBeforeLoopGuard(UFlowSettings::Get()->MaxSignalsBeforeLoopGuard, MAX_int32)
+		{
+		}
+
+		TGuardValue<bool> UseSignalQueue;
+		TGuardValue<int32> SignalsPerFrame;
+		TGuardValue<int32> SignalsBeforeLoopGuard;
+	};
+
+	void BenchmarkCreateFlowInstance(FReport& Report, const FFlowTestWorld& TestWorld)
+	{
+		constexpr int32 NodesNum = 64;
+		constexpr int32 InstancesPerSample = 32;
+
+		UFlowSubsystem* FlowSubsystem = TestWorld.GetFlowSubsystem();
+		UFlowAsset* FlowAsset = FFlowTestGraphBuilder::BuildLinearChain(NodesNum);
+		AActor* Owner = TestWorld.SpawnActor();
+
+		auto SampleCreate = [&]()
+		{
+			TArray<UFlowAsset*> Instances;
+			const double Seconds = Time([&]()
+			{
+				for (int32 Index = 0; Index < InstancesPerSample; Index++)
+				{
+					Instances.Add(FlowSubsystem->CreateFlowInstance(Owner, FlowAsset));
+				}
+			});
+
+			for (UFlowAsset* Instance : Instances)
+			{
+				Instance->FinishFlow(EFlowFinishPolicy::Keep);
+			}
+			return Seconds;
+		};
+
+		const FString Description = FString::Printf(TEXT("UFlowSubsystem::CreateFlowInstance of a linear chain with %d nodes"), NodesNum);
+		{
+			const TGuardValue<int32> PoolGuard(UFlowSettings::Get()->MaxPooledInstancesPerTemplate, 0);
+			Report.AddTiming(TEXT("create_flow_instance"), Description, InstancesPerSample, RunSamples(SampleCreate));
+		}
+		{
+			const TGuardValue<int32> PoolGuard(UFlowSettings::Get()->MaxPooledInstancesPerTemplate, InstancesPerSample);
+			FlowSubsystem->WarmUpInstancePool(FlowAsset, InstancesPerSample);
+			Report.AddTiming(TEXT("create_flow_instance_pooled"), Description + TEXT(", taken from a warmed up pool"), InstancesPerSample, RunSamples(SampleCreate));
+		}
+	}
+
+	void BenchmarkPinThroughput(FReport& Report, const FFlowTestWorld& TestWorld)
+	{
+		constexpr int32 ChainLength = 1024;
+		constexpr int32 BranchesNum = 32;
+
+		UFlowSubsystem* FlowSubsystem = TestWorld.GetFlowSubsystem();
+		AActor* Owner = TestWorld.SpawnActor();
+
+		// graphs without the Finish node, so the instance is restarted by every sample
+		struct FGraph
+		{
+			FString Name;
+			FString Description;
+			UFlowAsset* FlowAsset;
+			int32 SignalsNum;
+		};
+		const TArray<FGraph> Graphs = {
+			{TEXT("linear_chain"), FString::Printf(TEXT("linear chain with %d nodes"), ChainLength), FFlowTestGraphBuilder::BuildLinearChain(ChainLength), ChainLength},
+			{TEXT("fan_out"), FString::Printf(TEXT("fan out to %d chains with %d nodes"), BranchesNum, ChainLength / BranchesNum), FFlowTestGraphBuilder::BuildFanOut(BranchesNum, ChainLength / BranchesNum), ChainLength + 1},
+		};
+
+		for (const FGraph& Graph : Graphs)
+		{
+			UFlowAsset* FlowInstance = FlowSubsystem->CreateFlowInstance(Owner, Graph.FlowAsset);
+
+			for (const bool bUseSignalQueue : {false, true})
+			{
+				const FSignalQueueGuard QueueGuard(bUseSignalQueue);
+				const TArray<double> SampleSeconds = RunSamples([&]()
+				{
+					return Time([&]()
+					{
+						FlowInstance->StartFlow();
+					});
+				});
+
+				const FString Name = FString::Printf(TEXT("pin_throughput_%s_%s"), *Graph.Name, bUseSignalQueue ? TEXT("queue") : TEXT("direct"));
+				const FString Description = FString::Printf(TEXT("Triggered input pins while running a %s, %s"), *Graph.Description, bUseSignalQueue ? TEXT("with the signal queue") : TEXT("without the signal queue"));
+				Report.AddTiming(Name, Description, Graph.SignalsNum, SampleSeconds);
+			}
+
+			FlowInstance->FinishFlow(EFlowFinishPolicy::Keep);
+		}
+
+		// sub-flows are created and removed on every run, so this includes instancing of every level
+		constexpr int32 Depth = 8;
+		constexpr int32 RunsPerSample = 16;
+		UFlowAsset* NestedAsset = FFlowTestGraphBuilder::BuildNestedSubGraphs(Depth);
+
+		const FSignalQueueGuard QueueGuard(UFlowSettings::Get()->bUseSignalQueue);
+		const TArray<double> SampleSeconds = RunSamples([&]()
+		{
+			return Time([&]()
+			{
+				for (int32 Index = 0; Index < RunsPerSample; Index++)
+				{
+					UFlowAsset* FlowInstance = FlowSubsystem->CreateFlowInstance(Owner, NestedAsset);
+					FlowInstance->StartFlow();
+					FlowInstance->FinishFlow(EFlowFinishPolicy::Keep);
+				}
+			});
+		});
+		Report.AddTiming(TEXT("run_nested_subgraphs"), FString::Printf(TEXT("Creating, running and finishing %d levels of nested SubGraphs"), Depth), RunsPerSample, SampleSeconds);
+	}
+
+	void BenchmarkDataPins(FAutomationTestBase& Test, FReport& Report, const FFlowTestWorld& TestWorld)
+	{
+		constexpr int32 ResolvesPerSample = 4096;
+		constexpr int32 ConsumersNum = 256;
+
+		UFlowSubsystem* FlowSubsystem = TestWorld.GetFlowSubsystem();
+		UFlowAsset* FlowAsset = FFlowTestGraphBuilder::BuildDataPinGraph(ConsumersNum);
+		UFlowAsset* FlowInstance = FlowSubsystem->CreateFlowInstance(TestWorld.SpawnActor(), FlowAsset);
+
+		const UFlowNode_TestDataConsumer* Consumer = nullptr;
+		for (const TPair<FGuid, UFlowNode*>& Node : FlowAsset->GetNodes())
+		{
+			if (Node.Value->IsA<UFlowNode_TestDataConsumer>())
+			{
+				Consumer = Cast<UFlowNode_TestDataConsumer>(FlowInstance->GetOrCreateNodeInstance(Node.Key));
+				break;
+			}
+		}
+		if (!Test.TestNotNull(TEXT("Data pin consumer"), Consumer))
+		{
+			return;
+		}
+
+		// values are checked once, so the benchmark doesn't measure resolving failures
+		Test.TestEqual(TEXT("Resolved int"), Consumer->TryResolveDataPinAsInt(UFlowNode_TestDataConsumer::INPIN_Int).Value, static_cast<int64>(42));
+		Test.TestEqual(TEXT("Resolved float"), Consumer->TryResolveDataPinAsFloat(UFlowNode_TestDataConsumer::INPIN_Float).Value, 0.5);
+		Test.TestTrue(TEXT("Resolved bool"), Consumer->TryResolveDataPinAsBool(UFlowNode_TestDataConsumer::INPIN_Bool).Value);
+		Test.TestEqual(TEXT("Resolved name"), Consumer->TryResolveDataPinAsName(UFlowNode_TestDataConsumer::INPIN_Name).Value, FName(TEXT("FlowTest")));
+
+		auto AddResolveTiming = [&](const FString& TypeName, auto&& Resolve)
+		{
+			const TArray<double> SampleSeconds = RunSamples([&]()
+			{
+				return Time([&]()
+				{
+					for (int32 Index = 0; Index < ResolvesPerSample; Index++)
+					{
+						Resolve();
+					}
+				});
+			});
+			Report.AddTiming(TEXT("try_resolve_data_pin_as_") + TypeName.ToLower(), FString::Printf(TEXT("UFlowNode::TryResolveDataPinAs%s on a connected pin"), *TypeName), ResolvesPerSample, SampleSeconds);
+		};
+
+		AddResolveTiming(TEXT("Int"), [Consumer]() { return Consumer->TryResolveDataPinAsInt(UFlowNode_TestDataConsumer::INPIN_Int); });
+		AddResolveTiming(TEXT("Float"), [Consumer]() { return Consumer->TryResolveDataPinAsFloat(UFlowNode_TestDataConsumer::INPIN_Float); });
+		AddResolveTiming(TEXT("Bool"), [Consumer]() { return Consumer->TryResolveDataPinAsBool(UFlowNode_TestDataConsumer::INPIN_Bool); });
+		AddResolveTiming(TEXT("Name"), [Consumer]() { return Consumer->TryResolveDataPinAsName(UFlowNode_TestDataConsumer::INPIN_Name); });
+
+		// every consumer resolves its four pins on execution
+		const FSignalQueueGuard QueueGuard(UFlowSettings::Get()->bUseSignalQueue);
+		const TArray<double> SampleSeconds = RunSamples([&]()
+		{
+			return Time([&]()
+			{
+				FlowInstance->StartFlow();
+			});
+		});
+		Report.AddTiming(TEXT("run_data_pin_graph"), FString::Printf(TEXT("Running a chain of %d nodes resolving four data pins each"), ConsumersNum), ConsumersNum, SampleSeconds);
+
+		FlowInstance->FinishFlow(EFlowFinishPolicy::Keep);
+	}
+
+	// Pins are looked up by scanning the node's pin arrays, these numbers tell if a compact pin table shared by nodes would pay off
+	void BenchmarkPins(FAutomationTestBase& Test, FReport& Report, const FFlowTestWorld& TestWorld)
+	{
+		constexpr int32 BranchesNum = 32;
+		constexpr int32 ChainLength = 32;
+		constexpr int32 LookupsPerSample = 4096;
+
+		UFlowSubsystem* FlowSubsystem = TestWorld.GetFlowSubsystem();
+		UFlowAsset* FlowAsset = FFlowTestGraphBuilder::BuildFanOut(BranchesNum, ChainLength);
+		UFlowAsset* FlowInstance = FlowSubsystem->CreateFlowInstance(TestWorld.SpawnActor(), FlowAsset);
+
+		int64 PinBytes = 0;
+		const UFlowNode* FanOut = nullptr;
+		for (const TPair<FGuid, UFlowNode*>& Node : FlowAsset->GetNodes())
+		{
+			const UFlowNode* NodeInstance = FlowInstance->GetOrCreateNodeInstance(Node.Key);
+			PinBytes += NodeInstance->GetInputPins().GetAllocatedSize() + NodeInstance->GetOutputPins().GetAllocatedSize();
+
+			if (NodeInstance->IsA<UFlowNode_TestFanOut>())
+			{
+				FanOut = NodeInstance;
+			}
+		}
+		Report.AddSize(TEXT("pin_arrays_fan_out"), FString::Printf(TEXT("Allocated pin arrays of all %d node instances of a fan out to %d chains, %d bytes per pin in this build"),
+			FlowAsset->GetNodes().Num(), BranchesNum, static_cast<int32>(sizeof(FFlowPin))), PinBytes);
+
+		if (!Test.TestNotNull(TEXT("Fan out node"), FanOut))
+		{
+			return;
+		}
+
+		// the last pin is the worst case of the linear scan
+		const FName PinName = FanOut->GetOutputPins().Last().PinName;
+		int32 FoundPinsNum = 0;
+		const TArray<double> SampleSeconds = RunSamples([&]()
+		{
+			return Time([&]()
+			{
+				for (int32 Index = 0; Index < LookupsPerSample; Index++)
+				{
+					FoundPinsNum += UFlowNode::FindFlowPinByName(PinName, FanOut->GetOutputPins()) ? 1 : 0;
+				}
+			});
+		});
+		Test.TestEqual(TEXT("Found pins"), FoundPinsNum, LookupsPerSample * (WarmUpSamples + MeasuredSamples));
+		Report.AddTiming(TEXT("find_output_pin_by_name"), FString::Printf(TEXT("UFlowNodeBase::FindFlowPinByName of the last pin of a node with %d output pins"), BranchesNum), LookupsPerSample, SampleSeconds);
+
+		FlowInstance->FinishFlow(EFlowFinishPolicy::Keep);
+	}
+
+	int64 GetRecordBytes(const FFlowAssetSaveData& AssetRecord)
+	{
+		int64 Bytes = AssetRecord.AssetData.Num();
+		for (const FFlowNodeSaveData& NodeRecord : AssetRecord.NodeRecords)
+		{
+			Bytes += sizeof(FGuid) + NodeRecord.NodeData.Num();
+		}
+		return Bytes;
+	}
+
+	void BenchmarkSaving(FAutomationTestBase& Test, FReport& Report, const FFlowTestWorld& TestWorld)
+	{
+		constexpr int32 LatentNodesNum = 64;
+
+		UFlowSubsystem* FlowSubsystem = TestWorld.GetFlowSubsystem();
+		UFlowAsset* FlowAsset = FFlowTestGraphBuilder::BuildLatentGraph(LatentNodesNum);
+		AActor* Owner = TestWorld.SpawnActor();
+		FlowSubsystem->StartRootFlow(Owner, FlowAsset, false);
+
+		for (const bool bUseCompactSaveArchive : {false, true})
+		{
+			const TGuardValue<bool> CompactGuard(UFlowSettings::Get()->bUseCompactSaveArchive, bUseCompactSaveArchive);
+			const FString ArchiveName = bUseCompactSaveArchive ? TEXT("compact") : TEXT("tagged");
+			const FString Description = FString::Printf(TEXT("UFlowSubsystem::OnGameSaved with a Root Flow of %d active nodes, %s archive"), LatentNodesNum, *ArchiveName);
+
+			UFlowSaveGame* SaveGame = NewObject<UFlowSaveGame>();
+			for (const bool bIncrementalSaving : {false, true})
+			{
+				const TGuardValue<bool> IncrementalGuard(UFlowSettings::Get()->bIncrementalSaving, bIncrementalSaving);
+
+				const TArray<double> SampleSeconds = RunSamples([&]()
+				{
+					return Time([&]()
+					{
+						FlowSubsystem->OnGameSaved(SaveGame);
+					});
+				});
+
+				const FString Name = FString::Printf(TEXT("save_instance_%s_%s"), *ArchiveName, bIncrementalSaving ? TEXT("incremental") : TEXT("full"));
+				Report.AddTiming(Name, Description + (bIncrementalSaving ? TEXT(", saving again into the same SaveGame") : TEXT("")), 1, SampleSeconds);
+			}
+
+			if (!Test.TestEqual(TEXT("Saved instances"), SaveGame->FlowInstances.Num(), 1))
+			{
+				continue;
+			}
+
+			Report.AddSize(TEXT("save_record_") + ArchiveName, TEXT("Data of node and asset records of the saved instance"), GetRecordBytes(SaveGame->FlowInstances[0]));
+
+			TArray<uint8> SaveData;
+			if (Test.TestTrue(TEXT("SaveGame written to memory"), UGameplayStatics::SaveGameToMemory(SaveGame, SaveData)))
+			{
+				Report.AddSize(TEXT("save_game_") + ArchiveName, TEXT("UFlowSaveGame written by UGameplayStatics::SaveGameToMemory"), SaveData.Num());
+			}
+
+			// LoadInstance on a fresh instance, as LoadRootFlow does after creating it
+			FlowSubsystem->OnGameLoaded(SaveGame);
+			const FFlowAssetSaveData AssetRecord = SaveGame->FlowInstances[0];
+			const TArray<double> SampleSeconds = RunSamples([&]()
+			{
+				UFlowAsset* FlowInstance = FlowSubsystem->CreateFlowInstance(Owner, FlowAsset);
+				const double Seconds = Time([&]()
+				{
+					FlowInstance->LoadInstance(AssetRecord);
+				});
+				FlowInstance->FinishFlow(EFlowFinishPolicy::Keep);
+				return Seconds;
+			});
+			Report.AddTiming(TEXT("load_instance_") + ArchiveName, FString::Printf(TEXT("UFlowAsset::LoadInstance restoring %d active nodes, %s archive"), LatentNodesNum, *ArchiveName), 1, SampleSeconds);
+		}
+
+		FlowSubsystem->FinishRootFlow(Owner, FlowAsset, EFlowFinishPolicy::Keep);
+	}
+
+	void BenchmarkTagQueries(FAutomationTestBase& Test, FReport& Report, const FFlowTestWorld& TestWorld)
+	{
+		constexpr int32 ActorsNum = 64;
+		constexpr int32 ComponentsPerActor = 64;
+		constexpr int32 QueriesPerSample = 64;
+
+		UFlowSubsystem* FlowSubsystem = TestWorld.GetFlowSubsystem();
+		const TArray<FGameplayTag> GroupTags = {TAG_Group0, TAG_Group1, TAG_Group2, TAG_Group3, TAG_Group4, TAG_Group5, TAG_Group6, TAG_Group7};
+
+		// every component has two group tags, so queries for any and all tags match different sets
+		TArray<UFlowTestComponent*> Components;
+		for (int32 ActorIndex = 0; ActorIndex < ActorsNum; ActorIndex++)
+		{
+			AActor* Actor = TestWorld.SpawnActor();
+			for (int32 Index = 0; Index < ComponentsPerActor; Index++)
+			{
+				UFlowTestComponent* Component = NewObject<UFlowTestComponent>(Actor);
+				Component->IdentityTags.AddTag(GroupTags[Index % GroupTags.Num()]);
+				Component->IdentityTags.AddTag(GroupTags[ActorIndex % GroupTags.Num()]);
+				Component->RegisterComponent();
+				Component->Register();
+				Components.Add(Component);
+			}
+		}
+
+		const TArray<double> RegisterSeconds = RunSamples([&]()
+		{
+			for (UFlowTestComponent* Component : Components)
+			{
+				Component->Unregister();
+			}
+			return Time([&]()
+			{
+				for (UFlowTestComponent* Component : Components)
+				{
+					Component->Register();
+				}
+			});
+		});
+		Report.AddTiming(TEXT("register_component"), TEXT("Registering Flow Component with two identity tags"), Components.Num(), RegisterSeconds);
+
+		Test.TestEqual(TEXT("Components with the exact tag"), FlowSubsystem->GetFlowComponentsByTag(TAG_Group0, UFlowComponent::StaticClass(), true).Num(), ActorsNum * ComponentsPerActor * 15 / 64);
+		Test.TestEqual(TEXT("Components with the parent tag"), FlowSubsystem->GetFlowComponentsByTag(TAG_Benchmark, UFlowComponent::StaticClass(), false).Num(), ActorsNum * ComponentsPerActor);
+
+		FGameplayTagContainer TwoGroups;
+		TwoGroups.AddTag(TAG_Group0);
+		TwoGroups.AddTag(TAG_Group1);
+
+		auto AddQueryTiming = [&](const FString& Name, const FString& Description, auto&& Query)
+		{
+			const TArray<double> SampleSeconds = RunSamples([&]()
+			{
+				return Time([&]()
+				{
+					for (int32 Index = 0; Index < QueriesPerSample; Index++)
+					{
+						Query();
+					}
+				});
+			});
+			Report.AddTiming(Name, FString::Printf(TEXT("%s among %d registered components"), *Description, Components.Num()), QueriesPerSample, SampleSeconds);
+		};
+
+		AddQueryTiming(TEXT("get_components_by_tag_exact"), TEXT("UFlowSubsystem::GetFlowComponentsByTag, exact match"), [&]()
+		{
+			return FlowSubsystem->GetFlowComponentsByTag(TAG_Group0, UFlowComponent::StaticClass(), true);
+		});
+		AddQueryTiming(TEXT("get_components_by_parent_tag"), TEXT("UFlowSubsystem::GetFlowComponentsByTag, parent tag matching every component"), [&]()
+		{
+			return FlowSubsystem->GetFlowComponentsByTag(TAG_Benchmark, UFlowComponent::StaticClass(), false);
+		});
+		AddQueryTiming(TEXT("get_components_by_tags_any"), TEXT("UFlowSubsystem::GetFlowComponentsByTags, any of two tags"), [&]()
+		{
+			return FlowSubsystem->GetFlowComponentsByTags(TwoGroups, EGameplayContainerMatchType::Any, UFlowComponent::StaticClass(), true);
+		});
+		AddQueryTiming(TEXT("get_components_by_tags_all"), TEXT("UFlowSubsystem::GetFlowComponentsByTags, all of two tags"), [&]()
+		{
+			return FlowSubsystem->GetFlowComponentsByTags(TwoGroups, EGameplayContainerMatchType::All, UFlowComponent::StaticClass(), true);
+		});
+
+		for (UFlowTestComponent* Component : Components)
+		{
+			Component->Unregister();
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowBenchmark, "Flow.Benchmark", FLOW_BENCHMARK_FLAGS)
+
+bool FFlowBenchmark::RunTest(const FString& Parameters)
+{
+	const FFlowTestWorld TestWorld;
+	FlowBenchmark::FReport Report;
+
+	FlowBenchmark::BenchmarkCreateFlowInstance(Report, TestWorld);
+	FlowBenchmark::BenchmarkPinThroughput(Report, TestWorld);
+	FlowBenchmark::BenchmarkDataPins(*this, Report, TestWorld);
+	FlowBenchmark::BenchmarkPins(*this, Report, TestWorld);
+	FlowBenchmark::BenchmarkSaving(*this, Report, TestWorld);
+	FlowBenchmark::BenchmarkTagQueries(*this, Report, TestWorld);
+
+	const FString ReportPath = FlowBenchmark::GetReportPath();
+	if (!TestTrue(TEXT("Benchmark report written"), Report.Write(ReportPath)))
+	{
+		return false;
+	}
+
+	UE_LOG(LogFlowTests, Display, TEXT("Flow benchmark report written to %s"), *FPaths::ConvertRelativePathToFull(ReportPath));
+	AddInfo(FString::Printf(TEXT("Report: %s"), *FPaths::ConvertRelativePathToFull(ReportPath)));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,142 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTestGraphBuilder.h"
+#include "FlowTestNodes.h"
+#include "FlowTestWorld.h"
+
+#include "FlowAsset.h"
+#include "FlowSubsystem.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowCompiledGraphEdgesTest, "Flow.CompiledGraph.Edges", FLOW_TEST_FLAGS)
+
+bool FFlowCompiledGraphEdgesTest::RunTest(const FString& Parameters)
+{
+	FFlowTestGraphBuilder Builder(TEXT("FlowTest_CompiledEdges"));
+
+	UFlowNode_TestFanOut* FanOut = Builder.AddNode<UFlowNode_TestFanOut>();
+	FanOut->SetOutputsNum(3);
+	UFlowNode* ConnectedNode = Builder.AddNode<UFlowNode_TestPassThrough>();
+	UFlowNode* TargetOfMissingPin = Builder.AddNode<UFlowNode_TestPassThrough>();
+
+	Builder.Connect(Builder.GetStartNode(), UFlowNode::DefaultOutputPin.PinName, FanOut);
+	Builder.Connect(FanOut, FanOut->GetOutputPins()[0].PinName, ConnectedNode);
+	Builder.Connect(FanOut, FanOut->GetOutputPins()[2].PinName, TargetOfMissingPin, TEXT("MissingPin"));
+	const UFlowAsset* FlowAsset = Builder.Finish();
+
+	const FFlowCompiledGraph& CompiledGraph = FlowAsset->GetCompiledGraph();
+	TestTrue(TEXT("Graph is compiled"), FlowAsset->IsGraphCompiled());
+	TestEqual(TEXT("Compiled nodes"), CompiledGraph.NodeGuids.Num(), FlowAsset->GetNodes().Num());
+	TestEqual(TEXT("Edge ranges"), CompiledGraph.FirstOutputEdges.Num(), FlowAsset->GetNodes().Num() + 1);
+
+	for (const TPair<FGuid, UFlowNode*>& Node : FlowAsset->GetNodes())
+	{
+		const int32 NodeIndex = Node.Value->GetNodeIndex();
+		if (TestTrue(TEXT("Node has valid index"), CompiledGraph.NodeGuids.IsValidIndex(NodeIndex)))
+		{
+			TestEqual(TEXT("GUID of node index"), CompiledGraph.NodeGuids[NodeIndex], Node.Key);
+			TestEqual(TEXT("Edges of node"), CompiledGraph.FirstOutputEdges[NodeIndex + 1] - CompiledGraph.FirstOutputEdges[NodeIndex], Node.Value->GetOutputPins().Num());
+		}
+	}
+
+	const int32 FanOutIndex = FanOut->GetNodeIndex();
+
+	const FFlowCompiledEdge* ConnectedEdge = CompiledGraph.FindOutputEdge(FanOutIndex, 0);
+	if (TestNotNull(TEXT("Edge of the connected pin"), ConnectedEdge))
+	{
+		TestEqual(TEXT("Target node"), ConnectedEdge->NodeIndex, ConnectedNode->GetNodeIndex());
+		TestEqual(TEXT("Target pin"), ConnectedEdge->PinIndex, 0);
+	}
+
+	const FFlowCompiledEdge* UnconnectedEdge = CompiledGraph.FindOutputEdge(FanOutIndex, 1);
+	if (TestNotNull(TEXT("Edge of the unconnected pin"), UnconnectedEdge))
+	{
+		TestFalse(TEXT("Unconnected pin has a target"), UnconnectedEdge->IsConnected());
+	}
+
+	const FFlowCompiledEdge* MissingPinEdge = CompiledGraph.FindOutputEdge(FanOutIndex, 2);
+	if (TestNotNull(TEXT("Edge of the pin connected to a missing input"), MissingPinEdge))
+	{
+		TestFalse(TEXT("Pin connected to a missing input has a target"), MissingPinEdge->IsConnected());
+	}
+
+	TestNull(TEXT("Edge past the last output pin"), CompiledGraph.FindOutputEdge(FanOutIndex, 3));
+	TestNull(TEXT("Edge of invalid node"), CompiledGraph.FindOutputEdge(INDEX_NONE, 0));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowCompiledGraphStaleTest, "Flow.CompiledGraph.Stale", FLOW_TEST_FLAGS)
+
+bool FFlowCompiledGraphStaleTest::RunTest(const FString& Parameters)
+{
+	FFlowTestGraphBuilder Builder(TEXT("FlowTest_CompiledStale"));
+	UFlowNode_TestFanOut* FanOut = Builder.AddNode<UFlowNode_TestFanOut>();
+	Builder.Connect(Builder.GetStartNode(), UFlowNode::DefaultOutputPin.PinName, FanOut);
+	UFlowAsset* FlowAsset = Builder.Finish();
+
+	TestTrue(TEXT("Graph is compiled"), FlowAsset->IsGraphCompiled());
+
+	// i.e. node reconstructed with a different number of pins
+	FanOut->SetOutputsNum(3);
+	TestFalse(TEXT("Graph with changed output pins is compiled"), FlowAsset->IsGraphCompiled());
+
+	FlowAsset->CompileGraph();
+	TestTrue(TEXT("Graph is compiled after changing output pins"), FlowAsset->IsGraphCompiled());
+
+	// i.e. node added to the asset saved before compiling the graph
+	Builder.AddNode<UFlowNode_TestPassThrough>();
+	TestFalse(TEXT("Graph with added node is compiled"), FlowAsset->IsGraphCompiled());
+
+	FlowAsset->CompileGraph();
+	TestTrue(TEXT("Graph is compiled again"), FlowAsset->IsGraphCompiled());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowCompiledGraphInstanceTest, "Flow.CompiledGraph.SharedByInstances", FLOW_TEST_FLAGS)
+
+bool FFlowCompiledGraphInstanceTest::RunTest(const FString& Parameters)
+{
+	const FFlowTestWorld TestWorld;
+	UFlowAsset* FlowAsset = FFlowTestGraphBuilder::BuildLinearChain(4);
+
+	const UFlowAsset* FirstInstance = TestWorld.GetFlowSubsystem()->CreateRootFlow(TestWorld.SpawnActor(), FlowAsset);
+	const UFlowAsset* SecondInstance = TestWorld.GetFlowSubsystem()->CreateRootFlow(TestWorld.SpawnActor(), FlowAsset);
+
+	if (TestNotNull(TEXT("First instance"), FirstInstance) && TestNotNull(TEXT("Second instance"), SecondInstance))
+	{
+		TestEqual(TEXT("Compiled graph of the first instance"), &FirstInstance->GetCompiledGraph(), &FlowAsset->GetCompiledGraph());
+		TestEqual(TEXT("Compiled graph of the second instance"), &SecondInstance->GetCompiledGraph(), &FlowAsset->GetCompiledGraph());
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowCompiledGraphLazyTraversalTest, "Flow.CompiledGraph.LazyTraversal", FLOW_TEST_FLAGS)
+
+bool FFlowCompiledGraphLazyTraversalTest::RunTest(const FString& Parameters)
+{
+	const FFlowTestWorld TestWorld;
+	UFlowAsset* FlowAsset = FFlowTestGraphBuilder::BuildLinearChain(4);
+	FlowAsset->bLazyNodeInstancing = true;
+
+	UFlowAsset* FlowInstance = TestWorld.GetFlowSubsystem()->CreateRootFlow(TestWorld.SpawnActor(), FlowAsset);
+	if (!TestNotNull(TEXT("Flow instance"), FlowInstance))
+	{
+		return false;
+	}
+
+	// traversing the graph doesn't create nodes, they're created only on activation
+	UFlowNode* EntryNode = FlowInstance->GetDefaultEntryNode();
+	const TArray<UFlowNode*> NodesInExecutionOrder = FlowInstance->GetNodesInExecutionOrder(EntryNode, UFlowNode::StaticClass());
+
+	TestEqual(TEXT("Nodes in execution order"), NodesInExecutionOrder.Num(), 5);
+	TestEqual(TEXT("Instanced nodes after traversal"), FlowInstance->GetInstancedNodesNum(), 0);
+	TestNull(TEXT("Instance of the entry node"), EntryNode ? FlowInstance->GetNodeInstance(EntryNode->GetGuid()) : nullptr);
+
+	return true;
+}
+
+#endif
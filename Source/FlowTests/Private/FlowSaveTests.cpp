@@ -0,0 +1,330 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTestGraphBuilder.h"
+#include "FlowTestNodes.h"
+#include "FlowTestWorld.h"
+
+#include "FlowAsset.h"
+#include "FlowSave.h"
+#include "FlowSettings.h"
+#include "FlowSubsystem.h"
+#include "Nodes/Graph/FlowNode_SubGraph.h"
+
+#include "Kismet/GameplayStatics.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FlowSaveTests
+{
+	UFlowAsset* FindRootInstance(const UFlowSubsystem* FlowSubsystem, const UObject* Owner)
+	{
+		const TSet<UFlowAsset*> RootInstances = FlowSubsystem->GetRootInstancesByOwner(Owner);
+		return RootInstances.Num() == 1 ? *RootInstances.CreateConstIterator() : nullptr;
+	}
+
+	TArray<UFlowNode_TestLatent*> GetActiveLatentNodes(const UFlowAsset* FlowInstance)
+	{
+		TArray<UFlowNode_TestLatent*> LatentNodes;
+		for (UFlowNode* Node : FlowInstance->GetActiveNodes())
+		{
+			if (UFlowNode_TestLatent* LatentNode = Cast<UFlowNode_TestLatent>(Node))
+			{
+				LatentNodes.Add(LatentNode);
+			}
+		}
+		return LatentNodes;
+	}
+
+	TArray<int32> GetSavedValues(const TArray<UFlowNode_TestLatent*>& LatentNodes)
+	{
+		TArray<int32> SavedValues;
+		for (const UFlowNode_TestLatent* LatentNode : LatentNodes)
+		{
+			SavedValues.Add(LatentNode->SavedValue);
+		}
+		return SavedValues;
+	}
+
+	// Writes SaveGame the same way as the save file is written, and reads it back
+	UFlowSaveGame* SaveAndReadBack(UFlowSaveGame* SaveGame)
+	{
+		TArray<uint8> SaveData;
+		if (!UGameplayStatics::SaveGameToMemory(SaveGame, SaveData))
+		{
+			return nullptr;
+		}
+
+		return Cast<UFlowSaveGame>(UGameplayStatics::LoadGameFromMemory(SaveData));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowSaveRoundTripTest, "Flow.Save.RoundTrip", FLOW_TEST_FLAGS)
+
+bool FFlowSaveRoundTripTest::RunTest(const FString& Parameters)
+{
+	for (const bool bUseCompactSaveArchive : {false, true})
+	{
+		for (const bool bIncrementalSaving : {false, true})
+		{
+			const FString Context = FString::Printf(TEXT("(compact %d, incremental %d)"), bUseCompactSaveArchive, bIncrementalSaving);
+			TGuardValue<bool> CompactGuard(UFlowSettings::Get()->bUseCompactSaveArchive, bUseCompactSaveArchive);
+			TGuardValue<bool> IncrementalGuard(UFlowSettings::Get()->bIncrementalSaving, bIncrementalSaving);
+
+			const FFlowTestWorld TestWorld;
+			UFlowSubsystem* FlowSubsystem = TestWorld.GetFlowSubsystem();
+			UFlowAsset* FlowAsset = FFlowTestGraphBuilder::BuildLatentGraph(3);
+			AActor* Owner = TestWorld.SpawnActor();
+
+			FlowSubsystem->StartRootFlow(Owner, FlowAsset, false);
+			UFlowAsset* FlowInstance = FlowSaveTests::FindRootInstance(FlowSubsystem, Owner);
+			if (!TestNotNull(*FString::Printf(TEXT("Started instance %s"), *Context), FlowInstance))
+			{
+				continue;
+			}
+
+			// the saved state differs from the state right after starting the flow
+			TArray<UFlowNode_TestLatent*> LatentNodes = FlowSaveTests::GetActiveLatentNodes(FlowInstance);
+			TestEqual(*FString::Printf(TEXT("Values of started nodes %s"), *Context), FlowSaveTests::GetSavedValues(LatentNodes), TArray<int32>({1, 2, 3}));
+			if (LatentNodes.Num() == 3)
+			{
+				LatentNodes[1]->Complete();
+			}
+
+			UFlowSaveGame* SaveGame = NewObject<UFlowSaveGame>();
+			FlowSubsystem->OnGameSaved(SaveGame);
+			TestEqual(*FString::Printf(TEXT("Records reused by the first save %s"), *Context), FlowSubsystem->LastSaveStats.ReusedRecords, 0);
+
+			// compact records index the table kept by the subsystem, so they're reused like records in the legacy format
+			FlowSubsystem->OnGameSaved(SaveGame);
+			if (bIncrementalSaving)
+			{
+				TestTrue(*FString::Printf(TEXT("Records reused by the second save %s"), *Context), FlowSubsystem->LastSaveStats.ReusedRecords > 0);
+				TestEqual(*FString::Printf(TEXT("Records serialized by the second save %s"), *Context), FlowSubsystem->LastSaveStats.SerializedRecords, 0);
+			}
+			else
+			{
+				TestEqual(*FString::Printf(TEXT("Records reused by the second save %s"), *Context), FlowSubsystem->LastSaveStats.ReusedRecords, 0);
+			}
+			TestEqual(*FString::Printf(TEXT("Saved instances %s"), *Context), SaveGame->FlowInstances.Num(), 1);
+
+			// new SaveGame object for every save, as Checkpoint node does
+			UFlowSaveGame* NextSaveGame = NewObject<UFlowSaveGame>();
+			FlowSubsystem->OnGameSaved(NextSaveGame);
+			if (bIncrementalSaving)
+			{
+				TestEqual(*FString::Printf(TEXT("Records serialized into the new SaveGame %s"), *Context), FlowSubsystem->LastSaveStats.SerializedRecords, 0);
+			}
+			if (bUseCompactSaveArchive)
+			{
+				TestEqual(*FString::Printf(TEXT("Entries of the new SaveGame table %s"), *Context), NextSaveGame->SaveTable.Num(), SaveGame->SaveTable.Num());
+			}
+
+			const FString InstanceName = FlowInstance->GetName();
+			FlowSubsystem->FinishRootFlow(Owner, FlowAsset, EFlowFinishPolicy::Keep);
+
+			UFlowSaveGame* LoadedSaveGame = FlowSaveTests::SaveAndReadBack(SaveGame);
+			if (!TestNotNull(*FString::Printf(TEXT("SaveGame read back from memory %s"), *Context), LoadedSaveGame))
+			{
+				continue;
+			}
+
+			FlowSubsystem->OnGameLoaded(LoadedSaveGame);
+			FlowSubsystem->LoadRootFlow(Owner, FlowAsset, InstanceName);
+
+			UFlowAsset* LoadedInstance = FlowSaveTests::FindRootInstance(FlowSubsystem, Owner);
+			if (!TestNotNull(*FString::Printf(TEXT("Loaded instance %s"), *Context), LoadedInstance))
+			{
+				continue;
+			}
+
+			// active nodes are restored in execution order
+			LatentNodes = FlowSaveTests::GetActiveLatentNodes(LoadedInstance);
+			TestEqual(*FString::Printf(TEXT("Values of loaded nodes %s"), *Context), FlowSaveTests::GetSavedValues(LatentNodes), TArray<int32>({1, 3}));
+
+			for (UFlowNode_TestLatent* LatentNode : LatentNodes)
+			{
+				LatentNode->Complete();
+			}
+			TestEqual(*FString::Printf(TEXT("Active nodes after completing loaded nodes %s"), *Context), LoadedInstance->GetActiveNodes().Num(), 0);
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowSaveSubGraphTest, "Flow.Save.SubGraph", FLOW_TEST_FLAGS)
+
+bool FFlowSaveSubGraphTest::RunTest(const FString& Parameters)
+{
+	const FFlowTestWorld TestWorld;
+	UFlowSubsystem* FlowSubsystem = TestWorld.GetFlowSubsystem();
+	AActor* Owner = TestWorld.SpawnActor();
+
+	FFlowTestGraphBuilder SubGraphBuilder(TEXT("FlowTest_SavedSubGraph"));
+	UFlowNode_TestLatent* LatentNode = SubGraphBuilder.AddNode<UFlowNode_TestLatent>();
+	LatentNode->ValueToSave = 7;
+	SubGraphBuilder.Connect(SubGraphBuilder.GetStartNode(), UFlowNode::DefaultOutputPin.PinName, LatentNode);
+	UFlowAsset* SubGraphAsset = SubGraphBuilder.Finish();
+
+	FFlowTestGraphBuilder Builder(TEXT("FlowTest_SavedRoot"));
+	UFlowNode_SubGraph* SubGraphNode = Builder.AddNode<UFlowNode_SubGraph>();
+	Builder.SetSubGraphAsset(SubGraphNode, SubGraphAsset);
+	Builder.Connect(Builder.GetStartNode(), UFlowNode::DefaultOutputPin.PinName, SubGraphNode);
+	UFlowAsset* FlowAsset = Builder.Finish();
+
+	FlowSubsystem->StartRootFlow(Owner, FlowAsset, false);
+	const UFlowAsset* FlowInstance = FlowSaveTests::FindRootInstance(FlowSubsystem, Owner);
+	if (!TestNotNull(TEXT("Started instance"), FlowInstance))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Started sub-flows"), FlowSubsystem->GetInstancedSubFlows().Num(), 1);
+
+	UFlowSaveGame* SaveGame = NewObject<UFlowSaveGame>();
+	FlowSubsystem->OnGameSaved(SaveGame);
+	TestEqual(TEXT("Saved instances"), SaveGame->FlowInstances.Num(), 2);
+
+	const FString InstanceName = FlowInstance->GetName();
+	FlowSubsystem->FinishRootFlow(Owner, FlowAsset, EFlowFinishPolicy::Keep);
+	TestEqual(TEXT("Sub-flows after finishing the Root Flow"), FlowSubsystem->GetInstancedSubFlows().Num(), 0);
+
+	UFlowSaveGame* LoadedSaveGame = FlowSaveTests::SaveAndReadBack(SaveGame);
+	if (!TestNotNull(TEXT("SaveGame read back from memory"), LoadedSaveGame))
+	{
+		return false;
+	}
+
+	FlowSubsystem->OnGameLoaded(LoadedSaveGame);
+	FlowSubsystem->LoadRootFlow(Owner, FlowAsset, InstanceName);
+
+	TestNotNull(TEXT("Loaded instance"), FlowSaveTests::FindRootInstance(FlowSubsystem, Owner));
+	if (TestEqual(TEXT("Loaded sub-flows"), FlowSubsystem->GetInstancedSubFlows().Num(), 1))
+	{
+		const UFlowAsset* SubFlowInstance = FlowSubsystem->GetInstancedSubFlows().CreateConstIterator().Value();
+		TestEqual(TEXT("Values of loaded sub-flow nodes"), FlowSaveTests::GetSavedValues(FlowSaveTests::GetActiveLatentNodes(SubFlowInstance)), TArray<int32>({7}));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowSaveExecutionOrderTest, "Flow.Save.ExecutionOrder", FLOW_TEST_FLAGS)
+
+bool FFlowSaveExecutionOrderTest::RunTest(const FString& Parameters)
+{
+	const FFlowTestWorld TestWorld;
+	UFlowSubsystem* FlowSubsystem = TestWorld.GetFlowSubsystem();
+	AActor* Owner = TestWorld.SpawnActor();
+
+	// Start -> Fan Out -> (First -> Third, Second), Third is activated after Second, but it's earlier in execution order
+	FFlowTestGraphBuilder Builder(TEXT("FlowTest_SavedExecutionOrder"));
+	UFlowNode_TestFanOut* FanOut = Builder.AddNode<UFlowNode_TestFanOut>();
+	FanOut->SetOutputsNum(2);
+	UFlowNode_TestLatent* FirstNode = Builder.AddNode<UFlowNode_TestLatent>();
+	FirstNode->ValueToSave = 1;
+	UFlowNode_TestLatent* SecondNode = Builder.AddNode<UFlowNode_TestLatent>();
+	SecondNode->ValueToSave = 2;
+	UFlowNode_TestLatent* ThirdNode = Builder.AddNode<UFlowNode_TestLatent>();
+	ThirdNode->ValueToSave = 3;
+
+	Builder.Connect(Builder.GetStartNode(), UFlowNode::DefaultOutputPin.PinName, FanOut);
+	Builder.Connect(FanOut, FanOut->GetOutputPins()[0].PinName, FirstNode);
+	Builder.Connect(FanOut, FanOut->GetOutputPins()[1].PinName, SecondNode);
+	Builder.Connect(FirstNode, UFlowNode::DefaultOutputPin.PinName, ThirdNode);
+	UFlowAsset* FlowAsset = Builder.Finish();
+
+	TestTrue(TEXT("Compiled index of Third node precedes Second node"), ThirdNode->GetNodeIndex() < SecondNode->GetNodeIndex());
+
+	FlowSubsystem->StartRootFlow(Owner, FlowAsset, false);
+	const UFlowAsset* FlowInstance = FlowSaveTests::FindRootInstance(FlowSubsystem, Owner);
+	if (!TestNotNull(TEXT("Started instance"), FlowInstance))
+	{
+		return false;
+	}
+
+	if (UFlowNode_TestLatent* FirstNodeInstance = Cast<UFlowNode_TestLatent>(FlowInstance->GetNodeInstance(FirstNode->GetGuid())))
+	{
+		FirstNodeInstance->Complete();
+	}
+	TestEqual(TEXT("Values of active nodes in activation order"), FlowSaveTests::GetSavedValues(FlowSaveTests::GetActiveLatentNodes(FlowInstance)), TArray<int32>({2, 3}));
+
+	UFlowSaveGame* SaveGame = NewObject<UFlowSaveGame>();
+	FlowSubsystem->OnGameSaved(SaveGame);
+
+	const FString InstanceName = FlowInstance->GetName();
+	const FFlowAssetSaveData* AssetRecord = SaveGame->FlowInstances.FindByPredicate([&InstanceName](const FFlowAssetSaveData& Record)
+	{
+		return Record.InstanceName == InstanceName;
+	});
+	if (TestNotNull(TEXT("Saved instance"), AssetRecord) && TestEqual(TEXT("Saved nodes"), AssetRecord->NodeRecords.Num(), 2))
+	{
+		// records follow the execution order, LoadInstance restores them backward
+		TestTrue(TEXT("First saved node is Third node"), AssetRecord->NodeRecords[0].NodeGuid == ThirdNode->GetGuid());
+		TestTrue(TEXT("Second saved node is Second node"), AssetRecord->NodeRecords[1].NodeGuid == SecondNode->GetGuid());
+	}
+
+	FlowSubsystem->FinishRootFlow(Owner, FlowAsset, EFlowFinishPolicy::Keep);
+	FlowSubsystem->OnGameLoaded(SaveGame);
+	FlowSubsystem->LoadRootFlow(Owner, FlowAsset, InstanceName);
+
+	const UFlowAsset* LoadedInstance = FlowSaveTests::FindRootInstance(FlowSubsystem, Owner);
+	if (TestNotNull(TEXT("Loaded instance"), LoadedInstance))
+	{
+		TestEqual(TEXT("Values of loaded nodes in execution order"), FlowSaveTests::GetSavedValues(FlowSaveTests::GetActiveLatentNodes(LoadedInstance)), TArray<int32>({3, 2}));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowSaveAsyncTest, "Flow.Save.Async", FLOW_TEST_FLAGS)
+
+bool FFlowSaveAsyncTest::RunTest(const FString& Parameters)
+{
+	static const FString SlotName = TEXT("FlowTest_Async");
+
+	for (const bool bCompressSaveGames : {false, true})
+	{
+		const FString Context = FString::Printf(TEXT("(compressed %d)"), bCompressSaveGames);
+		TGuardValue<bool> CompressGuard(UFlowSettings::Get()->bCompressSaveGames, bCompressSaveGames);
+
+		const FFlowTestWorld TestWorld;
+		UFlowSubsystem* FlowSubsystem = TestWorld.GetFlowSubsystem();
+		FlowSubsystem->StartRootFlow(TestWorld.SpawnActor(), FFlowTestGraphBuilder::BuildLatentGraph(3), false);
+
+		TMap<UFlowSaveGame*, EFlowSaveGameResult> Results;
+		const FFlowSaveGameCompleted OnCompleted = FFlowSaveGameCompleted::CreateLambda([&Results](UFlowSaveGame* SaveGame, const EFlowSaveGameResult Result)
+		{
+			Results.Add(SaveGame, Result);
+		});
+
+		UFlowSaveGame* SupersededSaveGame = NewObject<UFlowSaveGame>();
+		SupersededSaveGame->SaveSlotName = SlotName;
+		FlowSubsystem->SaveGameAsync(SupersededSaveGame, 0, OnCompleted);
+
+		UFlowSaveGame* SaveGame = NewObject<UFlowSaveGame>();
+		SaveGame->SaveSlotName = SlotName;
+		FlowSubsystem->SaveGameAsync(SaveGame, 0, OnCompleted);
+
+		// other SaveGame object for the same slot doesn't replace the object of the pending request silently
+		TestTrue(*FString::Printf(TEXT("Superseded request is completed %s"), *Context), Results.Contains(SupersededSaveGame) && Results[SupersededSaveGame] == EFlowSaveGameResult::Superseded);
+		TestEqual(*FString::Printf(TEXT("Records of the superseded SaveGame %s"), *Context), SupersededSaveGame->FlowInstances.Num(), 0);
+		TestTrue(*FString::Printf(TEXT("Pending SaveGame is the latest one %s"), *Context), FlowSubsystem->GetPendingSaveGame(SlotName, 0) == SaveGame);
+
+		FlowSubsystem->FlushSaveGameWrites();
+		TestTrue(*FString::Printf(TEXT("Written request is saved %s"), *Context), Results.Contains(SaveGame) && Results[SaveGame] == EFlowSaveGameResult::Saved);
+
+		// compressed save is read by the regular engine function
+		const UFlowSaveGame* LoadedSaveGame = Cast<UFlowSaveGame>(UGameplayStatics::LoadGameFromSlot(SlotName, 0));
+		if (TestNotNull(*FString::Printf(TEXT("SaveGame loaded from the slot %s"), *Context), LoadedSaveGame))
+		{
+			TestEqual(*FString::Printf(TEXT("Loaded instances %s"), *Context), LoadedSaveGame->FlowInstances.Num(), SaveGame->FlowInstances.Num());
+			TestEqual(*FString::Printf(TEXT("Loaded slot name %s"), *Context), LoadedSaveGame->SaveSlotName, SlotName);
+			TestFalse(*FString::Printf(TEXT("Loaded SaveGame waits for decompression %s"), *Context), LoadedSaveGame->bHasCompressedData);
+		}
+
+		UGameplayStatics::DeleteGameInSlot(SlotName, 0);
+	}
+
+	return true;
+}
+
+#endif
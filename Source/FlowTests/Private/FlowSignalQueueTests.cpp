@@ -0,0 +1,243 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTestGraphBuilder.h"
+#include "FlowTestNodes.h"
+#include "FlowTestWorld.h"
+
+#include "FlowAsset.h"
+#include "FlowSettings.h"
+#include "FlowSubsystem.h"
+#include "Nodes/Graph/FlowNode_CustomInput.h"
+
+#include "Containers/Ticker.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FlowSignalQueueTests
+{
+	struct FSettingsGuard
+	{
+		explicit FSettingsGuard(const bool bUseSignalQueue, const int32 MaxSignalsPerFrame = 0, const int32 MaxSignalsBeforeLoopGuard = 1000000)
+			: UseSignalQueue(UFlowSettings::Get()->bUseSignalQueue, bUseSignalQueue)
+			, SignalsPerFrame(UFlowSettings::Get()->MaxSignalsPerFrame, MaxSignalsPerFrame)
+			, SignalsBeforeLoopGuard(UFlowSettings::Get()->MaxSignalsBeforeLoopGuard, MaxSignalsBeforeLoopGuard)
+		{
+		}
+
+		TGuardValue<bool> UseSignalQueue;
+		TGuardValue<int32> SignalsPerFrame;
+		TGuardValue<int32> SignalsBeforeLoopGuard;
+	};
+
+	TArray<int32> RunAndLog(const FFlowTestWorld& TestWorld, UFlowAsset* FlowAsset, const bool bUseSignalQueue)
+	{
+		const FSettingsGuard SettingsGuard(bUseSignalQueue);
+
+		UFlowNode_TestPassThrough::ResetLog();
+		TestWorld.GetFlowSubsystem()->StartRootFlow(TestWorld.SpawnActor(), FlowAsset);
+
+		return UFlowNode_TestPassThrough::ExecutionLog;
+	}
+
+	TArray<int32> MakeSequence(const int32 Num)
+	{
+		TArray<int32> Sequence;
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Sequence.Add(Index);
+		}
+		return Sequence;
+	}
+
+	// Executes signals deferred by the frame budget, as they would be executed on the next engine frame
+	void AdvanceFrame()
+	{
+		GFrameCounter++;
+		FTSTicker::GetCoreTicker().Tick(0.0f);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowSignalQueueLinearChainTest, "Flow.SignalQueue.LinearChainOrder", FLOW_TEST_FLAGS)
+
+bool FFlowSignalQueueLinearChainTest::RunTest(const FString& Parameters)
+{
+	const FFlowTestWorld TestWorld;
+	UFlowAsset* FlowAsset = FFlowTestGraphBuilder::BuildLinearChain(16);
+
+	const TArray<int32> ExpectedLog = FlowSignalQueueTests::MakeSequence(16);
+	TestEqual(TEXT("Executed nodes without the signal queue"), FlowSignalQueueTests::RunAndLog(TestWorld, FlowAsset, false), ExpectedLog);
+	TestEqual(TEXT("Executed nodes with the signal queue"), FlowSignalQueueTests::RunAndLog(TestWorld, FlowAsset, true), ExpectedLog);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowSignalQueueFanOutTest, "Flow.SignalQueue.FanOutDepthFirst", FLOW_TEST_FLAGS)
+
+bool FFlowSignalQueueFanOutTest::RunTest(const FString& Parameters)
+{
+	const FFlowTestWorld TestWorld;
+	UFlowAsset* FlowAsset = FFlowTestGraphBuilder::BuildFanOut(3, 3);
+
+	// every branch is finished before the next output of Fan Out is followed
+	const TArray<int32> ExpectedLog = FlowSignalQueueTests::MakeSequence(9);
+	TestEqual(TEXT("Executed nodes without the signal queue"), FlowSignalQueueTests::RunAndLog(TestWorld, FlowAsset, false), ExpectedLog);
+	TestEqual(TEXT("Executed nodes with the signal queue"), FlowSignalQueueTests::RunAndLog(TestWorld, FlowAsset, true), ExpectedLog);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowSignalQueueSubGraphTest, "Flow.SignalQueue.NestedSubGraphs", FLOW_TEST_FLAGS)
+
+bool FFlowSignalQueueSubGraphTest::RunTest(const FString& Parameters)
+{
+	const FFlowTestWorld TestWorld;
+	UFlowAsset* FlowAsset = FFlowTestGraphBuilder::BuildNestedSubGraphs(4);
+
+	const TArray<int32> ExpectedLog = {0, 1, 2, 3, 102, 101, 100};
+	TestEqual(TEXT("Executed nodes without the signal queue"), FlowSignalQueueTests::RunAndLog(TestWorld, FlowAsset, false), ExpectedLog);
+	TestEqual(TEXT("Executed nodes with the signal queue"), FlowSignalQueueTests::RunAndLog(TestWorld, FlowAsset, true), ExpectedLog);
+
+	TestEqual(TEXT("Sub-flows left after reaching their Finish nodes"), TestWorld.GetFlowSubsystem()->GetInstancedSubFlows().Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowSignalQueueDeepChainTest, "Flow.SignalQueue.DeepChain", FLOW_TEST_FLAGS)
+
+bool FFlowSignalQueueDeepChainTest::RunTest(const FString& Parameters)
+{
+	// without the queue, a chain this long would need a call stack deeper than the engine allows
+	constexpr int32 NodesNum = 10000;
+
+	const FFlowTestWorld TestWorld;
+	UFlowAsset* FlowAsset = FFlowTestGraphBuilder::BuildLinearChain(NodesNum);
+
+	const FlowSignalQueueTests::FSettingsGuard SettingsGuard(true);
+	UFlowNode_TestPassThrough::ResetLog();
+	TestWorld.GetFlowSubsystem()->StartRootFlow(TestWorld.SpawnActor(), FlowAsset);
+
+	TestEqual(TEXT("Executed nodes"), UFlowNode_TestPassThrough::ExecutionsNum, NodesNum);
+	TestEqual(TEXT("Last executed node"), UFlowNode_TestPassThrough::ExecutionLog.Num() > 0 ? UFlowNode_TestPassThrough::ExecutionLog.Last() : INDEX_NONE, NodesNum - 1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowSignalQueueLoopGuardTest, "Flow.SignalQueue.LoopGuard", FLOW_TEST_FLAGS)
+
+bool FFlowSignalQueueLoopGuardTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 MaxSignalsBeforeLoopGuard = 1000;
+
+	const FFlowTestWorld TestWorld;
+
+	// two nodes triggering each other forever
+	FFlowTestGraphBuilder Builder(TEXT("FlowTest_Loop"));
+	UFlowNode* FirstNode = Builder.AddNode<UFlowNode_TestPassThrough>();
+	UFlowNode* SecondNode = Builder.AddNode<UFlowNode_TestPassThrough>();
+	Builder.Connect(Builder.GetStartNode(), UFlowNode::DefaultOutputPin.PinName, FirstNode);
+	Builder.Connect(FirstNode, UFlowNode::DefaultOutputPin.PinName, SecondNode);
+	Builder.Connect(SecondNode, UFlowNode::DefaultOutputPin.PinName, FirstNode);
+	UFlowAsset* FlowAsset = Builder.Finish();
+
+	AddExpectedError(TEXT("infinite loop"), EAutomationExpectedErrorFlags::Contains, 1);
+
+	const FlowSignalQueueTests::FSettingsGuard SettingsGuard(true, 0, MaxSignalsBeforeLoopGuard);
+	UFlowNode_TestPassThrough::ResetLog();
+	TestWorld.GetFlowSubsystem()->StartRootFlow(TestWorld.SpawnActor(), FlowAsset);
+
+	TestEqual(TEXT("Executed nodes"), UFlowNode_TestPassThrough::ExecutionsNum, MaxSignalsBeforeLoopGuard);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowSignalQueueFrameBudgetTest, "Flow.SignalQueue.FrameBudget", FLOW_TEST_FLAGS)
+
+bool FFlowSignalQueueFrameBudgetTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 MaxSignalsPerFrame = 5;
+
+	const FFlowTestWorld TestWorld;
+	UFlowAsset* FlowAsset = FFlowTestGraphBuilder::BuildLinearChain(20);
+	AActor* Owner = TestWorld.SpawnActor();
+
+	const FlowSignalQueueTests::FSettingsGuard SettingsGuard(true, MaxSignalsPerFrame);
+	UFlowNode_TestPassThrough::ResetLog();
+	TestWorld.GetFlowSubsystem()->StartRootFlow(Owner, FlowAsset);
+
+	TestEqual(TEXT("Nodes executed in the first frame"), UFlowNode_TestPassThrough::ExecutionLog, FlowSignalQueueTests::MakeSequence(MaxSignalsPerFrame));
+
+	// signals deferred to the next frame are discarded with the finished instance
+	TestWorld.GetFlowSubsystem()->FinishRootFlow(Owner, FlowAsset, EFlowFinishPolicy::Keep);
+	TestEqual(TEXT("Nodes executed after finishing the flow"), UFlowNode_TestPassThrough::ExecutionsNum, MaxSignalsPerFrame);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowSignalQueueDeferredDrainTest, "Flow.SignalQueue.DeferredDrain", FLOW_TEST_FLAGS)
+
+bool FFlowSignalQueueDeferredDrainTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NodesNum = 20;
+	constexpr int32 MaxSignalsPerFrame = 5;
+	static const FName RestartEventName = TEXT("Restart");
+
+	const FFlowTestWorld TestWorld;
+
+	// Start -> chain of N nodes, Custom Input restarting the chain
+	FFlowTestGraphBuilder Builder(TEXT("FlowTest_DeferredDrain"));
+	UFlowNode* PreviousNode = Builder.GetStartNode();
+	UFlowNode* FirstNode = nullptr;
+	for (int32 Index = 0; Index < NodesNum; Index++)
+	{
+		UFlowNode_TestPassThrough* Node = Builder.AddNode<UFlowNode_TestPassThrough>();
+		Node->LogId = Index;
+
+		Builder.Connect(PreviousNode, UFlowNode::DefaultOutputPin.PinName, Node);
+		PreviousNode = Node;
+
+		if (Index == 0)
+		{
+			FirstNode = Node;
+		}
+	}
+	UFlowNode_CustomInput* RestartNode = Builder.AddNode<UFlowNode_CustomInput>();
+	RestartNode->SetEventName(RestartEventName);
+	Builder.Connect(RestartNode, UFlowNode::DefaultOutputPin.PinName, FirstNode);
+	UFlowAsset* FlowAsset = Builder.Finish();
+
+	// loop guard lower than the total number of signals, but higher than the frame budget
+	const FlowSignalQueueTests::FSettingsGuard SettingsGuard(true, MaxSignalsPerFrame, MaxSignalsPerFrame + 3);
+	UFlowNode_TestPassThrough::ResetLog();
+
+	AActor* Owner = TestWorld.SpawnActor();
+	TestWorld.GetFlowSubsystem()->StartRootFlow(Owner, FlowAsset);
+	UFlowAsset* FlowInstance = TestWorld.GetFlowSubsystem()->GetRootInstances().FindRef(Owner);
+	if (!TestNotNull(TEXT("Flow instance"), FlowInstance))
+	{
+		return false;
+	}
+
+	// external trigger is executed after signals already deferred to the next frame
+	FlowInstance->TriggerCustomInput(RestartEventName);
+	TestEqual(TEXT("Nodes executed in the first frame"), UFlowNode_TestPassThrough::ExecutionLog, FlowSignalQueueTests::MakeSequence(MaxSignalsPerFrame));
+
+	FlowSignalQueueTests::AdvanceFrame();
+	TArray<int32> ExpectedLog = FlowSignalQueueTests::MakeSequence(MaxSignalsPerFrame * 2);
+	TestEqual(TEXT("Nodes executed in the second frame"), UFlowNode_TestPassThrough::ExecutionLog, ExpectedLog);
+
+	for (int32 FrameIndex = 0; FrameIndex < NodesNum * 2 / MaxSignalsPerFrame; FrameIndex++)
+	{
+		FlowSignalQueueTests::AdvanceFrame();
+	}
+
+	// both runs of the chain were finished, without tripping the loop guard
+	ExpectedLog = FlowSignalQueueTests::MakeSequence(NodesNum);
+	ExpectedLog.Append(FlowSignalQueueTests::MakeSequence(NodesNum));
+	TestEqual(TEXT("Nodes executed in all frames"), UFlowNode_TestPassThrough::ExecutionLog, ExpectedLog);
+
+	TestWorld.GetFlowSubsystem()->FinishRootFlow(Owner, FlowAsset, EFlowFinishPolicy::Keep);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,196 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTestGraphBuilder.h"
+#include "FlowTestNodes.h"
+
+#include "FlowAsset.h"
+#include "Nodes/Graph/FlowNode_Finish.h"
+#include "Nodes/Graph/FlowNode_Start.h"
+#include "Nodes/Graph/FlowNode_SubGraph.h"
+
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+namespace FlowTestGraphBuilder
+{
+	// Properties written by the editor graph aren't exposed to the runtime code, so tests write them through reflection
+	template <typename T>
+	T& GetPropertyValue(UObject* Object, const FName& PropertyName)
+	{
+		const FProperty* Property = FindFieldChecked<FProperty>(Object->GetClass(), PropertyName);
+		return *Property->ContainerPtrToValuePtr<T>(Object);
+	}
+}
+
+FFlowTestGraphBuilder::FFlowTestGraphBuilder(const FString& AssetName)
+{
+	UPackage* Package = GetTransientPackage();
+	Asset = NewObject<UFlowAsset>(Package, MakeUniqueObjectName(Package, UFlowAsset::StaticClass(), *AssetName), RF_Transient);
+	StartNode = AddNode<UFlowNode_Start>();
+}
+
+UFlowNode* FFlowTestGraphBuilder::AddNode(const TSubclassOf<UFlowNode> NodeClass)
+{
+	UFlowNode* NewNode = NewObject<UFlowNode>(Asset, NodeClass, NAME_None, RF_Transient);
+	NewNode->SetGuid(FGuid::NewGuid());
+	FlowTestGraphBuilder::GetPropertyValue<TMap<FGuid, TObjectPtr<UFlowNode>>>(Asset, TEXT("Nodes")).Emplace(NewNode->GetGuid(), NewNode);
+
+	return NewNode;
+}
+
+void FFlowTestGraphBuilder::Connect(UFlowNode* FromNode, const FName& OutputPinName, UFlowNode* ToNode, const FName& InputPinName)
+{
+	const FName ToPinName = InputPinName.IsNone() ? ToNode->GetInputPins()[0].PinName : InputPinName;
+	Connections.FindOrAdd(FromNode).Add(OutputPinName, FConnectedPin(ToNode->GetGuid(), ToPinName));
+}
+
+void FFlowTestGraphBuilder::ConnectDataPin(UFlowNode* SupplierNode, const FName& OutputPinName, UFlowNode* ConsumerNode, const FName& InputPinName)
+{
+	// data pins are connected from the consumer side
+	Connections.FindOrAdd(ConsumerNode).Add(InputPinName, FConnectedPin(SupplierNode->GetGuid(), OutputPinName));
+}
+
+void FFlowTestGraphBuilder::SetSubGraphAsset(UFlowNode_SubGraph* SubGraphNode, UFlowAsset* SubGraphAsset)
+{
+	FlowTestGraphBuilder::GetPropertyValue<TSoftObjectPtr<UFlowAsset>>(SubGraphNode, TEXT("Asset")) = SubGraphAsset;
+}
+
+UFlowAsset* FFlowTestGraphBuilder::Finish()
+{
+	for (const TPair<UFlowNode*, TMap<FName, FConnectedPin>>& NodeConnections : Connections)
+	{
+		NodeConnections.Key->SetConnections(NodeConnections.Value);
+	}
+
+	Asset->CompileGraph();
+	return Asset;
+}
+
+UFlowAsset* FFlowTestGraphBuilder::BuildLinearChain(const int32 NodesNum)
+{
+	FFlowTestGraphBuilder Builder(TEXT("FlowTest_LinearChain"));
+
+	UFlowNode* PreviousNode = Builder.GetStartNode();
+	for (int32 Index = 0; Index < NodesNum; Index++)
+	{
+		UFlowNode_TestPassThrough* Node = Builder.AddNode<UFlowNode_TestPassThrough>();
+		Node->LogId = Index;
+
+		Builder.Connect(PreviousNode, UFlowNode::DefaultOutputPin.PinName, Node);
+		PreviousNode = Node;
+	}
+
+	return Builder.Finish();
+}
+
+UFlowAsset* FFlowTestGraphBuilder::BuildFanOut(const int32 BranchesNum, const int32 ChainLength)
+{
+	FFlowTestGraphBuilder Builder(TEXT("FlowTest_FanOut"));
+
+	UFlowNode_TestFanOut* FanOut = Builder.AddNode<UFlowNode_TestFanOut>();
+	FanOut->SetOutputsNum(BranchesNum);
+	Builder.Connect(Builder.GetStartNode(), UFlowNode::DefaultOutputPin.PinName, FanOut);
+
+	for (int32 BranchIndex = 0; BranchIndex < BranchesNum; BranchIndex++)
+	{
+		UFlowNode* PreviousNode = FanOut;
+		FName PreviousPinName = FanOut->GetOutputPins()[BranchIndex].PinName;
+
+		for (int32 Index = 0; Index < ChainLength; Index++)
+		{
+			UFlowNode_TestPassThrough* Node = Builder.AddNode<UFlowNode_TestPassThrough>();
+			Node->LogId = BranchIndex * ChainLength + Index;
+
+			Builder.Connect(PreviousNode, PreviousPinName, Node);
+			PreviousNode = Node;
+			PreviousPinName = UFlowNode::DefaultOutputPin.PinName;
+		}
+	}
+
+	return Builder.Finish();
+}
+
+UFlowAsset* FFlowTestGraphBuilder::BuildNestedSubGraphs(const int32 Depth)
+{
+	// build from the deepest level, every level references the one below
+	UFlowAsset* SubGraphAsset = nullptr;
+	for (int32 Level = Depth - 1; Level >= 0; Level--)
+	{
+		FFlowTestGraphBuilder Builder(FString::Printf(TEXT("FlowTest_SubGraphLevel%d"), Level));
+
+		UFlowNode_TestPassThrough* EnterNode = Builder.AddNode<UFlowNode_TestPassThrough>();
+		EnterNode->LogId = Level;
+		Builder.Connect(Builder.GetStartNode(), UFlowNode::DefaultOutputPin.PinName, EnterNode);
+
+		UFlowNode* LastNode = EnterNode;
+		if (SubGraphAsset)
+		{
+			UFlowNode_SubGraph* SubGraphNode = Builder.AddNode<UFlowNode_SubGraph>();
+			Builder.SetSubGraphAsset(SubGraphNode, SubGraphAsset);
+			Builder.Connect(EnterNode, UFlowNode::DefaultOutputPin.PinName, SubGraphNode);
+
+			UFlowNode_TestPassThrough* ExitNode = Builder.AddNode<UFlowNode_TestPassThrough>();
+			ExitNode->LogId = 100 + Level;
+			Builder.Connect(SubGraphNode, UFlowNode_SubGraph::FinishPin.PinName, ExitNode);
+
+			LastNode = ExitNode;
+		}
+
+		// the root level doesn't finish, so the test can inspect its instance
+		if (Level > 0)
+		{
+			UFlowNode_Finish* FinishNode = Builder.AddNode<UFlowNode_Finish>();
+			Builder.Connect(LastNode, UFlowNode::DefaultOutputPin.PinName, FinishNode);
+		}
+
+		SubGraphAsset = Builder.Finish();
+	}
+
+	return SubGraphAsset;
+}
+
+UFlowAsset* FFlowTestGraphBuilder::BuildDataPinGraph(const int32 ConsumersNum)
+{
+	FFlowTestGraphBuilder Builder(TEXT("FlowTest_DataPins"));
+
+	UFlowNode_TestDataSupplier* Supplier = Builder.AddNode<UFlowNode_TestDataSupplier>();
+	Supplier->IntValue = 42;
+	Supplier->FloatValue = 0.5f;
+	Supplier->bBoolValue = true;
+	Supplier->NameValue = TEXT("FlowTest");
+
+	UFlowNode* PreviousNode = Builder.GetStartNode();
+	for (int32 Index = 0; Index < ConsumersNum; Index++)
+	{
+		UFlowNode_TestDataConsumer* Consumer = Builder.AddNode<UFlowNode_TestDataConsumer>();
+		Builder.Connect(PreviousNode, UFlowNode::DefaultOutputPin.PinName, Consumer);
+
+		Builder.ConnectDataPin(Supplier, UFlowNode_TestDataSupplier::OUTPIN_Int, Consumer, UFlowNode_TestDataConsumer::INPIN_Int);
+		Builder.ConnectDataPin(Supplier, UFlowNode_TestDataSupplier::OUTPIN_Float, Consumer, UFlowNode_TestDataConsumer::INPIN_Float);
+		Builder.ConnectDataPin(Supplier, UFlowNode_TestDataSupplier::OUTPIN_Bool, Consumer, UFlowNode_TestDataConsumer::INPIN_Bool);
+		Builder.ConnectDataPin(Supplier, UFlowNode_TestDataSupplier::OUTPIN_Name, Consumer, UFlowNode_TestDataConsumer::INPIN_Name);
+
+		PreviousNode = Consumer;
+	}
+
+	return Builder.Finish();
+}
+
+UFlowAsset* FFlowTestGraphBuilder::BuildLatentGraph(const int32 LatentNodesNum)
+{
+	FFlowTestGraphBuilder Builder(TEXT("FlowTest_Latent"));
+
+	UFlowNode_TestFanOut* FanOut = Builder.AddNode<UFlowNode_TestFanOut>();
+	FanOut->SetOutputsNum(LatentNodesNum);
+	Builder.Connect(Builder.GetStartNode(), UFlowNode::DefaultOutputPin.PinName, FanOut);
+
+	for (int32 Index = 0; Index < LatentNodesNum; Index++)
+	{
+		UFlowNode_TestLatent* LatentNode = Builder.AddNode<UFlowNode_TestLatent>();
+		LatentNode->ValueToSave = Index + 1;
+
+		Builder.Connect(FanOut, FanOut->GetOutputPins()[Index].PinName, LatentNode);
+	}
+
+	return Builder.Finish();
+}
@@ -0,0 +1,63 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Nodes/FlowPin.h"
+#include "Templates/SubclassOf.h"
+
+class UFlowAsset;
+class UFlowNode;
+class UFlowNode_SubGraph;
+
+/**
+ * Builds transient Flow Assets in code, without the editor graph
+ * Connections are written directly to nodes, the same way HarvestNodeConnections writes them for assets created in the editor
+ */
+class FFlowTestGraphBuilder
+{
+public:
+	explicit FFlowTestGraphBuilder(const FString& AssetName);
+
+	UFlowAsset* GetAsset() const { return Asset; }
+	UFlowNode* GetStartNode() const { return StartNode; }
+
+	UFlowNode* AddNode(const TSubclassOf<UFlowNode> NodeClass);
+
+	template <class T>
+	T* AddNode()
+	{
+		return CastChecked<T>(AddNode(T::StaticClass()));
+	}
+
+	// Connects output pin to the input pin of other node, input pin defaults to the first input pin
+	void Connect(UFlowNode* FromNode, const FName& OutputPinName, UFlowNode* ToNode, const FName& InputPinName = NAME_None);
+
+	// Connects input data pin to the output data pin of the supplier node
+	void ConnectDataPin(UFlowNode* SupplierNode, const FName& OutputPinName, UFlowNode* ConsumerNode, const FName& InputPinName);
+
+	void SetSubGraphAsset(UFlowNode_SubGraph* SubGraphNode, UFlowAsset* SubGraphAsset);
+
+	// Applies collected connections and compiles the graph
+	UFlowAsset* Finish();
+
+	// Start -> N nodes, each triggering the next one
+	static UFlowAsset* BuildLinearChain(const int32 NodesNum);
+
+	// Start -> Fan Out with N outputs -> chain of ChainLength nodes connected to every output
+	static UFlowAsset* BuildFanOut(const int32 BranchesNum, const int32 ChainLength);
+
+	// Every level executes the node logging its level, then Sub Graph of the next level, then node logging 100 + its level
+	static UFlowAsset* BuildNestedSubGraphs(const int32 Depth);
+
+	// Start -> chain of N consumers, all data pins of every consumer connected to a single supplier
+	static UFlowAsset* BuildDataPinGraph(const int32 ConsumersNum);
+
+	// Start -> Fan Out -> N latent nodes, ValueToSave of every node is its index + 1
+	static UFlowAsset* BuildLatentGraph(const int32 LatentNodesNum);
+
+private:
+	UFlowAsset* Asset;
+	UFlowNode* StartNode;
+
+	TMap<UFlowNode*, TMap<FName, FConnectedPin>> Connections;
+};
@@ -0,0 +1,137 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTestNodes.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FlowTestNodes)
+
+TArray<int32> UFlowNode_TestPassThrough::ExecutionLog;
+int32 UFlowNode_TestPassThrough::ExecutionsNum = 0;
+
+UFlowNode_TestPassThrough::UFlowNode_TestPassThrough(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, LogId(INDEX_NONE)
+{
+}
+
+void UFlowNode_TestPassThrough::ResetLog()
+{
+	ExecutionLog.Reset();
+	ExecutionsNum = 0;
+}
+
+void UFlowNode_TestPassThrough::ExecuteInput(const FName& PinName)
+{
+	ExecutionsNum++;
+	if (LogId != INDEX_NONE)
+	{
+		ExecutionLog.Add(LogId);
+	}
+
+	TriggerFirstOutput(true);
+}
+
+UFlowNode_TestFanOut::UFlowNode_TestFanOut(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	SetOutputsNum(2);
+}
+
+void UFlowNode_TestFanOut::SetOutputsNum(const int32 OutputsNum)
+{
+	OutputPins.Reset(OutputsNum);
+	for (int32 Index = 0; Index < OutputsNum; Index++)
+	{
+		OutputPins.Add(FFlowPin(Index));
+	}
+}
+
+void UFlowNode_TestFanOut::ExecuteInput(const FName& PinName)
+{
+	for (const FFlowPin& OutputPin : OutputPins)
+	{
+		TriggerOutput(OutputPin.PinName);
+	}
+
+	Finish();
+}
+
+FName UFlowNode_TestDataSupplier::OUTPIN_Int(TEXT("IntOut"));
+FName UFlowNode_TestDataSupplier::OUTPIN_Float(TEXT("FloatOut"));
+FName UFlowNode_TestDataSupplier::OUTPIN_Bool(TEXT("BoolOut"));
+FName UFlowNode_TestDataSupplier::OUTPIN_Name(TEXT("NameOut"));
+
+UFlowNode_TestDataSupplier::UFlowNode_TestDataSupplier(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, IntValue(0)
+	, FloatValue(0.0f)
+	, bBoolValue(false)
+{
+	// never executed, values are pulled by connected nodes
+	InputPins.Empty();
+	OutputPins.Empty();
+
+	PinNameToBoundPropertyNameMap.Add(OUTPIN_Int, GET_MEMBER_NAME_CHECKED(UFlowNode_TestDataSupplier, IntValue));
+	PinNameToBoundPropertyNameMap.Add(OUTPIN_Float, GET_MEMBER_NAME_CHECKED(UFlowNode_TestDataSupplier, FloatValue));
+	PinNameToBoundPropertyNameMap.Add(OUTPIN_Bool, GET_MEMBER_NAME_CHECKED(UFlowNode_TestDataSupplier, bBoolValue));
+	PinNameToBoundPropertyNameMap.Add(OUTPIN_Name, GET_MEMBER_NAME_CHECKED(UFlowNode_TestDataSupplier, NameValue));
+}
+
+FName UFlowNode_TestDataConsumer::INPIN_Int(TEXT("IntIn"));
+FName UFlowNode_TestDataConsumer::INPIN_Float(TEXT("FloatIn"));
+FName UFlowNode_TestDataConsumer::INPIN_Bool(TEXT("BoolIn"));
+FName UFlowNode_TestDataConsumer::INPIN_Name(TEXT("NameIn"));
+
+UFlowNode_TestDataConsumer::UFlowNode_TestDataConsumer(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, ResolvedInt(0)
+	, ResolvedFloat(0.0)
+	, bResolvedBool(false)
+	, FailedResolvesNum(0)
+{
+	InputPins.Add(FFlowPin(INPIN_Int, EFlowPinType::Int));
+	InputPins.Add(FFlowPin(INPIN_Float, EFlowPinType::Float));
+	InputPins.Add(FFlowPin(INPIN_Bool, EFlowPinType::Bool));
+	InputPins.Add(FFlowPin(INPIN_Name, EFlowPinType::Name));
+}
+
+void UFlowNode_TestDataConsumer::ExecuteInput(const FName& PinName)
+{
+	FailedResolvesNum = 0;
+
+	const FFlowDataPinResult_Int IntResult = TryResolveDataPinAsInt(INPIN_Int);
+	ResolvedInt = IntResult.Value;
+	FailedResolvesNum += IntResult.Result == EFlowDataPinResolveResult::Success ? 0 : 1;
+
+	const FFlowDataPinResult_Float FloatResult = TryResolveDataPinAsFloat(INPIN_Float);
+	ResolvedFloat = FloatResult.Value;
+	FailedResolvesNum += FloatResult.Result == EFlowDataPinResolveResult::Success ? 0 : 1;
+
+	const FFlowDataPinResult_Bool BoolResult = TryResolveDataPinAsBool(INPIN_Bool);
+	bResolvedBool = BoolResult.Value;
+	FailedResolvesNum += BoolResult.Result == EFlowDataPinResolveResult::Success ? 0 : 1;
+
+	const FFlowDataPinResult_Name NameResult = TryResolveDataPinAsName(INPIN_Name);
+	ResolvedName = NameResult.Value;
+	FailedResolvesNum += NameResult.Result == EFlowDataPinResolveResult::Success ? 0 : 1;
+
+	TriggerFirstOutput(true);
+}
+
+UFlowNode_TestLatent::UFlowNode_TestLatent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, ValueToSave(0)
+	, SavedValue(0)
+{
+	SaveRecordReusableClass = StaticClass();
+}
+
+void UFlowNode_TestLatent::Complete()
+{
+	TriggerFirstOutput(true);
+}
+
+void UFlowNode_TestLatent::ExecuteInput(const FName& PinName)
+{
+	SavedValue = ValueToSave;
+	MarkSaveDirty();
+}
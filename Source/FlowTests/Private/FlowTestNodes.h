@@ -0,0 +1,133 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "FlowComponent.h"
+#include "Nodes/FlowNode.h"
+#include "FlowTestNodes.generated.h"
+
+/**
+ * Nodes used by synthetic graphs of automation tests and benchmarks
+ * Marked as NotPlaceable, so they don't appear in the Flow Graph palette
+ */
+
+/**
+ * Triggers its output instantly
+ */
+UCLASS(NotBlueprintable, NotPlaceable, meta = (DisplayName = "Test Pass Through"))
+class UFlowNode_TestPassThrough : public UFlowNode
+{
+	GENERATED_UCLASS_BODY()
+
+	// Added to ExecutionLog on every execution, unless it's INDEX_NONE
+	UPROPERTY()
+	int32 LogId;
+
+	// Shared by all nodes, tests reset it before starting the graph
+	static TArray<int32> ExecutionLog;
+	static int32 ExecutionsNum;
+
+	static void ResetLog();
+
+protected:
+	virtual void ExecuteInput(const FName& PinName) override;
+};
+
+/**
+ * Triggers all of its outputs in order
+ */
+UCLASS(NotBlueprintable, NotPlaceable, meta = (DisplayName = "Test Fan Out"))
+class UFlowNode_TestFanOut : public UFlowNode
+{
+	GENERATED_UCLASS_BODY()
+
+	void SetOutputsNum(const int32 OutputsNum);
+
+protected:
+	virtual void ExecuteInput(const FName& PinName) override;
+};
+
+/**
+ * Supplies values of its properties through output data pins
+ */
+UCLASS(NotBlueprintable, NotPlaceable, meta = (DisplayName = "Test Data Supplier"))
+class UFlowNode_TestDataSupplier : public UFlowNode
+{
+	GENERATED_UCLASS_BODY()
+
+	UPROPERTY()
+	int32 IntValue;
+
+	UPROPERTY()
+	float FloatValue;
+
+	UPROPERTY()
+	bool bBoolValue;
+
+	UPROPERTY()
+	FName NameValue;
+
+	static FName OUTPIN_Int;
+	static FName OUTPIN_Float;
+	static FName OUTPIN_Bool;
+	static FName OUTPIN_Name;
+};
+
+/**
+ * Resolves all of its input data pins on execution
+ */
+UCLASS(NotBlueprintable, NotPlaceable, meta = (DisplayName = "Test Data Consumer"))
+class UFlowNode_TestDataConsumer : public UFlowNode
+{
+	GENERATED_UCLASS_BODY()
+
+	int64 ResolvedInt;
+	double ResolvedFloat;
+	bool bResolvedBool;
+	FName ResolvedName;
+
+	// Number of data pins that failed to resolve during the last execution
+	int32 FailedResolvesNum;
+
+	static FName INPIN_Int;
+	static FName INPIN_Float;
+	static FName INPIN_Bool;
+	static FName INPIN_Name;
+
+protected:
+	virtual void ExecuteInput(const FName& PinName) override;
+};
+
+/**
+ * Stays active until Complete() is called, keeps the value written on activation in the SaveGame
+ */
+UCLASS(NotBlueprintable, NotPlaceable, meta = (DisplayName = "Test Latent"))
+class UFlowNode_TestLatent : public UFlowNode
+{
+	GENERATED_UCLASS_BODY()
+
+	// Copied to SavedValue on activation
+	UPROPERTY()
+	int32 ValueToSave;
+
+	UPROPERTY(SaveGame)
+	int32 SavedValue;
+
+	void Complete();
+
+protected:
+	virtual void ExecuteInput(const FName& PinName) override;
+};
+
+/**
+ * Flow Component registered in the subsystem without Begin Play
+ */
+UCLASS(NotBlueprintable, NotPlaceable)
+class UFlowTestComponent : public UFlowComponent
+{
+	GENERATED_BODY()
+
+public:
+	void Register() { RegisterWithFlowSubsystem(); }
+	void Unregister() { UnregisterWithFlowSubsystem(); }
+};
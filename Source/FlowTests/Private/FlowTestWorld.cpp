@@ -0,0 +1,43 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTestWorld.h"
+#include "FlowSubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "UObject/Package.h"
+
+FFlowTestWorld::FFlowTestWorld()
+{
+	GameInstance = NewObject<UGameInstance>(GEngine);
+	GameInstance->AddToRoot();
+	GameInstance->InitializeStandalone(MakeUniqueObjectName(GetTransientPackage(), UWorld::StaticClass(), TEXT("FlowTestWorld")));
+
+	FlowSubsystem = GameInstance->GetSubsystem<UFlowSubsystem>();
+}
+
+FFlowTestWorld::~FFlowTestWorld()
+{
+	UWorld* World = GameInstance->GetWorld();
+	GameInstance->Shutdown();
+
+	if (World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	GameInstance->RemoveFromRoot();
+}
+
+UWorld* FFlowTestWorld::GetWorld() const
+{
+	return GameInstance->GetWorld();
+}
+
+AActor* FFlowTestWorld::SpawnActor() const
+{
+	return GetWorld()->SpawnActor<AActor>();
+}
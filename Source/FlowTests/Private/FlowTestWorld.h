@@ -0,0 +1,42 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Misc/AutomationTest.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+class AActor;
+class UFlowSubsystem;
+class UGameInstance;
+class UWorld;
+
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION < 5
+#define FLOW_TEST_CONTEXT_MASK EAutomationTestFlags::ApplicationContextMask
+#else
+#define FLOW_TEST_CONTEXT_MASK EAutomationTestFlags_ApplicationContextMask
+#endif
+
+// Flow tests don't need any content or rendering, they run in every application context, including -nullrhi commandlets
+#define FLOW_TEST_FLAGS (FLOW_TEST_CONTEXT_MASK | EAutomationTestFlags::ProductFilter)
+#define FLOW_BENCHMARK_FLAGS (FLOW_TEST_CONTEXT_MASK | EAutomationTestFlags::PerfFilter)
+
+/**
+ * Game Instance with a game world created for the lifetime of the test
+ * Flow Subsystem treats it as a regular game, so assets built in code aren't harvested for editor graph connections
+ */
+class FFlowTestWorld
+{
+public:
+	FFlowTestWorld();
+	~FFlowTestWorld();
+
+	UWorld* GetWorld() const;
+	UFlowSubsystem* GetFlowSubsystem() const { return FlowSubsystem; }
+
+	// Creates actor owning Flow Components or Root Flows of the test
+	AActor* SpawnActor() const;
+
+private:
+	UGameInstance* GameInstance;
+	UFlowSubsystem* FlowSubsystem;
+};
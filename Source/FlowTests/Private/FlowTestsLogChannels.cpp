@@ -0,0 +1,3 @@
+#include "FlowTestsLogChannels.h"
+
+DEFINE_LOG_CATEGORY(LogFlowTests);
@@ -0,0 +1,167 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "FlowTestWorld.h"
+
+#include "FlowTimerWheel.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FlowTimerWheelTests
+{
+	FFlowTimerDelegate MakeLogger(TArray<int32>& Log, const int32 Id)
+	{
+		return FFlowTimerDelegate::CreateLambda([&Log, Id]()
+		{
+			Log.Add(Id);
+		});
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowTimerWheelOrderTest, "Flow.TimerWheel.FiringOrder", FLOW_TEST_FLAGS)
+
+bool FFlowTimerWheelOrderTest::RunTest(const FString& Parameters)
+{
+	FFlowTimerWheel TimerWheel;
+	TArray<int32> Log;
+
+	FFlowTimerHandle LateHandle;
+	FFlowTimerHandle EarlyHandle;
+	FFlowTimerHandle LateSecondHandle;
+	TimerWheel.SetTimer(LateHandle, FlowTimerWheelTests::MakeLogger(Log, 1), 0.5f, false);
+	TimerWheel.SetTimer(EarlyHandle, FlowTimerWheelTests::MakeLogger(Log, 0), 0.2f, false);
+	TimerWheel.SetTimer(LateSecondHandle, FlowTimerWheelTests::MakeLogger(Log, 2), 0.5f, false);
+
+	TestEqual(TEXT("Active timers"), TimerWheel.Num(), 3);
+
+	// single Advance spanning all timers, they're fired by expiration time, then in order of creation
+	TimerWheel.Advance(1.0);
+	TestEqual(TEXT("Fired timers"), Log, TArray<int32>({0, 1, 2}));
+	TestEqual(TEXT("Active timers after firing"), TimerWheel.Num(), 0);
+	TestFalse(TEXT("Fired timer is active"), TimerWheel.IsTimerActive(LateHandle));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowTimerWheelPrecisionTest, "Flow.TimerWheel.Precision", FLOW_TEST_FLAGS)
+
+bool FFlowTimerWheelPrecisionTest::RunTest(const FString& Parameters)
+{
+	FFlowTimerWheel TimerWheel;
+	TArray<int32> Log;
+
+	FFlowTimerHandle Handle;
+	TimerWheel.SetTimer(Handle, FlowTimerWheelTests::MakeLogger(Log, 0), 1.0f, false);
+
+	// steps are exactly representable, so the timer expires on the last step
+	constexpr double Step = 1.0 / 64.0;
+	for (int32 StepIndex = 0; StepIndex < 63; StepIndex++)
+	{
+		TimerWheel.Advance(Step);
+	}
+
+	TestEqual(TEXT("Fired timers before expiration"), Log.Num(), 0);
+	TestEqual(TEXT("Remaining time"), TimerWheel.GetTimerRemaining(Handle), static_cast<float>(Step));
+
+	TimerWheel.Advance(Step);
+	TestEqual(TEXT("Fired timers on expiration"), Log.Num(), 1);
+	TestEqual(TEXT("Remaining time of fired timer"), TimerWheel.GetTimerRemaining(Handle), -1.0f);
+
+	FFlowTimerHandle NextTickHandle;
+	TimerWheel.SetTimerForNextTick(NextTickHandle, FlowTimerWheelTests::MakeLogger(Log, 1));
+	TimerWheel.Advance(0.0);
+	TestEqual(TEXT("Fired timers after next tick"), Log, TArray<int32>({0, 1}));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowTimerWheelLoopTest, "Flow.TimerWheel.Looping", FLOW_TEST_FLAGS)
+
+bool FFlowTimerWheelLoopTest::RunTest(const FString& Parameters)
+{
+	FFlowTimerWheel TimerWheel;
+	int32 CallsNum = 0;
+
+	FFlowTimerHandle Handle;
+	TimerWheel.SetTimer(Handle, FFlowTimerDelegate::CreateLambda([&CallsNum]()
+	{
+		CallsNum++;
+	}), 0.25f, true);
+
+	// fired once for every interval passed
+	TimerWheel.Advance(0.75);
+	TestEqual(TEXT("Calls after 0.75 s"), CallsNum, 3);
+
+	TimerWheel.Advance(0.25);
+	TestEqual(TEXT("Calls after 1.0 s"), CallsNum, 4);
+	TestTrue(TEXT("Looping timer is active"), TimerWheel.IsTimerActive(Handle));
+
+	TimerWheel.ClearTimer(Handle);
+	TestFalse(TEXT("Cleared handle is valid"), Handle.IsValid());
+
+	TimerWheel.Advance(1.0);
+	TestEqual(TEXT("Calls after clearing"), CallsNum, 4);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowTimerWheelClearTest, "Flow.TimerWheel.ClearWhileFiring", FLOW_TEST_FLAGS)
+
+bool FFlowTimerWheelClearTest::RunTest(const FString& Parameters)
+{
+	FFlowTimerWheel TimerWheel;
+	TArray<int32> Log;
+
+	FFlowTimerHandle FirstHandle;
+	FFlowTimerHandle SecondHandle;
+	FFlowTimerHandle ReplacingHandle;
+
+	// first timer clears the second one, expiring within the same Advance call, and sets a new timer
+	TimerWheel.SetTimer(FirstHandle, FFlowTimerDelegate::CreateLambda([&]()
+	{
+		Log.Add(0);
+		TimerWheel.ClearTimer(SecondHandle);
+		TimerWheel.SetTimer(ReplacingHandle, FlowTimerWheelTests::MakeLogger(Log, 2), 0.1f, false);
+	}), 0.1f, false);
+	TimerWheel.SetTimer(SecondHandle, FlowTimerWheelTests::MakeLogger(Log, 1), 0.2f, false);
+
+	TimerWheel.Advance(0.5);
+	TestEqual(TEXT("Fired timers"), Log, TArray<int32>({0}));
+
+	// timers set by fired delegates wait for the next Advance call
+	TimerWheel.Advance(0.25);
+	TestEqual(TEXT("Fired timers after next Advance"), Log, TArray<int32>({0, 2}));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFlowTimerWheelLongDelayTest, "Flow.TimerWheel.LongDelay", FLOW_TEST_FLAGS)
+
+bool FFlowTimerWheelLongDelayTest::RunTest(const FString& Parameters)
+{
+	FFlowTimerWheel TimerWheel;
+	TArray<int32> Log;
+
+	// beyond the range of the top level, timer waits in the overflow list
+	constexpr float Delay = 400000.0f;
+	FFlowTimerHandle LongHandle;
+	TimerWheel.SetTimer(LongHandle, FlowTimerWheelTests::MakeLogger(Log, 0), Delay, false);
+
+	// hitches longer than the lowest levels rebuild the wheel instead of stepping through every tick
+	for (int32 StepIndex = 0; StepIndex < 399; StepIndex++)
+	{
+		TimerWheel.Advance(1000.0);
+	}
+
+	TestEqual(TEXT("Fired timers before expiration"), Log.Num(), 0);
+	TestTrue(TEXT("Long timer is active"), TimerWheel.IsTimerActive(LongHandle));
+
+	FFlowTimerHandle ShortHandle;
+	TimerWheel.SetTimer(ShortHandle, FlowTimerWheelTests::MakeLogger(Log, 1), 0.5f, false);
+
+	TimerWheel.Advance(1000.0);
+	TestEqual(TEXT("Fired timers after expiration"), Log, TArray<int32>({1, 0}));
+
+	return true;
+}
+
+#endif